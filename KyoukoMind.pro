@@ -4,6 +4,21 @@ TARGET = KyoukoMind
 CONFIG += console
 CONFIG += c++17
 
+# vectorized neuron-processing, enabled with "CONFIG += avx2" or "CONFIG += avx512"
+# (all cpus with avx2 also support f16c, which is used for the compact synapses)
+avx2 {
+    QMAKE_CXXFLAGS += -mavx2 -mf16c
+}
+avx512 {
+    QMAKE_CXXFLAGS += -mavx512f -mf16c
+}
+
+# compare the threaded with the sequential run of the workers in each cycle, enabled with
+# "CONFIG += verify_parallel" (only for the development, because it is slow)
+verify_parallel {
+    DEFINES += KYOUKO_VERIFY_PARALLEL
+}
+
 LIBS += -L../libShioriArchive/src -lShioriArchive
 LIBS += -L../libShioriArchive/src/debug -lShioriArchive
 LIBS += -L../libShioriArchive/src/release -lShioriArchive
@@ -117,11 +132,14 @@ HEADERS += \
     src/api/v1/cluster/load_cluster.h \
     src/api/v1/cluster/save_cluster.h \
     src/api/v1/cluster/set_cluster_mode.h \
+    src/api/v1/cluster/freeze_cluster.h \
+    src/api/v1/cluster/set_scheduling_weight.h \
     src/api/v1/cluster/show_cluster.h \
     src/api/v1/task/create_task.h \
     src/api/v1/task/delete_task.h \
     src/api/v1/task/list_task.h \
     src/api/v1/task/show_task.h \
+    src/api/v1/system/set_processing_threads.h \
     src/api/v1/template/delete_template.h \
     src/api/v1/template/list_templates.h \
     src/api/v1/template/show_template.h \
@@ -151,17 +169,37 @@ HEADERS += \
     src/core/cluster/states/task_handle_state.h \
     src/core/cluster/task.h \
     src/core/processing/cpu_processing_unit.h \
+    src/core/processing/mpmc_ring.h \
     src/core/processing/processing_unit_handler.h \
     src/core/processing/segment_queue.h \
+    src/core/processing/worker_deque.h \
+    src/core/processing/cluster_queue.h \
+    src/core/processing/worker_pool.h \
+    src/core/processing/numa_topology.h \
     src/core/routing_functions.h \
+    src/core/fast_math.h \
     src/core/segments/abstract_segment.h \
     src/core/segments/brick.h \
+    src/core/segments/huge_pages.h \
     src/core/segments/dynamic_segment/backpropagation.h \
     src/core/segments/dynamic_segment/dynamic_segment.h \
+    src/core/segments/dynamic_segment/neuron_kernels.h \
     src/core/segments/dynamic_segment/objects.h \
     src/core/segments/dynamic_segment/processing.h \
     src/core/segments/dynamic_segment/reduction.h \
+    src/core/segments/dynamic_segment/section_arena.h \
+    src/core/segments/dynamic_segment/section_geometry.h \
     src/core/segments/dynamic_segment/section_update.h \
+    src/core/segments/dynamic_segment/synapse_chain.h \
+    src/core/segments/dynamic_segment/synapse_access.h \
+    src/core/segments/dynamic_segment/neuron_worklist.h \
+    src/core/segments/dynamic_segment/delta_tracker.h \
+    src/core/segments/dynamic_segment/frozen_network.h \
+    src/core/segments/dynamic_segment/growth_requests.h \
+    src/core/segments/dynamic_segment/frozen_processing.h \
+    src/core/segments/dynamic_segment/neuron_batch.h \
+    src/core/segments/dynamic_segment/batch_processing.h \
+    src/core/segments/dynamic_segment/worker_input_buffer.h \
     src/core/segments/input_segment/input_segment.h \
     src/core/segments/input_segment/objects.h \
     src/core/segments/input_segment/processing.h \
@@ -183,11 +221,14 @@ SOURCES += \
     src/api/v1/cluster/load_cluster.cpp \
     src/api/v1/cluster/save_cluster.cpp \
     src/api/v1/cluster/set_cluster_mode.cpp \
+    src/api/v1/cluster/freeze_cluster.cpp \
+    src/api/v1/cluster/set_scheduling_weight.cpp \
     src/api/v1/cluster/show_cluster.cpp \
     src/api/v1/task/create_task.cpp \
     src/api/v1/task/delete_task.cpp \
     src/api/v1/task/list_task.cpp \
     src/api/v1/task/show_task.cpp \
+    src/api/v1/system/set_processing_threads.cpp \
     src/api/v1/template/delete_template.cpp \
     src/api/v1/template/list_templates.cpp \
     src/api/v1/template/show_template.cpp \
@@ -208,10 +249,15 @@ SOURCES += \
     src/core/processing/cpu_processing_unit.cpp \
     src/core/processing/processing_unit_handler.cpp \
     src/core/processing/segment_queue.cpp \
+    src/core/processing/worker_pool.cpp \
+    src/core/processing/numa_topology.cpp \
     src/core/segments/abstract_segment.cpp \
+    src/core/segments/huge_pages.cpp \
     src/core/segments/dynamic_segment/dynamic_segment.cpp \
+    src/core/segments/dynamic_segment/section_arena.cpp \
     src/core/segments/input_segment/input_segment.cpp \
     src/core/segments/output_segment/output_segment.cpp \
+    src/core/fast_math.cpp \
     src/core/struct_validation.cpp \
     src/database/cluster_table.cpp \
     src/database/template_table.cpp \
@@ -219,6 +265,24 @@ SOURCES += \
     src/kyouko_root.cpp \
     src/main.cpp
 
+# build the unit-tests instead of the service, enabled with "CONFIG += run_unit_tests"
+run_unit_tests {
+    TARGET = KyoukoMind_unit_tests
+    INCLUDEPATH += tests/unit_tests
+
+    HEADERS += \
+        tests/unit_tests/core/fast_math_test.h \
+        tests/unit_tests/core/processing/segment_queue_test.h \
+        tests/unit_tests/core/segments/dynamic_segment/compact_synapse_test.h
+
+    SOURCES -= src/main.cpp
+    SOURCES += \
+        tests/unit_tests/core/fast_math_test.cpp \
+        tests/unit_tests/core/processing/segment_queue_test.cpp \
+        tests/unit_tests/core/segments/dynamic_segment/compact_synapse_test.cpp \
+        tests/unit_tests/main.cpp
+}
+
 KYOUKO_PROTO_BUFFER = ../libKitsunemimiHanamiMessages/protobuffers/kyouko_messages.proto3
 GPU_KERNEL = src/core/segments/dynamic_segment/gpu_kernel.cl
 
@@ -142,5 +142,16 @@ cd $LIB_KITSUNE_SAKURA_TREE_DIR
 # copy build-result and include-files into the result-directory
 cp "$LIB_KITSUNE_SAKURA_TREE_DIR/KyoukoMind" "$RESULT_DIR/"
 
+# build and run the unit-tests, if requested with "./build.sh test"
+if [ "$1" == "test" ]; then
+    UNIT_TEST_DIR="$BUILD_DIR/KyoukoMind_unit_tests"
+    mkdir -p $UNIT_TEST_DIR
+    cd $UNIT_TEST_DIR
+
+    /usr/lib/x86_64-linux-gnu/qt5/bin/qmake "$PARENT_DIR/KyoukoMind/KyoukoMind.pro" -spec linux-g++ "CONFIG += optimize_full run_unit_tests"
+    /usr/bin/make -j8
+    ./KyoukoMind_unit_tests || exit 1
+fi
+
 #-----------------------------------------------------------------------------------------------------------------
 
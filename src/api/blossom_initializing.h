@@ -39,6 +39,8 @@
 #include <api/v1/cluster/save_cluster.h>
 #include <api/v1/cluster/load_cluster.h>
 #include <api/v1/cluster/set_cluster_mode.h>
+#include <api/v1/cluster/freeze_cluster.h>
+#include <api/v1/cluster/set_scheduling_weight.h>
 
 #include <api/v1/template/upload_template.h>
 #include <api/v1/template/delete_template.h>
@@ -50,6 +52,8 @@
 #include <api/v1/task/list_task.h>
 #include <api/v1/task/delete_task.h>
 
+#include <api/v1/system/set_processing_threads.h>
+
 using Kitsunemimi::Hanami::HanamiMessaging;
 
 /**
@@ -109,6 +113,20 @@ initClusterBlossoms()
                            Kitsunemimi::Hanami::BLOSSOM_TYPE,
                            group,
                            "set_mode");
+
+    assert(interface->addBlossom(group, "freeze", new FreezeCluster()));
+    interface->addEndpoint("v1/cluster/freeze",
+                           Kitsunemimi::Hanami::PUT_TYPE,
+                           Kitsunemimi::Hanami::BLOSSOM_TYPE,
+                           group,
+                           "freeze");
+
+    assert(interface->addBlossom(group, "set_scheduling_weight", new SetSchedulingWeight()));
+    interface->addEndpoint("v1/cluster/scheduling_weight",
+                           Kitsunemimi::Hanami::PUT_TYPE,
+                           Kitsunemimi::Hanami::BLOSSOM_TYPE,
+                           group,
+                           "set_scheduling_weight");
 }
 
 /**
@@ -187,6 +205,23 @@ initTaskBlossoms()
                            "delete");
 }
 
+/**
+ * @brief initSystemBlossoms
+ */
+void
+initSystemBlossoms()
+{
+    HanamiMessaging* interface = HanamiMessaging::getInstance();
+    const std::string group = "system";
+
+    assert(interface->addBlossom(group, "set_processing_threads", new SetProcessingThreads()));
+    interface->addEndpoint("v1/system/processing_threads",
+                           Kitsunemimi::Hanami::PUT_TYPE,
+                           Kitsunemimi::Hanami::BLOSSOM_TYPE,
+                           group,
+                           "set_processing_threads");
+}
+
 /**
  * @brief initBlossoms
  */
@@ -196,6 +231,7 @@ initBlossoms()
     initClusterBlossoms();
     initTemplateBlossoms();
     initTaskBlossoms();
+    initSystemBlossoms();
 }
 
 #endif // KYOUKOMIND_BLOSSOM_INITIALIZING_H
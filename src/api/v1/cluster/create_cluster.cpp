@@ -24,6 +24,8 @@
 
 #include <core/cluster/cluster_handler.h>
 #include <core/cluster/cluster.h>
+#include <core/fast_math.h>
+#include <core/segments/abstract_segment.h>
 
 #include <libKitsunemimiHanamiCommon/uuid.h>
 #include <libKitsunemimiHanamiCommon/enums.h>
@@ -56,6 +58,34 @@ CreateCluster::CreateCluster()
                        false,
                        "Cluster-template as base64-string.");
 
+    registerInputField("synapse_format",
+                       SAKURA_STRING_TYPE,
+                       false,
+                       "Format of the synapses of the cluster: 'default' with 16 byte per synapse "
+                       "or 'compact' with 8 byte per synapse and half-precision weights.");
+    assert(addFieldRegex("synapse_format", "^(default|compact)$"));
+
+    registerInputField("section_geometry",
+                       SAKURA_STRING_TYPE,
+                       false,
+                       "Number of synapses per synapse-section: 'small', 'default' or 'large' "
+                       "with 256, 512 or 1024 byte per section.");
+    assert(addFieldRegex("section_geometry", "^(small|default|large)$"));
+
+    registerInputField("math",
+                       SAKURA_STRING_TYPE,
+                       false,
+                       "Functions for the activation of the neurons of the cluster: 'exact' with "
+                       "the libm-functions or 'fast' with vectorized approximations.");
+    assert(addFieldRegex("math", "^(exact|fast)$"));
+
+    registerInputField("scheduling_weight",
+                       SAKURA_INT_TYPE,
+                       false,
+                       "Weight of the cluster for the scheduling of its segments. The clusters get "
+                       "the processing-threads in relation to their weights.");
+    assert(addFieldBorder("scheduling_weight", 1, MAX_CLUSTER_WEIGHT));
+
     //----------------------------------------------------------------------------------------------
     // output
     //----------------------------------------------------------------------------------------------
@@ -92,6 +122,9 @@ CreateCluster::runTask(BlossomIO &blossomIO,
 {
     const std::string clusterName = blossomIO.input.get("name").getString();
     const std::string base64Template = blossomIO.input.get("template").getString();
+    const std::string synapseFormatStr = blossomIO.input.get("synapse_format").getString();
+    const std::string sectionGeometryStr = blossomIO.input.get("section_geometry").getString();
+    const bool fastMath = blossomIO.input.get("math").getString() == "fast";
     const Kitsunemimi::Hanami::UserContext userContext(context);
 
     // check if user already exist within the table
@@ -132,6 +165,18 @@ CreateCluster::runTask(BlossomIO &blossomIO,
         }
     }
 
+    SynapseFormat synapseFormat = DEFAULT_SYNAPSE_FORMAT;
+    if(synapseFormatStr == "compact") {
+        synapseFormat = COMPACT_SYNAPSE_FORMAT;
+    }
+
+    SectionGeometry sectionGeometry = DEFAULT_SECTION_GEOMETRY;
+    if(sectionGeometryStr == "small") {
+        sectionGeometry = SMALL_SECTION_GEOMETRY;
+    } else if(sectionGeometryStr == "large") {
+        sectionGeometry = LARGE_SECTION_GEOMETRY;
+    }
+
     // convert values
     JsonItem clusterData;
     clusterData.insert("name", clusterName);
@@ -164,7 +209,15 @@ CreateCluster::runTask(BlossomIO &blossomIO,
     Cluster* newCluster = new Cluster();
     if(base64Template != "")
     {
-        if(initCluster(newCluster, uuid, parsedCluster, userContext, status, error) == false)
+        if(initCluster(newCluster,
+                       uuid,
+                       parsedCluster,
+                       synapseFormat,
+                       sectionGeometry,
+                       fastMath,
+                       userContext,
+                       status,
+                       error) == false)
         {
             delete newCluster;
             error.addMeesage("Failed to initialize cluster");
@@ -173,6 +226,14 @@ CreateCluster::runTask(BlossomIO &blossomIO,
         }
     }
 
+    if(blossomIO.input.contains("scheduling_weight"))
+    {
+        const uint32_t weight = blossomIO.input.get("scheduling_weight").getInt();
+        if(newCluster->setSchedulingWeight(weight) == false) {
+            LOG_WARNING("cluster '" + uuid + "' has no own sub-queue and uses the default weight");
+        }
+    }
+
     KyoukoRoot::m_clusterHandler->addCluster(uuid, newCluster);
 
     // remove irrelevant fields
@@ -189,6 +250,9 @@ CreateCluster::runTask(BlossomIO &blossomIO,
  * @param cluster pointer to the cluster, which should be initialized
  * @param clusterUuid uuid of the cluster
  * @param clusterDefinition definition, which describe the new cluster
+ * @param synapseFormat format of the synapses of the dynamic segments
+ * @param sectionGeometry geometry of the synapse-sections of the dynamic segments
+ * @param fastMath true to use the approximations of the activation-functions in all segments
  * @param userContext context-object with date for the access to the database-tables
  * @param status reference for status-output
  * @param error reference for error-output
@@ -199,10 +263,25 @@ bool
 CreateCluster::initCluster(Cluster* cluster,
                            const std::string &clusterUuid,
                            Kitsunemimi::Hanami::ClusterMeta &clusterDefinition,
+                           const SynapseFormat synapseFormat,
+                           const SectionGeometry sectionGeometry,
+                           const bool fastMath,
                            const Kitsunemimi::Hanami::UserContext &userContext,
                            Kitsunemimi::Hanami::BlossomStatus &status,
                            Kitsunemimi::ErrorContainer &error)
 {
+    // the approximations are only checked at a few points, so this is cheap enough for each
+    // new cluster
+    if(fastMath
+            && checkFastMath() == false)
+    {
+        status.errorMessage = "Fast-math is not available on this host, because its "
+                              "approximations are not accurate enough.";
+        status.statusCode = Kitsunemimi::Hanami::BAD_REQUEST_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
     // collect all segment-templates, which are required by the cluster-template
     std::map<std::string, Kitsunemimi::Hanami::SegmentMeta> segmentTemplates;
     for(const Kitsunemimi::Hanami::SegmentMetaPtr& segmentCon : clusterDefinition.segments)
@@ -239,13 +318,25 @@ CreateCluster::initCluster(Cluster* cluster,
     }
 
     // generate and initialize the cluster based on the cluster- and segment-templates
-    if(cluster->init(clusterDefinition, segmentTemplates, clusterUuid) == false)
+    if(cluster->init(clusterDefinition,
+                     segmentTemplates,
+                     clusterUuid,
+                     synapseFormat,
+                     sectionGeometry) == false)
     {
         error.addMeesage("Failed to initialize cluster based on a template");
         status.statusCode = Kitsunemimi::Hanami::INTERNAL_SERVER_ERROR_RTYPE;
         return false;
     }
 
+    // the selection is stored in the settings of each segment and so also part of snapshots
+    if(fastMath)
+    {
+        for(AbstractSegment* segment : cluster->allSegments) {
+            segment->dynamicSegmentSettings->fastMath = 1;
+        }
+    }
+
     return true;
 }
 
@@ -23,6 +23,7 @@
 #ifndef KYOUKOMIND_CREATECLUSTER_H
 #define KYOUKOMIND_CREATECLUSTER_H
 
+#include <common.h>
 #include <libKitsunemimiHanamiNetwork/blossom.h>
 #include <libKitsunemimiHanamiCommon/structs.h>
 #include <libKitsunemimiHanamiClusterParser/cluster_meta.h>
@@ -50,6 +51,9 @@ private:
     bool initCluster(Cluster* cluster,
                      const std::string &clusterUuid,
                      Kitsunemimi::Hanami::ClusterMeta &clusterDefinition,
+                     const SynapseFormat synapseFormat,
+                     const SectionGeometry sectionGeometry,
+                     const bool fastMath,
                      const Kitsunemimi::Hanami::UserContext &userContext,
                      Kitsunemimi::Hanami::BlossomStatus &status,
                      Kitsunemimi::ErrorContainer &error);
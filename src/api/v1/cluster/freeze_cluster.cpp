@@ -0,0 +1,124 @@
+/**
+ * @file        freeze_cluster.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "freeze_cluster.h"
+
+#include <kyouko_root.h>
+#include <core/cluster/cluster_handler.h>
+#include <core/cluster/cluster.h>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+using namespace Kitsunemimi::Hanami;
+
+FreezeCluster::FreezeCluster()
+    : Blossom("Freeze a trained cluster for requests or unfreeze it again for learning.")
+{
+    //----------------------------------------------------------------------------------------------
+    // input
+    //----------------------------------------------------------------------------------------------
+
+    registerInputField("uuid",
+                       SAKURA_STRING_TYPE,
+                       true,
+                       "UUID of the cluster.");
+    assert(addFieldRegex("uuid", UUID_REGEX));
+    registerInputField("frozen",
+                       SAKURA_BOOL_TYPE,
+                       true,
+                       "True to freeze the cluster, false to unfreeze it.");
+
+    //----------------------------------------------------------------------------------------------
+    // output
+    //----------------------------------------------------------------------------------------------
+
+    registerOutputField("uuid",
+                        SAKURA_STRING_TYPE,
+                        "UUID of the cluster.");
+    registerOutputField("name",
+                        SAKURA_STRING_TYPE,
+                        "Name of the cluster.");
+    registerOutputField("frozen",
+                        SAKURA_BOOL_TYPE,
+                        "True, if the cluster is frozen.");
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief runTask
+ */
+bool
+FreezeCluster::runTask(BlossomIO &blossomIO,
+                       const Kitsunemimi::DataMap &context,
+                       BlossomStatus &status,
+                       Kitsunemimi::ErrorContainer &error)
+{
+    const std::string clusterUuid = blossomIO.input.get("uuid").getString();
+    const bool frozen = blossomIO.input.get("frozen").getBool();
+    const Kitsunemimi::Hanami::UserContext userContext(context);
+
+    // get data from table
+    if(KyoukoRoot::clustersTable->getCluster(blossomIO.output,
+                                             clusterUuid,
+                                             userContext,
+                                             error) == false)
+    {
+        status.errorMessage = "Cluster with UUID '" + clusterUuid + "' not found.";
+        status.statusCode = Kitsunemimi::Hanami::NOT_FOUND_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    // get cluster
+    Cluster* cluster = KyoukoRoot::m_clusterHandler->getCluster(clusterUuid);
+    if(cluster == nullptr)
+    {
+        status.errorMessage = "Cluster with UUID '" + clusterUuid + "'not found";
+        status.statusCode = Kitsunemimi::Hanami::NOT_FOUND_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    // compile or remove the frozen synapses
+    if(cluster->setFrozen(frozen) == false)
+    {
+        status.errorMessage = "Cluster with UUID '"
+                              + clusterUuid
+                              + "' is actually processing a task or a batch and can not be "
+                                "frozen or unfrozen";
+        status.statusCode = Kitsunemimi::Hanami::CONFLICT_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    blossomIO.output.insert("frozen", frozen);
+
+    // remove irrelevant fields
+    blossomIO.output.remove("owner_id");
+    blossomIO.output.remove("project_id");
+    blossomIO.output.remove("visibility");
+
+    return true;
+}
@@ -0,0 +1,126 @@
+/**
+ * @file        set_scheduling_weight.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "set_scheduling_weight.h"
+
+#include <kyouko_root.h>
+#include <core/cluster/cluster_handler.h>
+#include <core/cluster/cluster.h>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+using namespace Kitsunemimi::Hanami;
+
+SetSchedulingWeight::SetSchedulingWeight()
+    : Blossom("Set the weight of a cluster for the scheduling of its segments.")
+{
+    //----------------------------------------------------------------------------------------------
+    // input
+    //----------------------------------------------------------------------------------------------
+
+    registerInputField("uuid",
+                       SAKURA_STRING_TYPE,
+                       true,
+                       "UUID of the cluster.");
+    assert(addFieldRegex("uuid", UUID_REGEX));
+    registerInputField("scheduling_weight",
+                       SAKURA_INT_TYPE,
+                       true,
+                       "New weight of the cluster. The clusters get the processing-threads in "
+                       "relation to their weights.");
+    assert(addFieldBorder("scheduling_weight", 1, MAX_CLUSTER_WEIGHT));
+
+    //----------------------------------------------------------------------------------------------
+    // output
+    //----------------------------------------------------------------------------------------------
+
+    registerOutputField("uuid",
+                        SAKURA_STRING_TYPE,
+                        "UUID of the cluster.");
+    registerOutputField("name",
+                        SAKURA_STRING_TYPE,
+                        "Name of the cluster.");
+    registerOutputField("scheduling_weight",
+                        SAKURA_INT_TYPE,
+                        "Weight of the cluster for the scheduling of its segments.");
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief runTask
+ */
+bool
+SetSchedulingWeight::runTask(BlossomIO &blossomIO,
+                             const Kitsunemimi::DataMap &context,
+                             BlossomStatus &status,
+                             Kitsunemimi::ErrorContainer &error)
+{
+    const std::string clusterUuid = blossomIO.input.get("uuid").getString();
+    const uint32_t weight = blossomIO.input.get("scheduling_weight").getInt();
+    const Kitsunemimi::Hanami::UserContext userContext(context);
+
+    // get data from table
+    if(KyoukoRoot::clustersTable->getCluster(blossomIO.output,
+                                             clusterUuid,
+                                             userContext,
+                                             error) == false)
+    {
+        status.errorMessage = "Cluster with UUID '" + clusterUuid + "' not found.";
+        status.statusCode = Kitsunemimi::Hanami::NOT_FOUND_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    // get cluster
+    Cluster* cluster = KyoukoRoot::m_clusterHandler->getCluster(clusterUuid);
+    if(cluster == nullptr)
+    {
+        status.errorMessage = "Cluster with UUID '" + clusterUuid + "'not found";
+        status.statusCode = Kitsunemimi::Hanami::NOT_FOUND_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    // clusters without own sub-queue share the weight of the shared sub-queue
+    if(cluster->setSchedulingWeight(weight) == false)
+    {
+        status.errorMessage = "Cluster with UUID '"
+                              + clusterUuid
+                              + "' has no own sub-queue in the segment-queue, so its weight can "
+                                "not be changed";
+        status.statusCode = Kitsunemimi::Hanami::CONFLICT_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    blossomIO.output.insert("scheduling_weight", static_cast<long>(weight));
+
+    // remove irrelevant fields
+    blossomIO.output.remove("owner_id");
+    blossomIO.output.remove("project_id");
+    blossomIO.output.remove("visibility");
+
+    return true;
+}
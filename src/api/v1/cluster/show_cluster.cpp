@@ -23,6 +23,10 @@
 #include "show_cluster.h"
 
 #include <kyouko_root.h>
+#include <core/cluster/cluster.h>
+#include <core/cluster/cluster_handler.h>
+#include <core/segments/huge_pages.h>
+#include <core/segments/dynamic_segment/dynamic_segment.h>
 
 #include <libKitsunemimiJson/json_item.h>
 
@@ -62,6 +66,25 @@ ShowCluster::ShowCluster()
     registerOutputField("visibility",
                         SAKURA_STRING_TYPE,
                         "Visibility of the cluster (private, shared, public).");
+    registerOutputField("synapse_huge_pages",
+                        SAKURA_STRING_TYPE,
+                        "Huge pages in effect for the synapses of the cluster "
+                        "(none, transparent, hugetlb_2mb, hugetlb_1gb).");
+    registerOutputField("segment_data_huge_pages",
+                        SAKURA_STRING_TYPE,
+                        "Huge pages in effect for the other data of the segments of the cluster "
+                        "(none, transparent).");
+    registerOutputField("scheduling_weight",
+                        SAKURA_INT_TYPE,
+                        "Weight of the cluster for the scheduling of its segments.");
+    registerOutputField("average_queue_wait_time",
+                        SAKURA_INT_TYPE,
+                        "Average time in microseconds, which the segments of the cluster had to "
+                        "wait for a processing-thread.");
+    registerOutputField("max_queue_wait_time",
+                        SAKURA_INT_TYPE,
+                        "Maximum time in microseconds, which a segment of the cluster had to "
+                        "wait for a processing-thread.");
 
     //----------------------------------------------------------------------------------------------
     //
@@ -92,5 +115,60 @@ ShowCluster::runTask(BlossomIO &blossomIO,
         return false;
     }
 
+    // report the weakest huge-page-type over all segments of the cluster, which is actually in
+    // effect and not only requested
+    HugePageType synapseHugePages = HUGETLB_1GB_PAGES;
+    HugePageType segmentDataHugePages = HUGETLB_1GB_PAGES;
+    std::vector<HugePageRegion> regions;
+    Cluster* cluster = KyoukoRoot::m_clusterHandler->getCluster(clusterUuid);
+    if(cluster == nullptr
+            || cluster->allSegments.size() == 0
+            || readHugePageRegions(regions) == false)
+    {
+        synapseHugePages = NO_HUGE_PAGES;
+        segmentDataHugePages = NO_HUGE_PAGES;
+    }
+    else
+    {
+        for(AbstractSegment* segment : cluster->allSegments)
+        {
+            const HugePageType dataType =
+                    getEffectiveHugePageType(regions,
+                                             segment->segmentData.buffer.data,
+                                             segment->segmentData.buffer.totalBufferSize,
+                                             segment->segmentDataHugePages);
+            segmentDataHugePages = std::min(segmentDataHugePages, dataType);
+            if(segment->getType() == DYNAMIC_SEGMENT)
+            {
+                const DynamicSegment* seg = static_cast<DynamicSegment*>(segment);
+                const HugePageType synapseType =
+                        getEffectiveHugePageType(regions,
+                                                 seg->synapseArena.sections,
+                                                 seg->synapseArena.getReservedSize(),
+                                                 seg->synapseArena.hugePageType);
+                synapseHugePages = std::min(synapseHugePages, synapseType);
+            }
+        }
+        if(cluster->coreSegments.size() == 0) {
+            synapseHugePages = NO_HUGE_PAGES;
+        }
+    }
+
+    blossomIO.output.insert("synapse_huge_pages", hugePageTypeToString(synapseHugePages));
+    blossomIO.output.insert("segment_data_huge_pages", hugePageTypeToString(segmentDataHugePages));
+
+    // scheduling of the segments of the cluster
+    uint32_t schedulingWeight = 0;
+    uint64_t averageWaitTime = 0;
+    uint64_t maxWaitTime = 0;
+    if(cluster != nullptr)
+    {
+        schedulingWeight = cluster->getSchedulingWeight();
+        cluster->getQueueWaitTime(averageWaitTime, maxWaitTime);
+    }
+    blossomIO.output.insert("scheduling_weight", static_cast<long>(schedulingWeight));
+    blossomIO.output.insert("average_queue_wait_time", static_cast<long>(averageWaitTime));
+    blossomIO.output.insert("max_queue_wait_time", static_cast<long>(maxWaitTime));
+
     return true;
 }
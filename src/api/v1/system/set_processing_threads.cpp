@@ -0,0 +1,93 @@
+/**
+ * @file        set_processing_threads.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "set_processing_threads.h"
+
+#include <kyouko_root.h>
+#include <core/processing/processing_unit_handler.h>
+
+#include <libKitsunemimiHanamiCommon/enums.h>
+
+using namespace Kitsunemimi::Hanami;
+
+SetProcessingThreads::SetProcessingThreads()
+    : Blossom("Change the number of threads, which process the segments of all clusters.")
+{
+    //----------------------------------------------------------------------------------------------
+    // input
+    //----------------------------------------------------------------------------------------------
+
+    registerInputField("number_of_threads",
+                       SAKURA_INT_TYPE,
+                       true,
+                       "New number of processing-threads.");
+    assert(addFieldBorder("number_of_threads", 1, 1024));
+
+    //----------------------------------------------------------------------------------------------
+    // output
+    //----------------------------------------------------------------------------------------------
+
+    registerOutputField("number_of_threads",
+                        SAKURA_INT_TYPE,
+                        "Number of processing-threads after the change.");
+
+    //----------------------------------------------------------------------------------------------
+    //
+    //----------------------------------------------------------------------------------------------
+}
+
+/**
+ * @brief runTask
+ */
+bool
+SetProcessingThreads::runTask(BlossomIO &blossomIO,
+                              const Kitsunemimi::DataMap &context,
+                              BlossomStatus &status,
+                              Kitsunemimi::ErrorContainer &error)
+{
+    const long numberOfThreads = blossomIO.input.get("number_of_threads").getLong();
+    const Kitsunemimi::Hanami::UserContext userContext(context);
+
+    // the threads are shared by all users, so only an admin is allowed to change them
+    if(userContext.isAdmin == false)
+    {
+        status.errorMessage = "Only an admin is allowed to change the processing-threads.";
+        status.statusCode = Kitsunemimi::Hanami::UNAUTHORIZED_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    ProcessingUnitHandler* handler = KyoukoRoot::m_processingUnitHandler;
+    if(handler->resizeProcessingUnits(static_cast<uint32_t>(numberOfThreads)) == false)
+    {
+        status.errorMessage = "Failed to change the number of processing-threads to "
+                              + std::to_string(numberOfThreads);
+        status.statusCode = Kitsunemimi::Hanami::BAD_REQUEST_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
+    const long newNumberOfThreads = handler->getNumberOfProcessingUnits();
+    blossomIO.output.insert("number_of_threads", newNumberOfThreads);
+
+    return true;
+}
@@ -71,6 +71,13 @@ CreateTask::CreateTask()
                        "UUID of the data-set with the input, which coming from shiori.");
     assert(addFieldRegex("data_set_uuid", UUID_REGEX));
 
+    registerInputField("batch_size",
+                       SAKURA_INT_TYPE,
+                       false,
+                       "Number of samples of a learn-task, whose weight-changes are applied "
+                       "together (default: 1).");
+    assert(addFieldBorder("batch_size", 1, 1024));
+
     //----------------------------------------------------------------------------------------------
     // output
     //----------------------------------------------------------------------------------------------
@@ -100,6 +107,10 @@ CreateTask::runTask(BlossomIO &blossomIO,
     const std::string clusterUuid = blossomIO.input.get("cluster_uuid").getString();
     const std::string dataSetUuid = blossomIO.input.get("data_set_uuid").getString();
     const std::string taskType = blossomIO.input.get("type").getString();
+    uint32_t learnBatchSize = 1;
+    if(blossomIO.input.contains("batch_size")) {
+        learnBatchSize = blossomIO.input.get("batch_size").getInt();
+    }
     const Kitsunemimi::Hanami::UserContext userContext(context);
 
     // check if shiori is available
@@ -122,6 +133,16 @@ CreateTask::runTask(BlossomIO &blossomIO,
         return false;
     }
 
+    // a frozen cluster has only a read-only copy of its synapses and can not learn
+    if(taskType == "learn"
+            && cluster->isFrozen)
+    {
+        status.errorMessage = "Cluster with UUID '" + clusterUuid + "' is frozen and can not learn";
+        status.statusCode = Kitsunemimi::Hanami::BAD_REQUEST_RTYPE;
+        error.addMeesage(status.errorMessage);
+        return false;
+    }
+
     // get meta-infos of data-set from shiori
     JsonItem dataSetInfo;
     if(Shiori::getDataSetInformation(dataSetInfo, dataSetUuid, userContext.token, error) == false)
@@ -143,6 +164,7 @@ CreateTask::runTask(BlossomIO &blossomIO,
                   userContext,
                   cluster,
                   dataSetInfo,
+                  learnBatchSize,
                   status,
                   error);
     }
@@ -155,6 +177,7 @@ CreateTask::runTask(BlossomIO &blossomIO,
                   userContext,
                   cluster,
                   dataSetInfo,
+                  learnBatchSize,
                   status,
                   error);
     }
@@ -185,6 +208,7 @@ CreateTask::runTask(BlossomIO &blossomIO,
  * @param userContext user-context
  * @param cluster pointer to the cluster, which should process the new task
  * @param dataSetInfo info-object with information about the dataset
+ * @param learnBatchSize number of samples, whose weight-changes are applied together
  * @param status reference for status-output in error-case
  * @param error reference for error-output
  *
@@ -198,6 +222,7 @@ CreateTask::imageTask(std::string &taskUuid,
                       const Kitsunemimi::Hanami::UserContext &userContext,
                       Cluster* cluster,
                       JsonItem &dataSetInfo,
+                      const uint32_t learnBatchSize,
                       BlossomStatus &status,
                       Kitsunemimi::ErrorContainer &error)
 {
@@ -226,7 +251,8 @@ CreateTask::imageTask(std::string &taskUuid,
                                               floatData,
                                               numberOfInputs,
                                               numberOfOutputs,
-                                              numberOfLines);
+                                              numberOfLines,
+                                              learnBatchSize);
     }
     else
     {
@@ -252,6 +278,7 @@ CreateTask::imageTask(std::string &taskUuid,
  * @param userContext user-context
  * @param cluster pointer to the cluster, which should process the new task
  * @param dataSetInfo info-object with information about the dataset
+ * @param learnBatchSize number of samples, whose weight-changes are applied together
  * @param status reference for status-output in error-case
  * @param error reference for error-output
  *
@@ -265,6 +292,7 @@ CreateTask::tableTask(std::string &taskUuid,
                       const Kitsunemimi::Hanami::UserContext &userContext,
                       Cluster* cluster,
                       JsonItem &dataSetInfo,
+                      const uint32_t learnBatchSize,
                       BlossomStatus &status,
                       Kitsunemimi::ErrorContainer &error)
 {
@@ -334,7 +362,8 @@ CreateTask::tableTask(std::string &taskUuid,
                                               static_cast<float*>(outputBuffer->data),
                                               numberOfInputs,
                                               numberOfOutputs,
-                                              numberOfLines - numberOfInputs);
+                                              numberOfLines - numberOfInputs,
+                                              learnBatchSize);
 
         // clear leftover of the buffer
         outputBuffer->data = nullptr;
@@ -48,6 +48,7 @@ private:
                    const Kitsunemimi::Hanami::UserContext &userContext,
                    Cluster* cluster,
                    JsonItem &dataSetInfo,
+                   const uint32_t learnBatchSize,
                    Kitsunemimi::Hanami::BlossomStatus &status,
                    Kitsunemimi::ErrorContainer &error);
 
@@ -58,6 +59,7 @@ private:
                    const Kitsunemimi::Hanami::UserContext &userContext,
                    Cluster* cluster,
                    JsonItem &dataSetInfo,
+                   const uint32_t learnBatchSize,
                    Kitsunemimi::Hanami::BlossomStatus &status,
                    Kitsunemimi::ErrorContainer &error);
 };
@@ -27,9 +27,33 @@
 
 // network-predefines
 #define SYNAPSES_PER_SYNAPSESECTION 31
+#define COMPACT_SYNAPSES_PER_SYNAPSESECTION 62
+#define SMALL_SYNAPSES_PER_SYNAPSESECTION 15
+#define SMALL_COMPACT_SYNAPSES_PER_SYNAPSESECTION 30
+#define LARGE_SYNAPSES_PER_SYNAPSESECTION 63
+#define LARGE_COMPACT_SYNAPSES_PER_SYNAPSESECTION 126
 #define NEURONS_PER_NEURONSECTION 62
+#define NEURON_LANES_PER_NEURONSECTION 64
 #define POSSIBLE_NEXT_AXON_STEP 80
+#define SYNAPSE_SECTIONS_PER_BLOCK 4096
+// marker and version at the end of the synapse-sections of a snapshot, "KYSYNS" + version 1
+#define SYNAPSE_SNAPSHOT_MAGIC 0x4b5953594e530001
+// version of the layout of the segment-data, which has to be increased with each change of the
+// structs within the segments, because snapshots contain them as raw memory
+#define SEGMENT_LAYOUT_VERSION 2
+#define SYNAPSE_SNAPSHOT_TRAILER_SIZE 24
+// meta-data of the item-buffer of a segment, which is part of the snapshot of its static data
+#define ITEM_BUFFER_META_DATA_SIZE 48
 
 // processing
-#define NUMBER_OF_PROCESSING_UNITS 1
-#define NUMBER_OF_RAND_VALUES 10485760
+#define SEGMENT_QUEUE_SIZE 16384
+#define MAX_NUMBER_OF_PROCESSING_UNITS 1024
+#define SEGMENT_QUEUE_WAIT_TIMEOUT 100
+#define MAX_NUMBER_OF_CLUSTER_QUEUES 1024
+#define DEFAULT_CLUSTER_WEIGHT 100
+#define MAX_CLUSTER_WEIGHT 10000
+#define SCHEDULING_GRANULARITY 1000000
+#define MIN_NEURON_SECTIONS_PER_WORKER 4
+#define MAX_BATCH_SIZE 64
+#define NEURON_SECTIONS_PER_REDUCTION 8
+#define CYCLES_PER_REDUCTION 16
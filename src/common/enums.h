@@ -29,4 +29,25 @@ enum ObjectTypes
     SEGMENT_OBJECT = 1,
 };
 
+enum SynapseFormat
+{
+    DEFAULT_SYNAPSE_FORMAT = 0,
+    COMPACT_SYNAPSE_FORMAT = 1,
+};
+
+enum SectionGeometry
+{
+    DEFAULT_SECTION_GEOMETRY = 0,
+    SMALL_SECTION_GEOMETRY = 1,
+    LARGE_SECTION_GEOMETRY = 2,
+};
+
+enum HugePageType
+{
+    NO_HUGE_PAGES = 0,
+    TRANSPARENT_HUGE_PAGES = 1,
+    HUGETLB_2MB_PAGES = 2,
+    HUGETLB_1GB_PAGES = 3,
+};
+
 #endif // KYOUKOMIND_ENUMS_H
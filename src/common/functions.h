@@ -23,5 +23,48 @@
 #ifndef KYOUKOMIND_FUNCTIONS_H
 #define KYOUKOMIND_FUNCTIONS_H
 
+#include <stdint.h>
+
+/**
+ * @brief Stateless counter-based random-generator, which uses the finalizer of SplitMix64. The
+ *        same input always gives the same output, so there is no shared state and the function
+ *        can be used by multiple threads at the same time without any lock. The same function
+ *        exists in the gpu-kernel.
+ *
+ * @param seed seed of the segment
+ * @param key key of the random-stream, for example the id of a section
+ * @param counter position within the random-stream
+ *
+ * @return 32-bit random-value
+ */
+inline uint32_t
+getRandomValue(const uint32_t seed,
+               const uint32_t key,
+               const uint32_t counter)
+{
+    uint64_t z = (static_cast<uint64_t>(key) << 32) | static_cast<uint64_t>(counter);
+    z += (static_cast<uint64_t>(seed) + 1) * 0x9E3779B97F4A7C15ULL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    z = z ^ (z >> 31);
+    return static_cast<uint32_t>(z >> 32);
+}
+
+/**
+ * @brief get counter-based random-value in range [0, 1)
+ *
+ * @param seed seed of the segment
+ * @param key key of the random-stream
+ * @param counter position within the random-stream
+ *
+ * @return random float-value
+ */
+inline float
+getRandomFloat(const uint32_t seed,
+               const uint32_t key,
+               const uint32_t counter)
+{
+    return static_cast<float>(getRandomValue(seed, key, counter) >> 8) / 16777216.0f;
+}
 
 #endif // KYOUKOMIND_FUNCTIONS_H
@@ -52,6 +52,7 @@
 #include <cmath>
 #include <utility>
 #include <atomic>
+#include <functional>
 #include <uuid/uuid.h>
 
 #include <libKitsunemimiCommon/buffer/data_buffer.h>
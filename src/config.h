@@ -23,6 +23,8 @@
 #ifndef KYOUKOMIND_CONFIG_H
 #define KYOUKOMIND_CONFIG_H
 
+#include <common.h>
+
 #include <libKitsunemimiConfig/config_handler.h>
 #include <libKitsunemimiHanamiCommon/config.h>
 
@@ -33,6 +35,29 @@ void
 registerConfigs(Kitsunemimi::ErrorContainer &error)
 {
     Kitsunemimi::Hanami::registerBasicConfigs(error);
+
+    // number of threads, which process the segments; 0 to use the cpus of the process, which
+    // are not used to split a single segment
+    REGISTER_INT_CONFIG("CPU", "number_of_processing_threads", error, 0);
+
+    // list of cpus like "0-3,8" to pin the processing-threads; empty to pin them to their node
+    REGISTER_STRING_CONFIG("CPU", "processing_thread_cpus", error, "");
+
+    // weight of new clusters for the scheduling of their segments; the clusters get the
+    // processing-threads in relation to their weights
+    REGISTER_INT_CONFIG("CPU", "default_cluster_weight", error, DEFAULT_CLUSTER_WEIGHT);
+
+    // number of threads to process a single segment; 0 to use half of the cpus of the
+    // numa-node, which are available for the process. The value is reduced, so that the
+    // processing-threads and the threads of a segment don't use more than the cpus of the node
+    REGISTER_INT_CONFIG("CPU", "number_of_threads_per_segment", error, 0);
+
+    // place segments on the numa-nodes of the host and pin the worker-threads to the nodes
+    REGISTER_BOOL_CONFIG("CPU", "numa_aware", error, true);
+
+    // huge pages for the segment-buffers: "none", "transparent" or "hugetlb", where hugetlb
+    // needs pre-allocated huge pages on the host and falls back to transparent huge pages
+    REGISTER_STRING_CONFIG("CPU", "huge_pages", error, "transparent");
 }
 
 #endif // KYOUKOMIND_CONFIG_H
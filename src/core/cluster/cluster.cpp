@@ -47,6 +47,10 @@ Cluster::Cluster()
     m_taskHandleState = new TaskHandle_State(this);
 
     initStatemachine(*m_stateMachine, this, m_taskHandleState);
+
+    if(KyoukoRoot::m_segmentQueue != nullptr) {
+        schedulingQueueId = KyoukoRoot::m_segmentQueue->registerCluster();
+    }
 }
 
 /**
@@ -59,6 +63,11 @@ Cluster::~Cluster()
     // already deleted in the destructor of the statemachine
     // delete m_taskHandleState;
 
+    // remove the queued segments, before they are deleted
+    if(KyoukoRoot::m_segmentQueue != nullptr) {
+        KyoukoRoot::m_segmentQueue->unregisterCluster(this);
+    }
+
     for(AbstractSegment* segment : allSegments) {
         delete segment;
     }
@@ -81,15 +90,24 @@ std::string Cluster::getUuid()
  * @param parsedContent TODO
  * @param segmentTemplates TODO
  * @param uuid UUID of the new cluster
+ * @param synapseFormat format of the synapses of the dynamic segments
+ * @param sectionGeometry geometry of the synapse-sections of the dynamic segments
  *
  * @return true, if successful, else false
  */
 bool
 Cluster::init(const Kitsunemimi::Hanami::ClusterMeta &clusterTemplate,
               const std::map<std::string, Kitsunemimi::Hanami::SegmentMeta> &segmentTemplates,
-              const std::string &uuid)
+              const std::string &uuid,
+              const SynapseFormat synapseFormat,
+              const SectionGeometry sectionGeometry)
 {
-    return initNewCluster(this, clusterTemplate, segmentTemplates, uuid);
+    return initNewCluster(this,
+                          clusterTemplate,
+                          segmentTemplates,
+                          uuid,
+                          synapseFormat,
+                          sectionGeometry);
 }
 
 /**
@@ -211,7 +229,9 @@ Cluster::setName(const std::string newName)
 void
 Cluster::startForwardCycle()
 {
-    // set ready-states of all neighbors of all segments
+    // set ready-states of all neighbors of all segments and queue only the segments, which
+    // don't wait for an input of another segment
+    std::vector<AbstractSegment*> readySegments;
     for(AbstractSegment* segment : allSegments)
     {
         for(uint8_t side = 0; side < 16; side++)
@@ -220,10 +240,14 @@ Cluster::startForwardCycle()
             // TODO: check possible crash here
             neighbor->inputReady = neighbor->direction != INPUT_DIRECTION;
         }
+
+        if(segment->initPendingInputs(INPUT_DIRECTION) == 0) {
+            readySegments.push_back(segment);
+        }
     }
 
     segmentCounter = 0;
-    KyoukoRoot::m_segmentQueue->addSegmentListToQueue(allSegments);
+    KyoukoRoot::m_segmentQueue->addSegmentListToQueue(readySegments);
 }
 
 /**
@@ -232,7 +256,9 @@ Cluster::startForwardCycle()
 void
 Cluster::startBackwardCycle()
 {
-    // set ready-states of all neighbors of all segments
+    // set ready-states of all neighbors of all segments and queue only the segments, which
+    // don't wait for an input of another segment
+    std::vector<AbstractSegment*> readySegments;
     for(AbstractSegment* segment : allSegments)
     {
         for(uint8_t side = 0; side < 16; side++)
@@ -240,10 +266,14 @@ Cluster::startBackwardCycle()
             SegmentSlot* neighbor = &segment->segmentSlots->slots[side];
             neighbor->inputReady = neighbor->direction != OUTPUT_DIRECTION;
         }
+
+        if(segment->initPendingInputs(OUTPUT_DIRECTION) == 0) {
+            readySegments.push_back(segment);
+        }
     }
 
     segmentCounter = 0;
-    KyoukoRoot::m_segmentQueue->addSegmentListToQueue(allSegments);
+    KyoukoRoot::m_segmentQueue->addSegmentListToQueue(readySegments);
 }
 
 /**
@@ -260,13 +290,168 @@ Cluster::setClusterState(const std::string &newState)
         return goToNextState(SWITCH_TO_DIRECT_MODE);
     }
 
-    if(newState == "TASK") {
-        return goToNextState(SWITCH_TO_TASK_MODE);
+    if(newState == "TASK")
+    {
+        if(goToNextState(SWITCH_TO_TASK_MODE) == false) {
+            return false;
+        }
+
+        // a batch of the direct-mode is not continued by the tasks
+        initBatch(1);
+        return true;
     }
 
     return false;
 }
 
+/**
+ * @brief freeze or unfreeze the dynamic segments of the cluster. A frozen cluster only processes
+ *        requests with a read-only copy of the synapses and can not learn. The batched processing
+ *        is only supported by the frozen network, so the cluster can not be changed, while the
+ *        inputs of a batch are pending.
+ *
+ * @param frozen true to freeze the cluster, false to unfreeze it
+ *
+ * @return false, if the cluster is actually processing a task or has a pending batch, else true
+ */
+bool
+Cluster::setFrozen(const bool frozen)
+{
+    // the synapses can only be compiled, while they are not processed
+    if(m_stateMachine->getCurrentStateId() != TASK_STATE) {
+        return false;
+    }
+
+    // the inputs of a pending batch would be dropped or processed by the dynamic network,
+    // which can only handle a single sample
+    if(batchSize > 1) {
+        return false;
+    }
+
+    for(AbstractSegment* segment : allSegments)
+    {
+        if(segment->getType() != DYNAMIC_SEGMENT) {
+            continue;
+        }
+
+        DynamicSegment* dynamicSegment = static_cast<DynamicSegment*>(segment);
+        if(frozen) {
+            dynamicSegment->freeze();
+        } else {
+            dynamicSegment->unfreeze();
+        }
+    }
+
+    isFrozen = frozen;
+
+    // the batched processing is only supported by the frozen network
+    initBatch(1);
+
+    return true;
+}
+
+/**
+ * @brief set the number of samples, which are processed together in the next cycle. The buffers
+ *        of all segments are recreated and the state of the neurons of each sample starts with
+ *        the actual state of the neurons of the segment. The batched processing doesn't change
+ *        the state of the segment itself.
+ *
+ * @param batchSize number of samples, 1 to disable the batched processing
+ */
+void
+Cluster::initBatch(const uint32_t batchSize)
+{
+    this->batchSize = batchSize;
+    if(batchSize == 1) {
+        return;
+    }
+
+    for(AbstractSegment* segment : allSegments) {
+        segment->initBatch(batchSize);
+    }
+}
+
+/**
+ * @brief select the number of samples of the actual request-task, which are processed in the
+ *        next cycle. Only a frozen cluster can process multiple samples at once. The state of
+ *        the neurons is reset for each batch, so all samples of a batch start with the state,
+ *        which the segment had before the request. Without batch, each sample starts with the
+ *        state, which the sample before has left behind. So a batched request is independent of
+ *        the order of the samples, but not bit-identical to the same samples processed one
+ *        after another.
+ *
+ * @return number of samples of the next cycle
+ */
+uint32_t
+Cluster::prepareRequestBatch()
+{
+    uint32_t newBatchSize = 1;
+    if(isFrozen)
+    {
+        Task* actualTask = getActualTask();
+        const uint64_t remainingCycles = actualTask->getIntVal("number_of_cycles")
+                                         - actualTask->actualCycle;
+        newBatchSize = std::min(remainingCycles, static_cast<uint64_t>(MAX_BATCH_SIZE));
+    }
+
+    initBatch(newBatchSize);
+
+    return batchSize;
+}
+
+/**
+ * @brief set the weight of the cluster for the scheduling of its segments. The clusters get the
+ *        cpu-time of the processing-units in relation to their weights.
+ *
+ * @param weight new weight between 1 and MAX_CLUSTER_WEIGHT
+ *
+ * @return false, if the weight is invalid or the cluster has no own sub-queue, else true
+ */
+bool
+Cluster::setSchedulingWeight(const uint32_t weight)
+{
+    if(KyoukoRoot::m_segmentQueue == nullptr) {
+        return false;
+    }
+
+    return KyoukoRoot::m_segmentQueue->setClusterWeight(schedulingQueueId, weight);
+}
+
+/**
+ * @brief get the weight of the cluster for the scheduling of its segments
+ *
+ * @return weight of the cluster
+ */
+uint32_t
+Cluster::getSchedulingWeight()
+{
+    if(KyoukoRoot::m_segmentQueue == nullptr) {
+        return 0;
+    }
+
+    return KyoukoRoot::m_segmentQueue->getClusterWeight(schedulingQueueId);
+}
+
+/**
+ * @brief get the time, which the segments of the cluster had to wait for a processing-unit
+ *
+ * @param averageWaitTime reference for the average wait-time in microseconds
+ * @param maxWaitTime reference for the maximum wait-time in microseconds
+ */
+void
+Cluster::getQueueWaitTime(uint64_t &averageWaitTime, uint64_t &maxWaitTime)
+{
+    averageWaitTime = 0;
+    maxWaitTime = 0;
+    if(KyoukoRoot::m_segmentQueue == nullptr) {
+        return;
+    }
+
+    KyoukoRoot::m_segmentQueue->getClusterWaitTime(schedulingQueueId,
+                                                   averageWaitTime,
+                                                   maxWaitTime);
+}
+
 /**
  * @brief update state of the cluster, which is caled for each finalized segment
  */
@@ -305,6 +490,7 @@ Cluster::updateClusterState()
  * @param numberOfInputsPerCycle number of inputs per cycle
  * @param numberOfOuputsPerCycle number of outputs per cycle
  * @param numberOfCycle number of cycles
+ * @param learnBatchSize number of samples, whose weight-changes are applied together
  *
  * @return task-uuid
  */
@@ -315,7 +501,8 @@ Cluster::addImageLearnTask(const std::string &name,
                            float* inputData,
                            const uint64_t numberOfInputsPerCycle,
                            const uint64_t numberOfOuputsPerCycle,
-                           const uint64_t numberOfCycle)
+                           const uint64_t numberOfCycle,
+                           const uint32_t learnBatchSize)
 {
     // create new learn-task
     Task newTask;
@@ -335,6 +522,8 @@ Cluster::addImageLearnTask(const std::string &name,
                             new DataValue(static_cast<long>(numberOfInputsPerCycle)));
     newTask.metaData.insert("number_of_outputs_per_cycle",
                             new DataValue(static_cast<long>(numberOfOuputsPerCycle)));
+    newTask.metaData.insert("learn_batch_size",
+                            new DataValue(static_cast<long>(learnBatchSize)));
 
     // add task to queue
     const std::string uuid = newTask.uuid.toString();
@@ -402,6 +591,7 @@ Cluster::addImageRequestTask(const std::string &name,
  * @param inputData input-data
  * @param numberOfInputs number of inputs per cycle
  * @param numberOfCycle number of cycles
+ * @param learnBatchSize number of samples, whose weight-changes are applied together
  *
  * @return task-uuid
  */
@@ -413,7 +603,8 @@ Cluster::addTableLearnTask(const std::string &name,
                            float* outputData,
                            const uint64_t numberOfInputs,
                            const uint64_t numberOfOutputs,
-                           const uint64_t numberOfCycle)
+                           const uint64_t numberOfCycle,
+                           const uint32_t learnBatchSize)
 {
     // create new learn-task
     Task newTask;
@@ -434,6 +625,8 @@ Cluster::addTableLearnTask(const std::string &name,
                             new DataValue(static_cast<long>(numberOfInputs)));
     newTask.metaData.insert("number_of_outputs_per_cycle",
                             new DataValue(static_cast<long>(numberOfOutputs)));
+    newTask.metaData.insert("learn_batch_size",
+                            new DataValue(static_cast<long>(learnBatchSize)));
 
     // add task to queue
     const std::string uuid = newTask.uuid.toString();
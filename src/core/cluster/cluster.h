@@ -97,7 +97,9 @@ public:
     bool setName(const std::string newName);
     bool init(const Kitsunemimi::Hanami::ClusterMeta &clusterTemplate,
               const std::map<std::string, Kitsunemimi::Hanami::SegmentMeta> &segmentTemplates,
-              const std::string &uuid);
+              const std::string &uuid,
+              const SynapseFormat synapseFormat,
+              const SectionGeometry sectionGeometry);
     bool connectSlot(const std::string &sourceSegmentName,
                      const std::string &sourceSlotName,
                      const std::string &targetSegmentName,
@@ -112,7 +114,8 @@ public:
                                         float* inputData,
                                         const uint64_t numberOfInputsPerCycle,
                                         const uint64_t numberOfOuputsPerCycle,
-                                        const uint64_t numberOfCycle);
+                                        const uint64_t numberOfCycle,
+                                        const uint32_t learnBatchSize);
     const std::string addImageRequestTask(const std::string &name,
                                           const std::string &userId,
                                           const std::string &projectId,
@@ -127,7 +130,8 @@ public:
                                         float* outputData,
                                         const uint64_t numberOfInputs,
                                         const uint64_t numberOfOutputs,
-                                        const uint64_t numberOfCycle);
+                                        const uint64_t numberOfCycle,
+                                        const uint32_t learnBatchSize);
     const std::string addTableRequestTask(const std::string &name,
                                           const std::string &userId,
                                           const std::string &projectId,
@@ -155,11 +159,25 @@ public:
     void startForwardCycle();
     void startBackwardCycle();
     bool setClusterState(const std::string &newState);
+    bool setFrozen(const bool frozen);
+    void initBatch(const uint32_t batchSize);
+    uint32_t prepareRequestBatch();
+
+    // scheduling
+    bool setSchedulingWeight(const uint32_t weight);
+    uint32_t getSchedulingWeight();
+    void getQueueWaitTime(uint64_t &averageWaitTime, uint64_t &maxWaitTime);
 
     uint32_t segmentCounter = 0;
     ClusterProcessingMode mode = NORMAL_MODE;
+    bool isFrozen = false;
+    uint32_t batchSize = 1;
+    uint32_t learnBatchSize = 1;
     Kitsunemimi::Hanami::HanamiMessagingClient* msgClient = nullptr;
 
+    // id of the sub-queue of the cluster within the segment-queue
+    uint32_t schedulingQueueId = 0;
+
 private:
     Kitsunemimi::Statemachine* m_stateMachine = nullptr;
     TaskHandle_State* m_taskHandleState = nullptr;
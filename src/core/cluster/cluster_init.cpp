@@ -109,6 +109,8 @@ initHeader(Cluster* cluster,
  * @param parsedContent parsed json with the information of the cluster
  * @param segmentTemplates TODO
  * @param uuid uuid for the new cluster
+ * @param synapseFormat format of the synapses of the dynamic segments
+ * @param sectionGeometry geometry of the synapse-sections of the dynamic segments
  *
  * @return true, if successful, else false
  */
@@ -116,7 +118,9 @@ bool
 initNewCluster(Cluster* cluster,
                const Kitsunemimi::Hanami::ClusterMeta &clusterTemplate,
                const std::map<std::string, Kitsunemimi::Hanami::SegmentMeta> &segmentTemplates,
-               const std::string &uuid)
+               const std::string &uuid,
+               const SynapseFormat synapseFormat,
+               const SectionGeometry sectionGeometry)
 {
     // meta-data
     Cluster::MetaData newMetaData;
@@ -145,7 +149,11 @@ initNewCluster(Cluster* cluster,
             } else if(segmentPtr.type == "output") {
                 newSegment = addOutputSegment(cluster, segmentPtr.name, it->second);
             } else {
-                newSegment = addDynamicSegment(cluster, segmentPtr.name, it->second);
+                newSegment = addDynamicSegment(cluster,
+                                               segmentPtr.name,
+                                               it->second,
+                                               synapseFormat,
+                                               sectionGeometry);
             }
         }
         else
@@ -264,15 +272,19 @@ addOutputSegment(Cluster* cluster,
  *
  * @param cluster pointer to the uninitionalized cluster
  * @param clusterTemplatePart parsed json with the information of the cluster
+ * @param synapseFormat format of the synapses of the new segment
+ * @param sectionGeometry geometry of the synapse-sections of the new segment
  *
  * @return true, if successful, else false
  */
 AbstractSegment*
 addDynamicSegment(Cluster* cluster,
                   const std::string &name,
-                  const Kitsunemimi::Hanami::SegmentMeta &segmentMeta)
+                  const Kitsunemimi::Hanami::SegmentMeta &segmentMeta,
+                  const SynapseFormat synapseFormat,
+                  const SectionGeometry sectionGeometry)
 {
-    DynamicSegment* newSegment = new DynamicSegment();
+    DynamicSegment* newSegment = new DynamicSegment(synapseFormat, sectionGeometry);
     if(newSegment->initSegment(name, segmentMeta))
     {
         cluster->coreSegments.insert(std::make_pair(name, newSegment));
@@ -39,7 +39,9 @@ bool reinitPointer(Cluster* cluster, const std::string &uuid);
 bool initNewCluster(Cluster* cluster,
                     const Kitsunemimi::Hanami::ClusterMeta &clusterTemplate,
                     const std::map<std::string, Kitsunemimi::Hanami::SegmentMeta> &segmentTemplates,
-                    const std::string &uuid);
+                    const std::string &uuid,
+                    const SynapseFormat synapseFormat,
+                    const SectionGeometry sectionGeometry);
 
 AbstractSegment* addInputSegment(Cluster* cluster,
                                  const std::string &name,
@@ -49,6 +51,8 @@ AbstractSegment* addOutputSegment(Cluster* cluster,
                                   const Kitsunemimi::Hanami::SegmentMeta &segmentMeta);
 AbstractSegment* addDynamicSegment(Cluster* cluster,
                                    const std::string &name,
-                                   const Kitsunemimi::Hanami::SegmentMeta &segmentMeta);
+                                   const Kitsunemimi::Hanami::SegmentMeta &segmentMeta,
+                                   const SynapseFormat synapseFormat,
+                                   const SectionGeometry sectionGeometry);
 
 #endif // KYOUKOMIND_CLUSTERINIT_H
@@ -55,13 +55,23 @@ CycleFinish_State::processEvent()
     const uint64_t numberOfCycles = numberOfCyclesVal->getLong();
 
     // update progress-counter
-    actualTask->actualCycle++;
+    actualTask->actualCycle += m_cluster->batchSize;
     const float actualF = static_cast<float>(actualTask->actualCycle);
     const float shouldF = static_cast<float>(numberOfCycles);
     actualTask->progress.percentageFinished = actualF / shouldF;
 
     // to go next state of finish the task to goal is reached
-    if(actualTask->actualCycle == numberOfCycles) {
+    if(actualTask->actualCycle == numberOfCycles)
+    {
+        // apply the weight-changes of an incomplete last mini-batch
+        for(AbstractSegment* segment : m_cluster->allSegments)
+        {
+            if(segment->getType() == DYNAMIC_SEGMENT) {
+                static_cast<DynamicSegment*>(segment)->applyWeightDeltas();
+            }
+        }
+        m_cluster->learnBatchSize = 1;
+
         m_cluster->goToNextState(FINISH_TASK);
 
         /*DynamicSegment* segment = static_cast<DynamicSegment*>(m_cluster->coreSegments.begin()->second);
@@ -74,7 +84,9 @@ CycleFinish_State::processEvent()
         std::cout<<"============================================"<<std::endl;
         std::cout<<counter<<std::endl;
         std::cout<<"============================================"<<std::endl;*/
-    } else {
+    }
+    else
+    {
         m_cluster->goToNextState(NEXT);
     }
 
@@ -56,11 +56,28 @@ ImageIdentify_State::processEvent()
     const uint64_t numberOfOuputsPerCycle = actualTask->getIntVal("number_of_outputs_per_cycle");
     const uint64_t entriesPerCycle = numberOfInputsPerCycle + numberOfOuputsPerCycle;
     const uint64_t offsetInput = entriesPerCycle * actualTask->actualCycle;
+    InputSegment* inputSegment = m_cluster->inputSegments.begin()->second;
 
-    // set input
-    InputNeuron* inputNeurons = m_cluster->inputSegments.begin()->second->inputs;
-    for(uint64_t i = 0; i < numberOfInputsPerCycle; i++) {
-        inputNeurons[i].weight = actualTask->inputData[offsetInput + i];
+    // a frozen cluster processes multiple images at once
+    const uint32_t batchSize = m_cluster->prepareRequestBatch();
+    if(batchSize > 1)
+    {
+        float* batchInputs = inputSegment->batchInputs.data();
+        for(uint32_t sample = 0; sample < batchSize; sample++)
+        {
+            const uint64_t offset = offsetInput + entriesPerCycle * sample;
+            for(uint64_t i = 0; i < numberOfInputsPerCycle; i++) {
+                batchInputs[i * batchSize + sample] = actualTask->inputData[offset + i];
+            }
+        }
+    }
+    else
+    {
+        // set input
+        InputNeuron* inputNeurons = inputSegment->inputs;
+        for(uint64_t i = 0; i < numberOfInputsPerCycle; i++) {
+            inputNeurons[i].weight = actualTask->inputData[offsetInput + i];
+        }
     }
 
     m_cluster->mode = Cluster::NORMAL_MODE;
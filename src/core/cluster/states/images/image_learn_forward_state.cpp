@@ -71,6 +71,7 @@ ImageLearnForward_State::processEvent()
         outputNeurons[i].shouldValue = actualTask->inputData[offsetInput + numberOfCycles + i];
     }
 
+    m_cluster->learnBatchSize = actualTask->getIntVal("learn_batch_size");
     m_cluster->mode = Cluster::LEARN_FORWARD_MODE;
     m_cluster->startForwardCycle();
 
@@ -26,6 +26,7 @@
 #include <core/cluster/cluster.h>
 #include <core/cluster/cluster_init.h>
 #include <core/cluster/statemachine_init.h>
+#include <core/fast_math.h>
 #include <core/segments/abstract_segment.h>
 #include <core/segments/input_segment/input_segment.h>
 #include <core/segments/output_segment/output_segment.h>
@@ -56,6 +57,34 @@ RestoreCluster_State::RestoreCluster_State(Cluster* cluster)
  */
 RestoreCluster_State::~RestoreCluster_State() {}
 
+/**
+ * @brief check if a restored segment has the layout of this version. The segments of a snapshot
+ *        are raw copies of the memory, so snapshots with an other layout can not be used.
+ *
+ * @param segment restored segment, whose pointers are not initialized yet
+ * @param error reference for error-output
+ *
+ * @return true, if the layout is supported, else false
+ */
+bool
+RestoreCluster_State::checkLayoutVersion(const AbstractSegment* segment,
+                                         Kitsunemimi::ErrorContainer &error)
+{
+    const uint8_t version = segment->getLayoutVersion();
+    if(version != SEGMENT_LAYOUT_VERSION)
+    {
+        error.addMeesage("Segment of the snapshot has the layout-version "
+                         + std::to_string(version)
+                         + ", but only version "
+                         + std::to_string(SEGMENT_LAYOUT_VERSION)
+                         + " is supported");
+        error.addSolution("Create a new snapshot of the cluster with this version");
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * @brief prcess event
  *
@@ -144,6 +173,14 @@ RestoreCluster_State::processEvent()
             case INPUT_SEGMENT:
             {
                 InputSegment* newSegment = new InputSegment(&u8Data[posCounter], size);
+                if(checkLayoutVersion(newSegment, error) == false)
+                {
+                    LOG_ERROR(error);
+                    delete newSegment;
+                    delete snapshotBuffer;
+                    m_cluster->goToNextState(FINISH_TASK);
+                    return false;
+                }
                 newSegment->reinitPointer(size);
                 newSegment->parentCluster = m_cluster;
                 m_cluster->inputSegments.insert(std::make_pair(newSegment->getName(), newSegment));
@@ -153,6 +190,14 @@ RestoreCluster_State::processEvent()
             case OUTPUT_SEGMENT:
             {
                 OutputSegment* newSegment = new OutputSegment(&u8Data[posCounter], size);
+                if(checkLayoutVersion(newSegment, error) == false)
+                {
+                    LOG_ERROR(error);
+                    delete newSegment;
+                    delete snapshotBuffer;
+                    m_cluster->goToNextState(FINISH_TASK);
+                    return false;
+                }
                 newSegment->reinitPointer(size);
                 newSegment->parentCluster = m_cluster;
                 m_cluster->outputSegments.insert(std::make_pair(newSegment->getName(), newSegment));
@@ -161,8 +206,36 @@ RestoreCluster_State::processEvent()
             }
             case DYNAMIC_SEGMENT:
             {
-                DynamicSegment* newSegment = new DynamicSegment(&u8Data[posCounter], size);
-                newSegment->reinitPointer(size);
+                // snapshots of older versions have no valid trailer behind the synapse-sections
+                const uint8_t* segmentData = &u8Data[posCounter];
+                if(SectionArena::getStaticSnapshotSize(segmentData, size) == 0)
+                {
+                    error.addMeesage("Snapshot of dynamic segment has an unsupported format");
+                    LOG_ERROR(error);
+                    delete snapshotBuffer;
+                    m_cluster->goToNextState(FINISH_TASK);
+                    return false;
+                }
+
+                DynamicSegment* newSegment = new DynamicSegment(segmentData, size);
+                if(checkLayoutVersion(newSegment, error) == false)
+                {
+                    LOG_ERROR(error);
+                    delete newSegment;
+                    delete snapshotBuffer;
+                    m_cluster->goToNextState(FINISH_TASK);
+                    return false;
+                }
+                if(newSegment->restoreSynapseSections(segmentData, size, error) == false
+                        || newSegment->reinitPointer(size) == false)
+                {
+                    error.addMeesage("Failed to restore dynamic segment from snapshot");
+                    LOG_ERROR(error);
+                    delete newSegment;
+                    delete snapshotBuffer;
+                    m_cluster->goToNextState(FINISH_TASK);
+                    return false;
+                }
                 newSegment->parentCluster = m_cluster;
                 m_cluster->allSegments.push_back(newSegment);
                 break;
@@ -178,6 +251,22 @@ RestoreCluster_State::processEvent()
 
     delete snapshotBuffer;
 
+    // snapshots with fast-math fall back to the libm-functions, if the approximations are not
+    // accurate enough on this host
+    bool useFastMath = false;
+    for(AbstractSegment* segment : m_cluster->allSegments) {
+        useFastMath |= segment->dynamicSegmentSettings->fastMath != 0;
+    }
+    if(useFastMath
+            && checkFastMath() == false)
+    {
+        LOG_WARNING("fast-math is not available on this host, so the restored cluster '"
+                    + m_cluster->getName() + "' uses the libm-functions");
+        for(AbstractSegment* segment : m_cluster->allSegments) {
+            segment->dynamicSegmentSettings->fastMath = 0;
+        }
+    }
+
     m_cluster->goToNextState(FINISH_TASK);
 
     return true;
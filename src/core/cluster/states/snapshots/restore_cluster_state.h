@@ -25,8 +25,10 @@
 
 #include <libKitsunemimiCommon/threading/event.h>
 #include <libKitsunemimiJson/json_item.h>
+#include <libKitsunemimiCommon/logger.h>
 
 class Cluster;
+class AbstractSegment;
 
 namespace Kitsunemimi {
 namespace Hanami {
@@ -46,6 +48,8 @@ public:
 private:
     Cluster* m_cluster = nullptr;
     Kitsunemimi::Hanami::HanamiMessagingClient* m_client = nullptr;
+
+    bool checkLayoutVersion(const AbstractSegment* segment, Kitsunemimi::ErrorContainer &error);
 };
 
 #endif // RESTORECLUSTERSTATE_H
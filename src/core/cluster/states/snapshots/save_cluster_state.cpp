@@ -26,6 +26,7 @@
 #include <core/cluster/cluster.h>
 #include <core/cluster/statemachine_init.h>
 #include <core/segments/abstract_segment.h>
+#include <core/segments/dynamic_segment/dynamic_segment.h>
 
 #include <libKitsunemimiHanamiNetwork/hanami_messaging_client.h>
 #include <libKitsunemimiHanamiNetwork/hanami_messaging.h>
@@ -77,11 +78,15 @@ SaveCluster_State::processEvent()
             if(i != 0) {
                 headerMessage += ",";
             }
-            const uint64_t segSize = m_cluster->allSegments.at(i)->segmentData.buffer.usedBufferSize;
+            AbstractSegment* segment = m_cluster->allSegments.at(i);
+            uint64_t segSize = segment->segmentData.buffer.usedBufferSize;
+            if(segment->getType() == DYNAMIC_SEGMENT) {
+                segSize += static_cast<DynamicSegment*>(segment)->synapseArena.getSnapshotSize();
+            }
             headerMessage += "{\"size\":"
                              + std::to_string(segSize)
                              + ",\"type\":"
-                             + std::to_string(m_cluster->allSegments.at(i)->getType())
+                             + std::to_string(segment->getType())
                              + "}";
             totalSize += segSize;
         }
@@ -180,8 +185,71 @@ SaveCluster_State::sendData(const std::string &snapshotUuid,
                              + "' to shiori");
             return false;
         }
+
+        AbstractSegment* segment = m_cluster->allSegments.at(i);
+        if(segment->getType() == DYNAMIC_SEGMENT
+                && sendSynapseSections(static_cast<DynamicSegment*>(segment)->synapseArena,
+                                       posCounter,
+                                       snapshotUuid,
+                                       fileUuid,
+                                       error) == false)
+        {
+            error.addMeesage("Failed to send synapse-sections of segment '"
+                             + std::to_string(i)
+                             + "' to shiori");
+            return false;
+        }
     }
 
     return true;
 }
 
+/**
+ * @brief send the used synapse-sections of a dynamic segment, followed by a trailer with the
+ *        format-marker, their size and their number. The sections are sent block by block, to
+ *        avoid a copy of the complete arena.
+ *
+ * @param arena arena with the synapse-sections
+ * @param posCounter position within the complete snapshot
+ * @param snapshotUuid uuid of the snapshot
+ * @param fileUuid uuid of the file of the snapshot
+ * @param error reference for error-output
+ *
+ * @return true, if successful, else false
+ */
+bool
+SaveCluster_State::sendSynapseSections(const SectionArena &arena,
+                                       uint64_t &posCounter,
+                                       const std::string &snapshotUuid,
+                                       const std::string &fileUuid,
+                                       Kitsunemimi::ErrorContainer &error)
+{
+    const uint64_t sectionSize = arena.getSectionSize();
+    const uint64_t blockSize = SYNAPSE_SECTIONS_PER_BLOCK * sectionSize;
+    Kitsunemimi::DataBuffer blockBuffer(Kitsunemimi::calcBytesToBlocks(blockSize));
+    const uint8_t* sectionData = static_cast<const uint8_t*>(arena.sections);
+    const uint64_t totalSize = arena.numberOfSections * sectionSize;
+
+    for(uint64_t pos = 0; pos < totalSize; pos += blockSize)
+    {
+        blockBuffer.usedBufferSize = 0;
+        Kitsunemimi::addData_DataBuffer(blockBuffer,
+                                        &sectionData[pos],
+                                        std::min(blockSize, totalSize - pos));
+        if(Shiori::sendData(&blockBuffer, posCounter, snapshotUuid, fileUuid, error) == false) {
+            return false;
+        }
+    }
+
+    // the format and the layout of the sections are part of the trailer, so they can be checked
+    // at the restore
+    blockBuffer.usedBufferSize = 0;
+    const uint64_t magic = SYNAPSE_SNAPSHOT_MAGIC;
+    const uint64_t numberOfSections = arena.numberOfSections;
+    Kitsunemimi::addData_DataBuffer(blockBuffer, &magic, sizeof(uint64_t));
+    Kitsunemimi::addData_DataBuffer(blockBuffer, &sectionSize, sizeof(uint64_t));
+    Kitsunemimi::addData_DataBuffer(blockBuffer, &numberOfSections, sizeof(uint64_t));
+
+    return Shiori::sendData(&blockBuffer, posCounter, snapshotUuid, fileUuid, error);
+}
+
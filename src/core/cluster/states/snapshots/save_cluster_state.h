@@ -27,6 +27,7 @@
 #include <libKitsunemimiJson/json_item.h>
 
 class Cluster;
+class SectionArena;
 
 namespace Kitsunemimi {
 namespace Hanami {
@@ -49,6 +50,11 @@ private:
     bool sendData(const std::string &snapshotUuid,
                   const std::string &fileUuid,
                   Kitsunemimi::ErrorContainer &error);
+    bool sendSynapseSections(const SectionArena &arena,
+                             uint64_t &posCounter,
+                             const std::string &snapshotUuid,
+                             const std::string &fileUuid,
+                             Kitsunemimi::ErrorContainer &error);
 };
 
 #endif // SAVECLUSTERSTATE_H
@@ -62,10 +62,28 @@ TableInterpolation_State::processEvent()
         offset += numberOfOuputsPerCycle;
     }
 
-    // set input
-    InputNeuron* inputNeurons = m_cluster->inputSegments.begin()->second->inputs;
-    for(uint64_t i = 0; i < numberOfInputsPerCycle; i++) {
-        inputNeurons[i].weight = actualTask->inputData[(offset - numberOfInputsPerCycle) + i];
+    InputSegment* inputSegment = m_cluster->inputSegments.begin()->second;
+
+    // a frozen cluster processes multiple rows at once
+    const uint32_t batchSize = m_cluster->prepareRequestBatch();
+    if(batchSize > 1)
+    {
+        float* batchInputs = inputSegment->batchInputs.data();
+        for(uint32_t sample = 0; sample < batchSize; sample++)
+        {
+            const uint64_t start = (offset + sample) - numberOfInputsPerCycle;
+            for(uint64_t i = 0; i < numberOfInputsPerCycle; i++) {
+                batchInputs[i * batchSize + sample] = actualTask->inputData[start + i];
+            }
+        }
+    }
+    else
+    {
+        // set input
+        InputNeuron* inputNeurons = inputSegment->inputs;
+        for(uint64_t i = 0; i < numberOfInputsPerCycle; i++) {
+            inputNeurons[i].weight = actualTask->inputData[(offset - numberOfInputsPerCycle) + i];
+        }
     }
 
     m_cluster->mode = Cluster::NORMAL_MODE;
@@ -73,6 +73,7 @@ TableLearnForward_State::processEvent()
         outputNeurons[i].shouldValue = actualTask->outputData[(offset - numberOfOuputsPerCycle) + i];
     }
 
+    m_cluster->learnBatchSize = actualTask->getIntVal("learn_batch_size");
     m_cluster->mode = Cluster::LEARN_FORWARD_MODE;
     m_cluster->startForwardCycle();
 
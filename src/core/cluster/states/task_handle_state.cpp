@@ -267,6 +267,9 @@ TaskHandle_State::finishTask()
         it->second.progress.endActiveTimeStamp = std::chrono::system_clock::now();
     }
 
+    // the batch of a request-task ends with the task
+    m_cluster->initBatch(1);
+
     actualTask = nullptr;
 }
 
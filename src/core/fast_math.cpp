@@ -0,0 +1,94 @@
+/**
+ * @file        fast_math.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "fast_math.h"
+
+#include <libKitsunemimiCommon/logger.h>
+
+/**
+ * @brief compare the approximations with the libm-functions at a few fixed values and the
+ *        vectorized version with the scalar one. This doesn't replace the check over the whole
+ *        input-range within the unit-tests, but is cheap enough to detect a broken build of the
+ *        approximations, before a cluster with fast-math is created.
+ *
+ * @return true, if all values are within the documented limits, else false
+ */
+bool
+checkFastMath()
+{
+    const float inputs[10] = {-97.3f, -20.5f, -1.3f, -0.25f, 0.0f, 0.7f, 1.0f, 3.3f, 17.9f, 100.0f};
+    double log2Error = 0.0;
+    double exp2Error = 0.0;
+    double sigmoidError = 0.0;
+
+    for(const float input : inputs)
+    {
+        const float log2Input = std::fabs(input) + 0.001f;
+        const double expectedLog2 = std::log2(static_cast<double>(log2Input));
+        double error = std::fabs(static_cast<double>(fastLog2(log2Input)) - expectedLog2);
+        if(std::fabs(expectedLog2) >= 1.0) {
+            error /= std::fabs(expectedLog2);
+        }
+        log2Error = std::max(log2Error, error);
+
+        const double expectedExp2 = std::exp2(static_cast<double>(input));
+        const double exp2Diff = static_cast<double>(fastExp2(input)) - expectedExp2;
+        exp2Error = std::max(exp2Error, std::fabs(exp2Diff) / expectedExp2);
+
+        const double expectedSigmoid = 1.0 / (1.0 + std::exp(-static_cast<double>(input)));
+        const double sigmoidDiff = static_cast<double>(fastSigmoid(input)) - expectedSigmoid;
+        sigmoidError = std::max(sigmoidError, std::fabs(sigmoidDiff));
+    }
+
+    // the vectorized version has to give the same results like the scalar one, which can only
+    // differ by the rounding of the compiler
+    float values[NEURON_LANES_PER_NEURONSECTION];
+    float expected[NEURON_LANES_PER_NEURONSECTION];
+    for(uint32_t i = 0; i < NEURON_LANES_PER_NEURONSECTION; i++)
+    {
+        values[i] = static_cast<float>(i) * 0.37f - 0.9f;
+        expected[i] = fastLog2(values[i] + 1.0f);
+    }
+    applyLog2Activation(values, NEURON_LANES_PER_NEURONSECTION, true);
+    bool sameResults = true;
+    for(uint32_t i = 0; i < NEURON_LANES_PER_NEURONSECTION; i++)
+    {
+        const float diff = std::fabs(values[i] - expected[i]);
+        sameResults &= diff <= 1.0e-6f * std::max(1.0f, std::fabs(expected[i]));
+    }
+
+    if(log2Error > FAST_LOG2_MAX_ERROR
+            || exp2Error > FAST_EXP2_MAX_ERROR
+            || sigmoidError > FAST_SIGMOID_MAX_ERROR
+            || sameResults == false)
+    {
+        LOG_WARNING("Approximations of the fast-math are not within the limits: log2-error: "
+                    + std::to_string(log2Error)
+                    + " exp2-error: "
+                    + std::to_string(exp2Error)
+                    + " sigmoid-error: "
+                    + std::to_string(sigmoidError));
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,340 @@
+/**
+ * @file        fast_math.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_FAST_MATH_H
+#define KYOUKOMIND_FAST_MATH_H
+
+#include <common.h>
+#include <cfloat>
+
+#if defined(__AVX2__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+// Approximations of the transcendental functions of the neuron-updates, which can be selected
+// per segment instead of the libm-functions. They use the range-reductions and polynomials of
+// the cephes-library and contain no branches in the vectorized versions. The maximum errors
+// compared to the libm-functions are checked over the whole input-range by the unit-tests. At
+// runtime checkFastMath only compares a few values, before a cluster with fast-math is created:
+//
+//     fastLog2     error <= FAST_LOG2_MAX_ERROR, absolute for results in (-1, 1) and relative
+//                  for all other results, for all positive inputs
+//     fastExp2     relative error <= FAST_EXP2_MAX_ERROR for inputs in [-126, 128)
+//     fastSigmoid  absolute error <= FAST_SIGMOID_MAX_ERROR for all inputs
+//
+// Zero, negative and infinite inputs of fastLog2 give the same results like log2. Below -126
+// fastExp2 gives 0 instead of a denormal value and above 128 it gives infinity.
+
+#define FAST_LOG2_MAX_ERROR 1.0e-7
+#define FAST_EXP2_MAX_ERROR 2.0e-7
+#define FAST_SIGMOID_MAX_ERROR 2.0e-7
+
+#define FAST_MATH_SQRT_HALF 0.707106781186547524f
+#define FAST_MATH_LOG2E 1.44269504088896341f
+
+/**
+ * @brief evaluate the polynomial for ln(1 + z) with z in [sqrt(0.5) - 1, sqrt(2) - 1]
+ *
+ * @param z reduced value
+ *
+ * @return ln(1 + z) - z
+ */
+inline float
+fastLnPolynomial(const float z)
+{
+    float p = 7.0376836292e-2f;
+    p = p * z - 1.1514610310e-1f;
+    p = p * z + 1.1676998740e-1f;
+    p = p * z - 1.2420140846e-1f;
+    p = p * z + 1.4249322787e-1f;
+    p = p * z - 1.6668057665e-1f;
+    p = p * z + 2.0000714765e-1f;
+    p = p * z - 2.4999993993e-1f;
+    p = p * z + 3.3333331174e-1f;
+
+    const float z2 = z * z;
+    return z2 * z * p - 0.5f * z2;
+}
+
+/**
+ * @brief evaluate the polynomial for 2^f with f in [-0.5, 0.5]
+ *
+ * @param f reduced value
+ *
+ * @return 2^f
+ */
+inline float
+fastExp2Polynomial(const float f)
+{
+    float p = 1.535336188319500e-4f;
+    p = p * f + 1.339887440266574e-3f;
+    p = p * f + 9.618437357674640e-3f;
+    p = p * f + 5.550332471162809e-2f;
+    p = p * f + 2.402264791363012e-1f;
+    p = p * f + 6.931472028550421e-1f;
+    return p * f + 1.0f;
+}
+
+/**
+ * @brief approximation of log2
+ *
+ * @param value input-value
+ *
+ * @return log2 of the value
+ */
+inline float
+fastLog2(const float value)
+{
+    if((value > 0.0f) == false) {
+        return value == 0.0f ? -INFINITY : NAN;
+    }
+    if(value == INFINITY) {
+        return INFINITY;
+    }
+
+    // denormal values are scaled by 2^23 to get a normal exponent
+    float normalized = value;
+    float exponentOffset = 0.0f;
+    if(value < FLT_MIN)
+    {
+        normalized *= 8388608.0f;
+        exponentOffset = 23.0f;
+    }
+
+    // split into exponent and mantissa in [sqrt(0.5), sqrt(2))
+    uint32_t bits = 0;
+    memcpy(&bits, &normalized, sizeof(float));
+    float exponent = static_cast<float>(static_cast<int32_t>(bits >> 23) - 126) - exponentOffset;
+    bits = (bits & 0x007fffff) | 0x3f000000;
+    float mantissa = 0.0f;
+    memcpy(&mantissa, &bits, sizeof(float));
+    if(mantissa < FAST_MATH_SQRT_HALF)
+    {
+        mantissa += mantissa;
+        exponent -= 1.0f;
+    }
+
+    const float z = mantissa - 1.0f;
+    return (z + fastLnPolynomial(z)) * FAST_MATH_LOG2E + exponent;
+}
+
+/**
+ * @brief approximation of 2^x
+ *
+ * @param value input-value
+ *
+ * @return 2 to the power of the value
+ */
+inline float
+fastExp2(const float value)
+{
+    if(value < -126.0f) {
+        return 0.0f;
+    }
+    if(value >= 128.0f) {
+        return INFINITY;
+    }
+
+    // split into integer and fraction in [-0.5, 0.5]
+    const float integer = std::floor(value + 0.5f);
+    const float fraction = value - integer;
+    const uint32_t bits = static_cast<uint32_t>(static_cast<int32_t>(integer) + 127) << 23;
+    float scale = 0.0f;
+    memcpy(&scale, &bits, sizeof(float));
+
+    // 2^127 * 2^0.5 doesn't fit into the scale, so the last step is split
+    if(integer > 127.0f) {
+        return fastExp2Polynomial(fraction) * 2.0f * 1.7014118346046923e38f;
+    }
+    return fastExp2Polynomial(fraction) * scale;
+}
+
+/**
+ * @brief approximation of 1 / (1 + e^-x)
+ *
+ * @param value input-value
+ *
+ * @return sigmoid of the value
+ */
+inline float
+fastSigmoid(const float value)
+{
+    return 1.0f / (1.0f + fastExp2(-value * FAST_MATH_LOG2E));
+}
+
+bool checkFastMath();
+
+//==================================================================================================
+
+#if defined(__AVX512F__)
+/**
+ * @brief approximation of log2 for 16 values
+ *
+ * @param value input-values
+ *
+ * @return log2 of the values
+ */
+inline __m512
+fastLog2(const __m512 value)
+{
+    const __mmask16 positive = _mm512_cmp_ps_mask(value, _mm512_setzero_ps(), _CMP_GT_OQ);
+    const __mmask16 isZero = _mm512_cmp_ps_mask(value, _mm512_setzero_ps(), _CMP_EQ_OQ);
+    const __mmask16 isInf = _mm512_cmp_ps_mask(value, _mm512_set1_ps(INFINITY), _CMP_EQ_OQ);
+
+    // denormal values are scaled by 2^23 to get a normal exponent
+    const __mmask16 denormal = _mm512_cmp_ps_mask(value, _mm512_set1_ps(FLT_MIN), _CMP_LT_OQ);
+    const __m512 normalized = _mm512_mask_mul_ps(value,
+                                                 denormal,
+                                                 value,
+                                                 _mm512_set1_ps(8388608.0f));
+
+    const __m512i bits = _mm512_castps_si512(normalized);
+    __m512 exponent = _mm512_cvtepi32_ps(_mm512_sub_epi32(_mm512_srli_epi32(bits, 23),
+                                                          _mm512_set1_epi32(126)));
+    exponent = _mm512_mask_sub_ps(exponent, denormal, exponent, _mm512_set1_ps(23.0f));
+    __m512 mantissa = _mm512_castsi512_ps(
+                _mm512_or_si512(_mm512_and_si512(bits, _mm512_set1_epi32(0x007fffff)),
+                                _mm512_set1_epi32(0x3f000000)));
+    const __mmask16 small = _mm512_cmp_ps_mask(mantissa,
+                                               _mm512_set1_ps(FAST_MATH_SQRT_HALF),
+                                               _CMP_LT_OQ);
+    mantissa = _mm512_mask_add_ps(mantissa, small, mantissa, mantissa);
+    exponent = _mm512_mask_sub_ps(exponent, small, exponent, _mm512_set1_ps(1.0f));
+
+    const __m512 z = _mm512_sub_ps(mantissa, _mm512_set1_ps(1.0f));
+    __m512 p = _mm512_set1_ps(7.0376836292e-2f);
+    p = _mm512_add_ps(_mm512_mul_ps(p, z), _mm512_set1_ps(-1.1514610310e-1f));
+    p = _mm512_add_ps(_mm512_mul_ps(p, z), _mm512_set1_ps(1.1676998740e-1f));
+    p = _mm512_add_ps(_mm512_mul_ps(p, z), _mm512_set1_ps(-1.2420140846e-1f));
+    p = _mm512_add_ps(_mm512_mul_ps(p, z), _mm512_set1_ps(1.4249322787e-1f));
+    p = _mm512_add_ps(_mm512_mul_ps(p, z), _mm512_set1_ps(-1.6668057665e-1f));
+    p = _mm512_add_ps(_mm512_mul_ps(p, z), _mm512_set1_ps(2.0000714765e-1f));
+    p = _mm512_add_ps(_mm512_mul_ps(p, z), _mm512_set1_ps(-2.4999993993e-1f));
+    p = _mm512_add_ps(_mm512_mul_ps(p, z), _mm512_set1_ps(3.3333331174e-1f));
+    const __m512 z2 = _mm512_mul_ps(z, z);
+    p = _mm512_sub_ps(_mm512_mul_ps(_mm512_mul_ps(z2, z), p),
+                      _mm512_mul_ps(_mm512_set1_ps(0.5f), z2));
+
+    __m512 result = _mm512_add_ps(_mm512_mul_ps(_mm512_add_ps(z, p),
+                                                _mm512_set1_ps(FAST_MATH_LOG2E)),
+                                  exponent);
+    result = _mm512_mask_mov_ps(_mm512_set1_ps(NAN), positive, result);
+    result = _mm512_mask_mov_ps(result, isZero, _mm512_set1_ps(-INFINITY));
+    return _mm512_mask_mov_ps(result, isInf, _mm512_set1_ps(INFINITY));
+}
+#elif defined(__AVX2__)
+/**
+ * @brief approximation of log2 for 8 values
+ *
+ * @param value input-values
+ *
+ * @return log2 of the values
+ */
+inline __m256
+fastLog2(const __m256 value)
+{
+    const __m256 positive = _mm256_cmp_ps(value, _mm256_setzero_ps(), _CMP_GT_OQ);
+    const __m256 isZero = _mm256_cmp_ps(value, _mm256_setzero_ps(), _CMP_EQ_OQ);
+    const __m256 isInf = _mm256_cmp_ps(value, _mm256_set1_ps(INFINITY), _CMP_EQ_OQ);
+
+    // denormal values are scaled by 2^23 to get a normal exponent
+    const __m256 denormal = _mm256_cmp_ps(value, _mm256_set1_ps(FLT_MIN), _CMP_LT_OQ);
+    const __m256 normalized = _mm256_blendv_ps(value,
+                                               _mm256_mul_ps(value, _mm256_set1_ps(8388608.0f)),
+                                               denormal);
+
+    const __m256i bits = _mm256_castps_si256(normalized);
+    __m256 exponent = _mm256_cvtepi32_ps(_mm256_sub_epi32(_mm256_srli_epi32(bits, 23),
+                                                          _mm256_set1_epi32(126)));
+    exponent = _mm256_sub_ps(exponent, _mm256_and_ps(denormal, _mm256_set1_ps(23.0f)));
+    __m256 mantissa = _mm256_castsi256_ps(
+                _mm256_or_si256(_mm256_and_si256(bits, _mm256_set1_epi32(0x007fffff)),
+                                _mm256_set1_epi32(0x3f000000)));
+    const __m256 small = _mm256_cmp_ps(mantissa, _mm256_set1_ps(FAST_MATH_SQRT_HALF), _CMP_LT_OQ);
+    mantissa = _mm256_add_ps(mantissa, _mm256_and_ps(small, mantissa));
+    exponent = _mm256_sub_ps(exponent, _mm256_and_ps(small, _mm256_set1_ps(1.0f)));
+
+    const __m256 z = _mm256_sub_ps(mantissa, _mm256_set1_ps(1.0f));
+    __m256 p = _mm256_set1_ps(7.0376836292e-2f);
+    p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(-1.1514610310e-1f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(1.1676998740e-1f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(-1.2420140846e-1f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(1.4249322787e-1f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(-1.6668057665e-1f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(2.0000714765e-1f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(-2.4999993993e-1f));
+    p = _mm256_add_ps(_mm256_mul_ps(p, z), _mm256_set1_ps(3.3333331174e-1f));
+    const __m256 z2 = _mm256_mul_ps(z, z);
+    p = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(z2, z), p),
+                      _mm256_mul_ps(_mm256_set1_ps(0.5f), z2));
+
+    __m256 result = _mm256_add_ps(_mm256_mul_ps(_mm256_add_ps(z, p),
+                                                _mm256_set1_ps(FAST_MATH_LOG2E)),
+                                  exponent);
+    result = _mm256_blendv_ps(_mm256_set1_ps(NAN), result, positive);
+    result = _mm256_blendv_ps(result, _mm256_set1_ps(-INFINITY), isZero);
+    return _mm256_blendv_ps(result, _mm256_set1_ps(INFINITY), isInf);
+}
+#endif
+
+/**
+ * @brief replace all values of an array with log2(value + 1), which is the activation-function
+ *        of the neurons
+ *
+ * @param values array with the values
+ * @param numberOfValues number of values
+ * @param useFastMath true to use the approximation instead of the libm-function
+ */
+inline void
+applyLog2Activation(float* values,
+                    const uint32_t numberOfValues,
+                    const bool useFastMath)
+{
+    uint32_t i = 0;
+    if(useFastMath)
+    {
+#if defined(__AVX512F__)
+        for(; i + 16 <= numberOfValues; i += 16)
+        {
+            const __m512 value = _mm512_add_ps(_mm512_loadu_ps(&values[i]), _mm512_set1_ps(1.0f));
+            _mm512_storeu_ps(&values[i], fastLog2(value));
+        }
+#elif defined(__AVX2__)
+        for(; i + 8 <= numberOfValues; i += 8)
+        {
+            const __m256 value = _mm256_add_ps(_mm256_loadu_ps(&values[i]), _mm256_set1_ps(1.0f));
+            _mm256_storeu_ps(&values[i], fastLog2(value));
+        }
+#endif
+        for(; i < numberOfValues; i++) {
+            values[i] = fastLog2(values[i] + 1.0f);
+        }
+        return;
+    }
+
+    // there is no vector-instruction for log2, so this is done in a separate loop
+    for(; i < numberOfValues; i++) {
+        values[i] = log2(values[i] + 1.0f);
+    }
+}
+
+#endif // KYOUKOMIND_FAST_MATH_H
@@ -0,0 +1,165 @@
+/**
+ * @file        cluster_queue.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_CLUSTER_QUEUE_H
+#define KYOUKOMIND_CLUSTER_QUEUE_H
+
+#include <common.h>
+
+#include <core/processing/mpmc_ring.h>
+
+class AbstractSegment;
+
+/**
+ * @brief Sub-queue of a single cluster within the segment-queue with one lock-free ring for each
+ *        numa-node. Segments, which don't fit into a full ring, are stored in an unbounded
+ *        overflow-list, so the queue never drops a segment.
+ *        The virtual time is the processing-time of the cluster, scaled by its weight, and the
+ *        scheduler always serves the cluster with the lowest virtual time, so the clusters get
+ *        the cpu-time in relation to their weights, independent of the number of their
+ *        segments.
+ */
+struct ClusterQueue
+{
+    std::vector<MpmcRing<AbstractSegment*>*> rings;
+    std::atomic<uint64_t> numberOfSegments = {0};
+    std::atomic<uint64_t> virtualTime = {0};
+    std::atomic<uint32_t> weight = {DEFAULT_CLUSTER_WEIGHT};
+
+    // only used, while the rings are full, so the lock is not contended in the normal case
+    std::mutex overflowLock;
+    std::deque<AbstractSegment*> overflow;
+    std::atomic<uint64_t> numberOfOverflowSegments = {0};
+
+    // the scheduler skips sub-queues, which are not in use, so a released sub-queue can be
+    // drained, while other units still look at it
+    std::atomic<bool> inUse = {false};
+
+    // time between the queueing of the segments and the start of their processing
+    std::atomic<uint64_t> totalWaitTime = {0};
+    std::atomic<uint64_t> maxWaitTime = {0};
+    std::atomic<uint64_t> numberOfWaits = {0};
+
+    /**
+     * @brief destructor
+     */
+    ~ClusterQueue()
+    {
+        for(MpmcRing<AbstractSegment*>* ring : rings) {
+            delete ring;
+        }
+    }
+
+    /**
+     * @brief add a segment to the ring of a numa-node. The counter is increased before the
+     *        segment becomes visible in the ring, so a consumer can never decrease it below
+     *        zero and the check for an empty sub-queue is based on the counter alone. If the
+     *        ring is full, or the overflow-list is not empty yet, the segment is added to the
+     *        overflow-list, so the rings are drained before the overflow-list and no segment
+     *        waits there forever.
+     *
+     * @param segment segment to add
+     * @param nodePos position of the numa-node of the segment
+     *
+     * @return true, if the sub-queue was empty before, else false
+     */
+    bool
+    push(AbstractSegment* segment, uint32_t nodePos)
+    {
+        if(nodePos >= rings.size()) {
+            nodePos = 0;
+        }
+
+        const uint64_t oldNumber = numberOfSegments.fetch_add(1, std::memory_order_acq_rel);
+        if(numberOfOverflowSegments.load(std::memory_order_acquire) > 0
+                || rings[nodePos]->push(segment) == false)
+        {
+            std::lock_guard<std::mutex> guard(overflowLock);
+            overflow.push_back(segment);
+            numberOfOverflowSegments.store(overflow.size(), std::memory_order_release);
+        }
+
+        return oldNumber == 0;
+    }
+
+    /**
+     * @brief take a segment, where the ring of the preferred numa-node is checked at first and the
+     *        overflow-list at last
+     *
+     * @param preferredNumaNode position of the numa-node of the calling processing-unit
+     *
+     * @return nullptr, if the sub-queue is empty, else the segment
+     */
+    AbstractSegment*
+    pop(const uint32_t preferredNumaNode)
+    {
+        AbstractSegment* segment = nullptr;
+        const uint32_t numberOfRings = rings.size();
+
+        for(uint32_t i = 0; i < numberOfRings; i++)
+        {
+            const uint32_t nodePos = (preferredNumaNode + i) % numberOfRings;
+            if(rings[nodePos]->pop(segment))
+            {
+                numberOfSegments.fetch_sub(1, std::memory_order_acq_rel);
+                return segment;
+            }
+        }
+
+        if(numberOfOverflowSegments.load(std::memory_order_acquire) > 0)
+        {
+            std::lock_guard<std::mutex> guard(overflowLock);
+            if(overflow.size() > 0)
+            {
+                segment = overflow.front();
+                overflow.pop_front();
+                numberOfOverflowSegments.store(overflow.size(), std::memory_order_release);
+                numberOfSegments.fetch_sub(1, std::memory_order_acq_rel);
+                return segment;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /**
+     * @brief reset the sub-queue for a new cluster. Remaining segments are removed with pop, so
+     *        the counter stays consistent, even if another unit is still within pop on the same
+     *        sub-queue.
+     *
+     * @param newWeight weight of the new cluster
+     * @param startTime virtual time, where the new cluster starts
+     */
+    void
+    reset(const uint32_t newWeight, const uint64_t startTime)
+    {
+        while(pop(0) != nullptr) {}
+
+        virtualTime.store(startTime, std::memory_order_relaxed);
+        weight.store(newWeight, std::memory_order_relaxed);
+        totalWaitTime.store(0, std::memory_order_relaxed);
+        maxWaitTime.store(0, std::memory_order_relaxed);
+        numberOfWaits.store(0, std::memory_order_relaxed);
+    }
+};
+
+#endif // KYOUKOMIND_CLUSTER_QUEUE_H
@@ -30,8 +30,11 @@
 #include <core/processing/segment_queue.h>
 
 #include <kyouko_root.h>
+#include <core/processing/numa_topology.h>
 
 #include <core/segments/dynamic_segment/backpropagation.h>
+#include <core/segments/dynamic_segment/frozen_processing.h>
+#include <core/segments/dynamic_segment/batch_processing.h>
 #include <core/segments/dynamic_segment/processing.h>
 #include <core/segments/dynamic_segment/reduction.h>
 #include <core/segments/dynamic_segment/section_update.h>
@@ -48,9 +51,16 @@ uint32_t counter = 0;
 
 /**
  * @brief constructor
+ *
+ * @param numaNode position of the numa-node, whose segments are preferred by this unit
+ * @param coreId id of the cpu to pin the thread, -1 to pin it to the cpus of its numa-node
  */
-CpuProcessingUnit::CpuProcessingUnit()
-    : Kitsunemimi::Thread("CpuProcessingUnit") {}
+CpuProcessingUnit::CpuProcessingUnit(const uint32_t numaNode, const int coreId)
+    : Kitsunemimi::Thread("CpuProcessingUnit", coreId)
+{
+    m_numaNode = numaNode;
+    m_pinnedToCore = coreId >= 0;
+}
 
 /**
  * @brief destructor
@@ -75,10 +85,9 @@ CpuProcessingUnit::learnSegmentForward(AbstractSegment* segment)
             seg->dynamicSegmentSettings->doLearn = 1;
             seg->dynamicSegmentSettings->doLearn = 1;
             prcessDynamicSegment(*seg);
-            if(seg->dynamicSegmentSettings->updateSections != 0) {
+            if(seg->growthRequests.dirtySections.size() > 0) {
                 updateSections(*seg);
             }
-            seg->dynamicSegmentSettings->updateSections = 0;
 
             seg->dynamicSegmentSettings->doLearn = 0;
             break;
@@ -117,11 +126,7 @@ CpuProcessingUnit::learnSegmentBackward(AbstractSegment* segment)
         {
             DynamicSegment* seg = static_cast<DynamicSegment*>(segment);
             rewightDynamicSegment(*seg);
-            if(reductionCounter == 100) {
-                //reduceNeurons(*seg);
-                reductionCounter = 0;
-            }
-            reductionCounter++;
+            reduceNeurons(*seg);
             break;
         }
         case OUTPUT_SEGMENT:
@@ -145,12 +150,22 @@ CpuProcessingUnit::processSegment(AbstractSegment* segment)
 {
     Kitsunemimi::ErrorContainer error;
 
+    if(segment->parentCluster->batchSize > 1)
+    {
+        processSegmentBatch(segment);
+        return;
+    }
+
     switch(segment->getType())
     {
         case DYNAMIC_SEGMENT:
         {
             DynamicSegment* seg = static_cast<DynamicSegment*>(segment);
-            prcessDynamicSegment(*seg);
+            if(seg->parentCluster->isFrozen) {
+                processFrozenDynamicSegment(*seg);
+            } else {
+                prcessDynamicSegment(*seg);
+            }
             break;
         }
         case INPUT_SEGMENT:
@@ -192,6 +207,63 @@ CpuProcessingUnit::processSegment(AbstractSegment* segment)
     }
 }
 
+/**
+ * @brief process segments for all samples of a batch
+ *
+ * @param segment segment to process
+ */
+void
+CpuProcessingUnit::processSegmentBatch(AbstractSegment* segment)
+{
+    const uint32_t batchSize = segment->parentCluster->batchSize;
+
+    switch(segment->getType())
+    {
+        case DYNAMIC_SEGMENT:
+        {
+            DynamicSegment* seg = static_cast<DynamicSegment*>(segment);
+            processBatchDynamicSegment(*seg);
+            break;
+        }
+        case INPUT_SEGMENT:
+        {
+            InputSegment* seg = static_cast<InputSegment*>(segment);
+            prcessInputSegmentBatch(*seg);
+            break;
+        }
+        case OUTPUT_SEGMENT:
+        {
+            OutputSegment* seg = static_cast<OutputSegment*>(segment);
+            prcessOutputSegmentBatch(*seg);
+            if(seg->parentCluster->msgClient == nullptr)
+            {
+                Task* actualTask = seg->parentCluster->getActualTask();
+                for(uint32_t sample = 0; sample < batchSize; sample++)
+                {
+                    const uint64_t cycle = actualTask->actualCycle + sample;
+                    DataValue* value = actualTask->resultData->array[cycle]->toValue();
+                    if(actualTask->type == IMAGE_REQUEST_TASK)
+                    {
+                        const uint32_t hightest = getHighestOutput(*seg, sample);
+                        value->setValue(static_cast<long>(hightest));
+                    }
+                    else if(actualTask->type == TABLE_REQUEST_TASK)
+                    {
+                        float val = value->getFloat();
+                        for(uint64_t i = 0; i < seg->segmentHeader->outputs.count; i++) {
+                            val += seg->batchOutputs[i * batchSize + sample];
+                        }
+                        value->setValue(val);
+                    }
+                }
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
 /**
  * @brief run loop to process all available segments
  */
@@ -200,24 +272,33 @@ CpuProcessingUnit::run()
 {
     AbstractSegment* currentSegment = nullptr;
 
+    // the unit is the worker 0 of the pool of its numa-node
+    if(m_pinnedToCore == false
+            && KyoukoRoot::m_numaTopology != nullptr)
+    {
+        KyoukoRoot::m_numaTopology->pinCurrentThread(m_numaNode);
+    }
+
+    // without an own deque, the unit works only with the shared rings
+    if(KyoukoRoot::m_segmentQueue->registerWorker() == false) {
+        LOG_WARNING("no local segment-queue available for the processing-unit");
+    }
+
     while(m_abort == false)
     {
-        currentSegment = KyoukoRoot::m_segmentQueue->getSegmentFromQueue();
+        // sleeps until a segment is available, the timeout is only to check the abort-flag
+        currentSegment = KyoukoRoot::m_segmentQueue->waitForSegment(m_numaNode,
+                                                                    SEGMENT_QUEUE_WAIT_TIMEOUT);
         if(currentSegment != nullptr)
         {
-            // check if segment is ready, else requeue
-            if(currentSegment->isReady() == false)
-            {
-                KyoukoRoot::m_segmentQueue->addSegmentToQueue(currentSegment);
-                continue;
-            }
-
+            // segments are only queued, when all their inputs are ready
             // reset input ready status
             for(uint8_t side = 0; side < 16; side++) {
                 currentSegment->segmentSlots->slots[side].inputReady = false;
             }
 
             // handle type of processing
+            const chronoTimePoint start = chronoClock::now();
             Cluster* clusterInterface = currentSegment->parentCluster;
             if(clusterInterface->mode == Cluster::LEARN_FORWARD_MODE) {
                 learnSegmentForward(currentSegment);
@@ -227,15 +308,18 @@ CpuProcessingUnit::run()
                 processSegment(currentSegment);
             }
 
+            // charge the cluster for the scheduling, before the segment is given free again
+            const chronoNanoSec duration = std::chrono::duration_cast<chronoNanoSec>(
+                                               chronoClock::now() - start);
+            KyoukoRoot::m_segmentQueue->addProcessingTime(currentSegment,
+                                                          static_cast<uint64_t>(duration.count()));
+
             // finish segment by sharing border-buffer and register in cluster
             currentSegment->finishSegment();
         }
-        else
-        {
-            // if no segments are available then sleep
-            sleepThread(1000);
-        }
     }
+
+    KyoukoRoot::m_segmentQueue->unregisterWorker();
 }
 
 
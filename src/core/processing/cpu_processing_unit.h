@@ -32,7 +32,7 @@ class CpuProcessingUnit
         : public Kitsunemimi::Thread
 {
 public:
-    CpuProcessingUnit();
+    CpuProcessingUnit(const uint32_t numaNode, const int coreId = -1);
     ~CpuProcessingUnit();
 
 protected:
@@ -40,11 +40,13 @@ protected:
 
 
 private:
-    uint64_t reductionCounter = 0;
+    uint32_t m_numaNode = 0;
+    bool m_pinnedToCore = false;
 
     void learnSegmentForward(AbstractSegment* segment);
     void learnSegmentBackward(AbstractSegment *segment);
     void processSegment(AbstractSegment* segment);
+    void processSegmentBatch(AbstractSegment* segment);
 };
 
 #endif // KYOUKOMIND_CPU_PROCESSING_UNIT_H
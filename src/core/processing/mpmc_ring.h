@@ -0,0 +1,160 @@
+/**
+ * @file        mpmc_ring.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+
+#ifndef KYOUKOMIND_MPMC_RING_H
+#define KYOUKOMIND_MPMC_RING_H
+
+#include <common.h>
+
+/**
+ * @brief Bounded lock-free ring for multiple producers and multiple consumers. Each slot has its
+ *        own sequence-number, which tells if the slot is free for the producer of the current
+ *        round or filled for the consumer of the current round. So producers and consumers only
+ *        compete for their own position-counter and never block each other.
+ */
+template<typename T>
+class MpmcRing
+{
+public:
+    /**
+     * @brief constructor
+     *
+     * @param capacity minimum number of entries, which is rounded up to the next power of two
+     */
+    MpmcRing(const uint32_t capacity)
+    {
+        uint32_t size = 2;
+        while(size < capacity) {
+            size <<= 1;
+        }
+
+        m_mask = size - 1;
+        m_slots = new Slot[size];
+        for(uint32_t i = 0; i < size; i++) {
+            m_slots[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+
+    /**
+     * @brief destructor
+     */
+    ~MpmcRing()
+    {
+        delete[] m_slots;
+    }
+
+    MpmcRing(const MpmcRing&) = delete;
+    MpmcRing& operator=(const MpmcRing&) = delete;
+
+    /**
+     * @brief add a new entry at the end of the ring
+     *
+     * @param value value to add
+     *
+     * @return false, if the ring is full, else true
+     */
+    bool
+    push(const T &value)
+    {
+        uint64_t pos = m_pushPos.load(std::memory_order_relaxed);
+        while(true)
+        {
+            Slot* slot = &m_slots[pos & m_mask];
+            const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos);
+            if(diff == 0)
+            {
+                // try to take the slot, else pos is updated to the actual position
+                if(m_pushPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    slot->value = value;
+                    slot->sequence.store(pos + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(diff < 0)
+            {
+                // the slot still holds the entry of the last round
+                return false;
+            }
+            else
+            {
+                pos = m_pushPos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+    /**
+     * @brief take the first entry of the ring
+     *
+     * @param value reference for the output of the entry
+     *
+     * @return false, if the ring is empty, else true
+     */
+    bool
+    pop(T &value)
+    {
+        uint64_t pos = m_popPos.load(std::memory_order_relaxed);
+        while(true)
+        {
+            Slot* slot = &m_slots[pos & m_mask];
+            const uint64_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const int64_t diff = static_cast<int64_t>(sequence) - static_cast<int64_t>(pos + 1);
+            if(diff == 0)
+            {
+                if(m_popPos.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+                {
+                    value = slot->value;
+                    slot->sequence.store(pos + m_mask + 1, std::memory_order_release);
+                    return true;
+                }
+            }
+            else if(diff < 0)
+            {
+                // the slot was not filled in this round
+                return false;
+            }
+            else
+            {
+                pos = m_popPos.load(std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Slot
+    {
+        std::atomic<uint64_t> sequence;
+        T value;
+    };
+
+    Slot* m_slots = nullptr;
+    uint64_t m_mask = 0;
+
+    // the counters are placed on their own cache-lines, so producers and consumers don't
+    // invalidate the cache-line of each other
+    alignas(64) std::atomic<uint64_t> m_pushPos = {0};
+    alignas(64) std::atomic<uint64_t> m_popPos = {0};
+};
+
+#endif // KYOUKOMIND_MPMC_RING_H
@@ -0,0 +1,323 @@
+/**
+ * @file        numa_topology.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "numa_topology.h"
+
+#include <sched.h>
+#include <sys/syscall.h>
+
+#include <libKitsunemimiCommon/logger.h>
+
+// values of the mbind-syscall, because the numa-library is not a dependency of this project
+#define KYOUKO_MPOL_PREFERRED 1
+#define KYOUKO_MPOL_MF_MOVE (1 << 1)
+
+/**
+ * @brief constructor
+ */
+NumaTopology::NumaTopology()
+{
+    m_nextNode = 0;
+
+    // default without numa-support is a single node with all cpus
+    NumaNode defaultNode;
+    getAvailableCpus(defaultNode.cpuIds);
+    m_nodes.push_back(defaultNode);
+}
+
+/**
+ * @brief get the cpus, which are available for the process. Within a container or with a
+ *        cpuset, these are less than the cpus of the host.
+ *
+ * @param cpuIds reference for the resulting ids of the cpus
+ */
+void
+NumaTopology::getAvailableCpus(std::vector<uint32_t> &cpuIds)
+{
+    cpuIds.clear();
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    if(sched_getaffinity(0, sizeof(cpu_set_t), &cpuSet) == 0)
+    {
+        for(uint32_t cpuId = 0; cpuId < CPU_SETSIZE; cpuId++)
+        {
+            if(CPU_ISSET(cpuId, &cpuSet)) {
+                cpuIds.push_back(cpuId);
+            }
+        }
+    }
+
+    // fallback, if the affinity of the process can not be read
+    if(cpuIds.size() == 0)
+    {
+        for(uint32_t i = 0; i < std::max(std::thread::hardware_concurrency(), 1u); i++) {
+            cpuIds.push_back(i);
+        }
+    }
+}
+
+/**
+ * @brief read the numa-nodes and their cpus from the sysfs. The cpus of the nodes are filtered
+ *        by the cpus, which are available for the process, so threads are never pinned to
+ *        cpus outside of its cpuset.
+ *
+ * @return true, if more than one node with available cpus was found, else false
+ */
+bool
+NumaTopology::readTopology()
+{
+    std::vector<NumaNode> nodes;
+    std::vector<uint32_t> availableCpus;
+    getAvailableCpus(availableCpus);
+
+    DIR* dir = opendir("/sys/devices/system/node");
+    if(dir == nullptr) {
+        return false;
+    }
+
+    struct dirent* entry = nullptr;
+    while((entry = readdir(dir)) != nullptr)
+    {
+        const std::string name = entry->d_name;
+        if(name.size() <= 4
+                || name.compare(0, 4, "node") != 0
+                || isdigit(name.at(4)) == 0)
+        {
+            continue;
+        }
+
+        NumaNode node;
+        node.nodeId = static_cast<uint32_t>(std::stoul(name.substr(4)));
+
+        std::ifstream cpuListFile("/sys/devices/system/node/" + name + "/cpulist");
+        std::string cpuList;
+        std::getline(cpuListFile, cpuList);
+
+        if(parseCpuList(cpuList, node.cpuIds) == false) {
+            continue;
+        }
+
+        // remove the cpus, which are not allowed for the process
+        const auto notAvailable = [&](const uint32_t cpuId) {
+            return std::find(availableCpus.begin(), availableCpus.end(), cpuId)
+                   == availableCpus.end();
+        };
+        node.cpuIds.erase(std::remove_if(node.cpuIds.begin(), node.cpuIds.end(), notAvailable),
+                          node.cpuIds.end());
+
+        // nodes without available cpus, like pure memory-nodes, are not used
+        if(node.cpuIds.size() > 0) {
+            nodes.push_back(node);
+        }
+    }
+    closedir(dir);
+
+    if(nodes.size() <= 1) {
+        return false;
+    }
+
+    std::sort(nodes.begin(), nodes.end(),
+              [](const NumaNode &a, const NumaNode &b) { return a.nodeId < b.nodeId; });
+    m_nodes = nodes;
+
+    return true;
+}
+
+/**
+ * @brief parse a cpu-list of the sysfs like "0-7,16-23"
+ *
+ * @param cpuList string with the list
+ * @param cpuIds reference for the resulting ids of the cpus
+ *
+ * @return false, if the list is invalid, else true
+ */
+bool
+NumaTopology::parseCpuList(const std::string &cpuList,
+                           std::vector<uint32_t> &cpuIds)
+{
+    std::stringstream stream(cpuList);
+    std::string part;
+
+    while(std::getline(stream, part, ','))
+    {
+        if(part.size() == 0) {
+            continue;
+        }
+
+        const size_t dashPos = part.find('-');
+        char* end = nullptr;
+        const uint32_t first = static_cast<uint32_t>(strtoul(part.c_str(), &end, 10));
+        uint32_t last = first;
+        if(dashPos != std::string::npos) {
+            last = static_cast<uint32_t>(strtoul(part.c_str() + dashPos + 1, &end, 10));
+        }
+
+        if(end == part.c_str()
+                || last < first)
+        {
+            return false;
+        }
+
+        for(uint32_t cpuId = first; cpuId <= last; cpuId++) {
+            cpuIds.push_back(cpuId);
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief get number of usable numa-nodes
+ *
+ * @return number of nodes, at least 1
+ */
+uint32_t
+NumaTopology::getNumberOfNodes() const
+{
+    return static_cast<uint32_t>(m_nodes.size());
+}
+
+/**
+ * @brief get a numa-node
+ *
+ * @param nodePos position of the node within the list of the nodes
+ *
+ * @return node
+ */
+const NumaNode&
+NumaTopology::getNode(const uint32_t nodePos) const
+{
+    return m_nodes.at(nodePos % m_nodes.size());
+}
+
+/**
+ * @brief get the node for the next new segment
+ *
+ * @return position of the node within the list of the nodes
+ */
+uint32_t
+NumaTopology::getNextNode()
+{
+    return m_nextNode.fetch_add(1) % static_cast<uint32_t>(m_nodes.size());
+}
+
+/**
+ * @brief get the node, which contains a cpu
+ *
+ * @param cpuId id of the cpu
+ *
+ * @return position of the node within the list of the nodes, 0 if the cpu is unknown
+ */
+uint32_t
+NumaTopology::getNodeOfCpu(const uint32_t cpuId) const
+{
+    for(uint32_t nodePos = 0; nodePos < m_nodes.size(); nodePos++)
+    {
+        const std::vector<uint32_t> &cpuIds = m_nodes.at(nodePos).cpuIds;
+        if(std::find(cpuIds.begin(), cpuIds.end(), cpuId) != cpuIds.end()) {
+            return nodePos;
+        }
+    }
+
+    return 0;
+}
+
+/**
+ * @brief bind the pages of a memory-region to a numa-node. Pages, which are already in use, are
+ *        moved to the node. Only the pages, which are completely within the region, are bound,
+ *        to not affect the memory of other objects.
+ *
+ * @param data pointer to the memory-region
+ * @param size size of the memory-region in bytes
+ * @param nodePos position of the node within the list of the nodes
+ *
+ * @return true, if successful or not necessary, else false
+ */
+bool
+NumaTopology::bindMemory(void* data,
+                         const uint64_t size,
+                         const uint32_t nodePos) const
+{
+    if(m_nodes.size() <= 1
+            || data == nullptr)
+    {
+        return true;
+    }
+
+    const uint64_t pageSize = static_cast<uint64_t>(sysconf(_SC_PAGESIZE));
+    const uint64_t start = (reinterpret_cast<uint64_t>(data) + pageSize - 1) & ~(pageSize - 1);
+    const uint64_t end = (reinterpret_cast<uint64_t>(data) + size) & ~(pageSize - 1);
+    if(end <= start) {
+        return true;
+    }
+
+    // the kernel expects the max-node one higher than the number of bits of the node-mask
+    const uint32_t nodeId = getNode(nodePos).nodeId;
+    const uint32_t bitsPerWord = 8 * sizeof(unsigned long);
+    std::vector<unsigned long> nodeMask((nodeId / bitsPerWord) + 1, 0);
+    nodeMask[nodeId / bitsPerWord] |= 1ul << (nodeId % bitsPerWord);
+
+    const long ret = syscall(SYS_mbind,
+                             start,
+                             end - start,
+                             KYOUKO_MPOL_PREFERRED,
+                             nodeMask.data(),
+                             nodeMask.size() * bitsPerWord + 1,
+                             KYOUKO_MPOL_MF_MOVE);
+    if(ret != 0)
+    {
+        LOG_WARNING("failed to bind memory to numa-node " + std::to_string(nodeId));
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief pin the calling thread to the cpus of a numa-node
+ *
+ * @param nodePos position of the node within the list of the nodes
+ *
+ * @return true, if successful or not necessary, else false
+ */
+bool
+NumaTopology::pinCurrentThread(const uint32_t nodePos) const
+{
+    if(m_nodes.size() <= 1) {
+        return true;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+    for(const uint32_t cpuId : getNode(nodePos).cpuIds) {
+        CPU_SET(cpuId, &cpuSet);
+    }
+
+    if(sched_setaffinity(0, sizeof(cpu_set_t), &cpuSet) != 0)
+    {
+        LOG_WARNING("failed to pin thread to numa-node " + std::to_string(getNode(nodePos).nodeId));
+        return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,64 @@
+/**
+ * @file        numa_topology.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_NUMA_TOPOLOGY_H
+#define KYOUKOMIND_NUMA_TOPOLOGY_H
+
+#include <common.h>
+
+struct NumaNode
+{
+    uint32_t nodeId = 0;
+    std::vector<uint32_t> cpuIds;
+};
+
+/**
+ * @brief NUMA-nodes of the host. New segments are placed round-robin on the nodes and their
+ *        memory is bound to the node, so they can be processed by the worker-threads, which are
+ *        pinned to the cpus of the same node. On hosts with only one node, or when the topology
+ *        can not be read, all segments are placed on node 0 and nothing is bound or pinned.
+ */
+class NumaTopology
+{
+public:
+    NumaTopology();
+
+    bool readTopology();
+
+    uint32_t getNumberOfNodes() const;
+    const NumaNode& getNode(const uint32_t nodePos) const;
+    uint32_t getNextNode();
+
+    uint32_t getNodeOfCpu(const uint32_t cpuId) const;
+
+    bool bindMemory(void* data, const uint64_t size, const uint32_t nodePos) const;
+    bool pinCurrentThread(const uint32_t nodePos) const;
+
+    static bool parseCpuList(const std::string &cpuList, std::vector<uint32_t> &cpuIds);
+    static void getAvailableCpus(std::vector<uint32_t> &cpuIds);
+
+private:
+    std::vector<NumaNode> m_nodes;
+    std::atomic<uint32_t> m_nextNode;
+};
+
+#endif // KYOUKOMIND_NUMA_TOPOLOGY_H
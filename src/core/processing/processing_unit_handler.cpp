@@ -22,6 +22,11 @@
 
 #include <core/processing/processing_unit_handler.h>
 #include <core/processing/cpu_processing_unit.h>
+#include <core/processing/numa_topology.h>
+
+#include <kyouko_root.h>
+
+#include <libKitsunemimiCommon/logger.h>
 
 /**
  * @brief constructor
@@ -37,19 +42,112 @@ ProcessingUnitHandler::~ProcessingUnitHandler() {}
  * @brief init processing-threads
  *
  * @param numberOfThreads number of threads to create
+ * @param cpuIds list of cpus to pin the threads, empty to pin each thread to its numa-node
+ *
+ * @return false, if the number of threads is 0, else true
+ */
+bool
+ProcessingUnitHandler::initProcessingUnits(const uint32_t numberOfThreads,
+                                           const std::vector<uint32_t> &cpuIds)
+{
+    std::lock_guard<std::mutex> guard(m_unitLock);
+
+    if(numberOfThreads == 0) {
+        return false;
+    }
+
+    m_cpuIds = cpuIds;
+    while(m_processingUnits.size() < numberOfThreads) {
+        addProcessingUnit();
+    }
+
+    return true;
+}
+
+/**
+ * @brief get the numa-node of a processing-unit. The units are distributed round-robin over
+ *        the cpus of the list, or over the numa-nodes, if there is no list.
+ *
+ * @param unitPos position of the unit
+ * @param cpuIds list of cpus to pin the units, empty to pin each unit to its numa-node
+ * @param coreId reference for the cpu to pin the unit, -1 if it is pinned to its numa-node
+ *
+ * @return position of the numa-node of the unit
+ */
+uint32_t
+ProcessingUnitHandler::getNodeOfUnit(const uint32_t unitPos,
+                                     const std::vector<uint32_t> &cpuIds,
+                                     int &coreId)
+{
+    coreId = -1;
+    if(cpuIds.size() == 0) {
+        return unitPos % KyoukoRoot::m_numaTopology->getNumberOfNodes();
+    }
+
+    const uint32_t cpuId = cpuIds.at(unitPos % cpuIds.size());
+    coreId = static_cast<int>(cpuId);
+    return KyoukoRoot::m_numaTopology->getNodeOfCpu(cpuId);
+}
+
+/**
+ * @brief create and start a new processing-unit
+ */
+void
+ProcessingUnitHandler::addProcessingUnit()
+{
+    const uint32_t unitPos = static_cast<uint32_t>(m_processingUnits.size());
+
+    int coreId = -1;
+    const uint32_t numaNode = getNodeOfUnit(unitPos, m_cpuIds, coreId);
+    CpuProcessingUnit* newUnit = new CpuProcessingUnit(numaNode, coreId);
+    m_processingUnits.push_back(newUnit);
+    newUnit->startThread();
+}
+
+/**
+ * @brief change the number of processing-units at runtime. Removed units finish their actual
+ *        segment, before they stop.
+ *
+ * @param numberOfThreads new number of threads
  *
- * @return always true
+ * @return false, if the number of threads is 0 or too big, else true
  */
 bool
-ProcessingUnitHandler::initProcessingUnits(const uint16_t numberOfThreads)
+ProcessingUnitHandler::resizeProcessingUnits(const uint32_t numberOfThreads)
 {
-    // init cpu
-    for(uint16_t i = 0; i < numberOfThreads; i++)
+    std::lock_guard<std::mutex> guard(m_unitLock);
+
+    if(numberOfThreads == 0
+            || numberOfThreads > MAX_NUMBER_OF_PROCESSING_UNITS)
+    {
+        return false;
+    }
+
+    while(m_processingUnits.size() < numberOfThreads) {
+        addProcessingUnit();
+    }
+
+    while(m_processingUnits.size() > numberOfThreads)
     {
-        CpuProcessingUnit* newUnit = new CpuProcessingUnit();
-        m_processingUnits.push_back(newUnit);
-        newUnit->startThread();
+        // the thread is deleted by the thread-handler, after it left its loop
+        CpuProcessingUnit* unit = m_processingUnits.back();
+        m_processingUnits.pop_back();
+        unit->scheduleThreadForDeletion();
     }
 
+    LOG_INFO("number of processing-threads: " + std::to_string(numberOfThreads));
+
     return true;
 }
+
+/**
+ * @brief get the actual number of processing-units
+ *
+ * @return number of units
+ */
+uint32_t
+ProcessingUnitHandler::getNumberOfProcessingUnits()
+{
+    std::lock_guard<std::mutex> guard(m_unitLock);
+    return static_cast<uint32_t>(m_processingUnits.size());
+}
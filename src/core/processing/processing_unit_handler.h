@@ -27,16 +27,32 @@
 
 class CpuProcessingUnit;
 
+/**
+ * @brief Pool of the processing-units, which take the segments from the segment-queue. The size
+ *        of the pool can be changed at runtime. With a list of cpus, each unit is pinned to one
+ *        cpu of the list, else each unit is pinned to the cpus of its numa-node.
+ */
 class ProcessingUnitHandler
 {
 public:
     ProcessingUnitHandler();
     ~ProcessingUnitHandler();
 
-    bool initProcessingUnits(const uint16_t numberOfThreads);
+    bool initProcessingUnits(const uint32_t numberOfThreads,
+                             const std::vector<uint32_t> &cpuIds = {});
+    bool resizeProcessingUnits(const uint32_t numberOfThreads);
+    uint32_t getNumberOfProcessingUnits();
+
+    static uint32_t getNodeOfUnit(const uint32_t unitPos,
+                                  const std::vector<uint32_t> &cpuIds,
+                                  int &coreId);
 
 private:
+    std::mutex m_unitLock;
     std::vector<CpuProcessingUnit*> m_processingUnits;
+    std::vector<uint32_t> m_cpuIds;
+
+    void addProcessingUnit();
 };
 
 #endif // KYOUKOMIND_PROCESSING_UNIT_HANDLER_H
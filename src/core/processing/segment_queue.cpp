@@ -23,11 +23,470 @@
 #include "segment_queue.h"
 
 #include <core/segments/abstract_segment.h>
+#include <core/cluster/cluster.h>
+
+thread_local int32_t SegmentQueue::s_workerDequeId = -1;
+
+/**
+ * @brief get the actual time for the wait-time of the segments
+ *
+ * @return time in nanoseconds
+ */
+static uint64_t
+getTimeStamp()
+{
+    const chronoNanoSec time = std::chrono::duration_cast<chronoNanoSec>(
+                                   chronoClock::now().time_since_epoch());
+    return static_cast<uint64_t>(time.count());
+}
+
+/**
+ * @brief raise an atomic value to a new value, if the new value is bigger
+ *
+ * @param value atomic value to update
+ * @param newValue new value
+ */
+static void
+raiseValue(std::atomic<uint64_t> &value, const uint64_t newValue)
+{
+    uint64_t oldValue = value.load(std::memory_order_relaxed);
+    while(oldValue < newValue
+          && value.compare_exchange_weak(oldValue, newValue, std::memory_order_relaxed) == false)
+    {}
+}
 
 /**
  * @brief constructor
+ *
+ * @param numberOfNodes number of numa-nodes, where each node gets its own ring in each sub-queue
+ * @param defaultClusterWeight weight of new registered clusters
+ */
+SegmentQueue::SegmentQueue(const uint32_t numberOfNodes,
+                           const uint32_t defaultClusterWeight)
+{
+    m_numberOfNodes = std::max(numberOfNodes, 1u);
+    m_defaultClusterWeight = std::clamp<uint32_t>(defaultClusterWeight, 1, MAX_CLUSTER_WEIGHT);
+
+    m_clusterQueues = new ClusterQueue[MAX_NUMBER_OF_CLUSTER_QUEUES];
+    m_workerDeques = new WorkerDeque[MAX_NUMBER_OF_PROCESSING_UNITS];
+
+    // the shared sub-queue is always in use
+    ClusterQueue* sharedQueue = &m_clusterQueues[0];
+    for(uint32_t i = 0; i < m_numberOfNodes; i++) {
+        sharedQueue->rings.push_back(new MpmcRing<AbstractSegment*>(SEGMENT_QUEUE_SIZE));
+    }
+    sharedQueue->reset(m_defaultClusterWeight, 0);
+    sharedQueue->inUse.store(true, std::memory_order_release);
+}
+
+/**
+ * @brief destructor
+ */
+SegmentQueue::~SegmentQueue()
+{
+    delete[] m_clusterQueues;
+    delete[] m_workerDeques;
+}
+
+/**
+ * @brief register a new cluster with its own sub-queue. The rings of a sub-queue are kept, when
+ *        the cluster is removed, so they are reused by the next cluster.
+ *
+ * @return id of the sub-queue of the cluster, which is 0 for the shared sub-queue, if all
+ *         sub-queues are already in use
+ */
+uint32_t
+SegmentQueue::registerCluster()
+{
+    std::lock_guard<std::mutex> guard(m_registerLock);
+
+    for(uint32_t i = 1; i < MAX_NUMBER_OF_CLUSTER_QUEUES; i++)
+    {
+        ClusterQueue* clusterQueue = &m_clusterQueues[i];
+        if(clusterQueue->inUse.load(std::memory_order_acquire) == false)
+        {
+            if(clusterQueue->rings.size() == 0)
+            {
+                for(uint32_t node = 0; node < m_numberOfNodes; node++)
+                {
+                    MpmcRing<AbstractSegment*>* ring =
+                            new MpmcRing<AbstractSegment*>(SEGMENT_QUEUE_SIZE);
+                    clusterQueue->rings.push_back(ring);
+                }
+            }
+
+            // a new cluster starts at the actual virtual time, so it doesn't get more than its
+            // share because of the time, where it didn't exist
+            clusterQueue->reset(m_defaultClusterWeight,
+                                m_virtualTime.load(std::memory_order_relaxed));
+            clusterQueue->inUse.store(true, std::memory_order_release);
+            if(i >= m_numberOfClusterQueues.load(std::memory_order_relaxed)) {
+                m_numberOfClusterQueues.store(i + 1, std::memory_order_release);
+            }
+            return i;
+        }
+    }
+
+    LOG_WARNING("no own sub-queue available for the cluster, so it uses the shared sub-queue");
+    return 0;
+}
+
+/**
+ * @brief unregister a cluster, release its sub-queue and remove all of its segments, which are
+ *        still queued, also from the deques of the processing-units. This has to be done, before
+ *        the segments of the cluster are deleted, because otherwise a processing-unit could take
+ *        a segment of the deleted cluster.
+ *
+ * @param cluster cluster to unregister
+ */
+void
+SegmentQueue::unregisterCluster(const Cluster* cluster)
+{
+    std::lock_guard<std::mutex> guard(m_registerLock);
+
+    // remove the segments of the cluster from the deques of all processing-units
+    const uint32_t numberOfDeques = m_numberOfWorkerDeques.load(std::memory_order_acquire);
+    for(uint32_t i = 0; i < numberOfDeques; i++)
+    {
+        WorkerDeque* workerDeque = &m_workerDeques[i];
+        std::lock_guard<std::mutex> dequeGuard(workerDeque->lock);
+        std::deque<AbstractSegment*> &segments = workerDeque->segments;
+        segments.erase(std::remove_if(segments.begin(),
+                                      segments.end(),
+                                      [cluster](const AbstractSegment* segment) {
+                                          return segment->parentCluster == cluster;
+                                      }),
+                       segments.end());
+        workerDeque->numberOfSegments.store(segments.size(), std::memory_order_release);
+    }
+
+    const uint32_t clusterQueueId = cluster->schedulingQueueId;
+    if(clusterQueueId > 0
+            && clusterQueueId < MAX_NUMBER_OF_CLUSTER_QUEUES)
+    {
+        // release the sub-queue at first, so the scheduler doesn't select it anymore
+        ClusterQueue* clusterQueue = &m_clusterQueues[clusterQueueId];
+        clusterQueue->inUse.store(false, std::memory_order_release);
+        clusterQueue->reset(m_defaultClusterWeight, 0);
+        return;
+    }
+
+    // the shared sub-queue is used by other clusters too, so only the segments of this cluster
+    // are removed and the segments of the other clusters are added again
+    ClusterQueue* sharedQueue = &m_clusterQueues[0];
+    const uint64_t numberOfSegments = sharedQueue->numberOfSegments.load(std::memory_order_acquire);
+    std::vector<AbstractSegment*> otherSegments;
+    for(uint64_t i = 0; i < numberOfSegments; i++)
+    {
+        AbstractSegment* segment = sharedQueue->pop(0);
+        if(segment == nullptr) {
+            break;
+        }
+        if(segment->parentCluster != cluster) {
+            otherSegments.push_back(segment);
+        }
+    }
+
+    for(AbstractSegment* segment : otherSegments) {
+        pushSegment(segment);
+    }
+    wakeUpUnits(otherSegments.size());
+}
+
+/**
+ * @brief set the weight of a cluster for the scheduling
+ *
+ * @param clusterQueueId id of the sub-queue of the cluster
+ * @param weight new weight
+ *
+ * @return false, if the cluster has no own sub-queue or the weight is invalid, else true
+ */
+bool
+SegmentQueue::setClusterWeight(const uint32_t clusterQueueId, const uint32_t weight)
+{
+    if(clusterQueueId == 0
+            || clusterQueueId >= MAX_NUMBER_OF_CLUSTER_QUEUES
+            || weight == 0
+            || weight > MAX_CLUSTER_WEIGHT)
+    {
+        return false;
+    }
+
+    m_clusterQueues[clusterQueueId].weight.store(weight, std::memory_order_relaxed);
+    return true;
+}
+
+/**
+ * @brief get the weight of a cluster for the scheduling
+ *
+ * @param clusterQueueId id of the sub-queue of the cluster
+ *
+ * @return weight of the cluster
+ */
+uint32_t
+SegmentQueue::getClusterWeight(const uint32_t clusterQueueId)
+{
+    if(clusterQueueId >= MAX_NUMBER_OF_CLUSTER_QUEUES) {
+        return 0;
+    }
+
+    return m_clusterQueues[clusterQueueId].weight.load(std::memory_order_relaxed);
+}
+
+/**
+ * @brief get the time, which the segments of a cluster had to wait in the queue, since the
+ *        registration of the cluster
+ *
+ * @param clusterQueueId id of the sub-queue of the cluster
+ * @param averageWaitTime reference for the average wait-time in microseconds
+ * @param maxWaitTime reference for the maximum wait-time in microseconds
+ */
+void
+SegmentQueue::getClusterWaitTime(const uint32_t clusterQueueId,
+                                 uint64_t &averageWaitTime,
+                                 uint64_t &maxWaitTime)
+{
+    averageWaitTime = 0;
+    maxWaitTime = 0;
+    if(clusterQueueId >= MAX_NUMBER_OF_CLUSTER_QUEUES) {
+        return;
+    }
+
+    const ClusterQueue* clusterQueue = &m_clusterQueues[clusterQueueId];
+    const uint64_t numberOfWaits = clusterQueue->numberOfWaits.load(std::memory_order_relaxed);
+    if(numberOfWaits > 0)
+    {
+        const uint64_t totalWaitTime = clusterQueue->totalWaitTime.load(std::memory_order_relaxed);
+        averageWaitTime = totalWaitTime / numberOfWaits / 1000;
+    }
+    maxWaitTime = clusterQueue->maxWaitTime.load(std::memory_order_relaxed) / 1000;
+}
+
+/**
+ * @brief add the time of a processed segment to the virtual time of its cluster, scaled by
+ *        the weight of the cluster
+ *
+ * @param segment processed segment
+ * @param processingTime time in nanoseconds, which was necessary to process the segment
+ */
+void
+SegmentQueue::addProcessingTime(AbstractSegment* segment, const uint64_t processingTime)
+{
+    ClusterQueue* clusterQueue = getClusterQueue(segment);
+    const uint64_t weight = clusterQueue->weight.load(std::memory_order_relaxed);
+    const uint64_t scaledTime = (processingTime * DEFAULT_CLUSTER_WEIGHT) / weight;
+    clusterQueue->virtualTime.fetch_add(scaledTime, std::memory_order_relaxed);
+}
+
+/**
+ * @brief get the sub-queue of the cluster of a segment
+ *
+ * @param segment segment, which belongs to the cluster
+ *
+ * @return pointer to the sub-queue
  */
-SegmentQueue::SegmentQueue() {}
+ClusterQueue*
+SegmentQueue::getClusterQueue(const AbstractSegment* segment)
+{
+    const uint32_t clusterQueueId = segment->parentCluster->schedulingQueueId;
+    if(clusterQueueId >= MAX_NUMBER_OF_CLUSTER_QUEUES) {
+        return &m_clusterQueues[0];
+    }
+
+    return &m_clusterQueues[clusterQueueId];
+}
+
+/**
+ * @brief register the calling thread as processing-unit with its own deque
+ *
+ * @return false, if all deques are already in use, else true
+ */
+bool
+SegmentQueue::registerWorker()
+{
+    std::lock_guard<std::mutex> guard(m_registerLock);
+
+    for(uint32_t i = 0; i < MAX_NUMBER_OF_PROCESSING_UNITS; i++)
+    {
+        if(m_workerDeques[i].inUse == false)
+        {
+            m_workerDeques[i].inUse = true;
+            s_workerDequeId = static_cast<int32_t>(i);
+            if(i >= m_numberOfWorkerDeques.load(std::memory_order_relaxed)) {
+                m_numberOfWorkerDeques.store(i + 1, std::memory_order_release);
+            }
+            return true;
+        }
+    }
+
+    return false;
+}
+
+/**
+ * @brief unregister the calling thread. Segments, which are still in its deque, are moved into
+ *        the sub-queues of their clusters, so they are not lost, when a processing-unit is
+ *        removed.
+ */
+void
+SegmentQueue::unregisterWorker()
+{
+    if(s_workerDequeId < 0) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> guard(m_registerLock);
+
+    WorkerDeque* workerDeque = &m_workerDeques[s_workerDequeId];
+    uint64_t numberOfSegments = 0;
+    AbstractSegment* segment = nullptr;
+    while((segment = workerDeque->steal()) != nullptr)
+    {
+        pushSegment(segment);
+        numberOfSegments++;
+    }
+
+    workerDeque->inUse = false;
+    s_workerDequeId = -1;
+
+    wakeUpUnits(numberOfSegments);
+}
+
+/**
+ * @brief add a segment to the sub-queue of its cluster. A segment is never dropped, because a
+ *        segment, which is not processed, would block the cycle of its cluster forever. So if
+ *        the rings are full, for example of the shared sub-queue, the sub-queue stores the
+ *        segment in its overflow-list.
+ *
+ * @param segment segment to add
+ */
+void
+SegmentQueue::pushSegment(AbstractSegment* segment)
+{
+    ClusterQueue* clusterQueue = getClusterQueue(segment);
+    if(clusterQueue->push(segment, segment->numaNode))
+    {
+        // a cluster, which was idle, starts at the actual virtual time again, so it can not
+        // save up processing-time, while it has nothing to do
+        raiseValue(clusterQueue->virtualTime, m_virtualTime.load(std::memory_order_relaxed));
+    }
+}
+
+/**
+ * @brief take the segment from the sub-queue of the cluster with the lowest virtual time
+ *
+ * @param preferredNumaNode position of the numa-node of the calling processing-unit
+ *
+ * @return nullptr, if all sub-queues are empty, else the segment
+ */
+AbstractSegment*
+SegmentQueue::popFromClusterQueues(const uint32_t preferredNumaNode)
+{
+    AbstractSegment* result = nullptr;
+
+    // the selected sub-queue can be emptied by another unit in the meantime, so try again
+    const uint32_t numberOfQueues = m_numberOfClusterQueues.load(std::memory_order_acquire);
+    for(uint32_t i = 0; i < numberOfQueues; i++)
+    {
+        ClusterQueue* clusterQueue = selectClusterQueue();
+        if(clusterQueue == nullptr) {
+            return nullptr;
+        }
+
+        result = clusterQueue->pop(preferredNumaNode);
+        if(result != nullptr)
+        {
+            raiseValue(m_virtualTime, clusterQueue->virtualTime.load(std::memory_order_relaxed));
+            return result;
+        }
+    }
+
+    return nullptr;
+}
+
+/**
+ * @brief select the non-empty sub-queue with the lowest virtual time
+ *
+ * @return nullptr, if all sub-queues are empty, else the sub-queue
+ */
+ClusterQueue*
+SegmentQueue::selectClusterQueue()
+{
+    ClusterQueue* result = nullptr;
+    uint64_t lowestVirtualTime = std::numeric_limits<uint64_t>::max();
+
+    const uint32_t numberOfQueues = m_numberOfClusterQueues.load(std::memory_order_acquire);
+    for(uint32_t i = 0; i < numberOfQueues; i++)
+    {
+        ClusterQueue* clusterQueue = &m_clusterQueues[i];
+        if(clusterQueue->inUse.load(std::memory_order_acquire) == false
+                || clusterQueue->numberOfSegments.load(std::memory_order_acquire) == 0)
+        {
+            continue;
+        }
+
+        const uint64_t virtualTime = clusterQueue->virtualTime.load(std::memory_order_relaxed);
+        if(virtualTime < lowestVirtualTime)
+        {
+            lowestVirtualTime = virtualTime;
+            result = clusterQueue;
+        }
+    }
+
+    return result;
+}
+
+/**
+ * @brief register the wait-time of a segment, which was taken from the queue
+ *
+ * @param segment segment, whose processing starts
+ */
+void
+SegmentQueue::takeSegment(AbstractSegment* segment)
+{
+    const uint64_t now = getTimeStamp();
+    const uint64_t waitTime = now > segment->queuedTimeStamp ? now - segment->queuedTimeStamp : 0;
+
+    ClusterQueue* clusterQueue = getClusterQueue(segment);
+    clusterQueue->totalWaitTime.fetch_add(waitTime, std::memory_order_relaxed);
+    clusterQueue->numberOfWaits.fetch_add(1, std::memory_order_relaxed);
+    raiseValue(clusterQueue->maxWaitTime, waitTime);
+}
+
+/**
+ * @brief wake up sleeping processing-units, one for each new segment
+ *
+ * @param numberOfSegments number of segments, which were added to the queue
+ * @param sleepLockHeld true, if the calling unit already holds the sleep-lock, because it checks
+ *                      the queue again within waitForSegment
+ */
+void
+SegmentQueue::wakeUpUnits(const uint64_t numberOfSegments,
+                          const bool sleepLockHeld)
+{
+    // pairs with the fence in waitForSegment, so either the producer sees the sleeping unit, or
+    // the unit sees the new segment before it goes to sleep
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    const uint32_t numberOfSleepers = m_numberOfSleepers.load(std::memory_order_relaxed);
+    if(numberOfSleepers == 0) {
+        return;
+    }
+
+    // the mutex is not recursive, so it is only locked, if the caller doesn't hold it already
+    std::unique_lock<std::mutex> guard(m_sleepLock, std::defer_lock);
+    if(sleepLockHeld == false) {
+        guard.lock();
+    }
+
+    if(numberOfSegments >= numberOfSleepers)
+    {
+        m_wakeupCondition.notify_all();
+        return;
+    }
+
+    for(uint64_t i = 0; i < numberOfSegments; i++) {
+        m_wakeupCondition.notify_one();
+    }
+}
 
 /**
  * @brief add segment to queue
@@ -37,9 +496,9 @@ SegmentQueue::SegmentQueue() {}
 void
 SegmentQueue::addSegmentToQueue(AbstractSegment* newSegment)
 {
-    while(m_queue_lock.test_and_set(std::memory_order_acquire)) { asm(""); }
-    m_segmentQueue.push_back(newSegment);
-    m_queue_lock.clear(std::memory_order_release);
+    newSegment->queuedTimeStamp = getTimeStamp();
+    pushSegment(newSegment);
+    wakeUpUnits(1);
 }
 
 /**
@@ -50,34 +509,184 @@ SegmentQueue::addSegmentToQueue(AbstractSegment* newSegment)
 void
 SegmentQueue::addSegmentListToQueue(const std::vector<AbstractSegment*> &semgnetList)
 {
-    while(m_queue_lock.test_and_set(std::memory_order_acquire)) { asm(""); }
+    const uint64_t timeStamp = getTimeStamp();
+    for(AbstractSegment* segment : semgnetList)
+    {
+        segment->queuedTimeStamp = timeStamp;
+        pushSegment(segment);
+    }
+
+    wakeUpUnits(semgnetList.size());
+}
+
+/**
+ * @brief add a list of segments, which became ready by the work of the calling processing-unit,
+ *        to its own deque. The unit itself takes the last one, so only the others are reported
+ *        to the sleeping units, which can steal them. Threads without deque use the sub-queues.
+ *
+ * @param semgnetList list with segments to add
+ */
+void
+SegmentQueue::addSegmentListToLocalQueue(const std::vector<AbstractSegment*> &semgnetList)
+{
+    if(s_workerDequeId < 0)
+    {
+        addSegmentListToQueue(semgnetList);
+        return;
+    }
+
+    const uint64_t timeStamp = getTimeStamp();
+    WorkerDeque* workerDeque = &m_workerDeques[s_workerDequeId];
+    for(AbstractSegment* segment : semgnetList)
+    {
+        segment->queuedTimeStamp = timeStamp;
+        workerDeque->pushBack(segment);
+    }
 
-    for(AbstractSegment* segment : semgnetList) {
-        m_segmentQueue.push_back(segment);
+    if(semgnetList.size() > 1) {
+        wakeUpUnits(semgnetList.size() - 1);
     }
+}
+
+/**
+ * @brief steal the oldest segment from the deque of another processing-unit
+ *
+ * @return nullptr, if all deques are empty, else the stolen segment
+ */
+AbstractSegment*
+SegmentQueue::stealSegment()
+{
+    const uint32_t numberOfDeques = m_numberOfWorkerDeques.load(std::memory_order_acquire);
+    const uint32_t start = static_cast<uint32_t>(s_workerDequeId + 1);
 
-    m_queue_lock.clear(std::memory_order_release);
+    // start behind the own deque, so not all units steal from the same victim
+    for(uint32_t i = 0; i < numberOfDeques; i++)
+    {
+        const uint32_t dequePos = (start + i) % numberOfDeques;
+        if(static_cast<int32_t>(dequePos) == s_workerDequeId) {
+            continue;
+        }
+
+        AbstractSegment* segment = m_workerDeques[dequePos].steal();
+        if(segment != nullptr) {
+            return segment;
+        }
+    }
+
+    return nullptr;
 }
 
 /**
- * @brief get next segment in the queue
+ * @brief get next segment for the calling processing-unit
+ *
+ * @param preferredNumaNode position of the numa-node of the calling processing-unit
  *
  * @return nullptr, if queue is empty, else next segment in queue
  */
 AbstractSegment*
-SegmentQueue::getSegmentFromQueue()
+SegmentQueue::getSegmentFromQueue(const uint32_t preferredNumaNode)
+{
+    return takeNextSegment(preferredNumaNode, false);
+}
+
+/**
+ * @brief get next segment for the calling processing-unit. The own deque is preferred, so a
+ *        segment is processed, while the data of its predecessor are still in the cache. But if
+ *        another cluster is waiting, which is behind the cluster of the local segment by more
+ *        than the scheduling-granularity, the segment is given back and the waiting cluster is
+ *        served instead. Then the sub-queues of the clusters are checked and at last the deques
+ *        of the other processing-units.
+ *
+ * @param preferredNumaNode position of the numa-node of the calling processing-unit
+ * @param sleepLockHeld true, if the calling unit holds the sleep-lock
+ *
+ * @return nullptr, if queue is empty, else next segment in queue
+ */
+AbstractSegment*
+SegmentQueue::takeNextSegment(const uint32_t preferredNumaNode,
+                              const bool sleepLockHeld)
 {
     AbstractSegment* result = nullptr;
 
-    while(m_queue_lock.test_and_set(std::memory_order_acquire)) { asm(""); }
+    if(s_workerDequeId >= 0)
+    {
+        WorkerDeque* workerDeque = &m_workerDeques[s_workerDequeId];
+        result = workerDeque->popBack();
+        if(result != nullptr)
+        {
+            const ClusterQueue* localQueue = getClusterQueue(result);
+            const ClusterQueue* nextQueue = selectClusterQueue();
+            if(nextQueue == nullptr
+                    || nextQueue == localQueue
+                    || nextQueue->virtualTime.load(std::memory_order_relaxed)
+                       + SCHEDULING_GRANULARITY
+                       >= localQueue->virtualTime.load(std::memory_order_relaxed))
+            {
+                takeSegment(result);
+                return result;
+            }
 
-    if(m_segmentQueue.size() > 0)
+            // the other units can only reach the segment by stealing, so one has to be woken up
+            workerDeque->pushBack(result);
+            wakeUpUnits(1, sleepLockHeld);
+        }
+    }
+
+    result = popFromClusterQueues(preferredNumaNode);
+
+    // the waiting cluster could have been served by another unit in the meantime
+    if(result == nullptr
+            && s_workerDequeId >= 0)
     {
-        result = m_segmentQueue.front();
-        m_segmentQueue.pop_front();
+        result = m_workerDeques[s_workerDequeId].popBack();
     }
 
-    m_queue_lock.clear(std::memory_order_release);
+    if(result == nullptr) {
+        result = stealSegment();
+    }
+
+    if(result != nullptr) {
+        takeSegment(result);
+    }
 
     return result;
 }
+
+/**
+ * @brief get next segment in the queue and sleep, until a new segment was added, if the queue
+ *        is empty
+ *
+ * @param preferredNumaNode position of the numa-node of the calling processing-unit
+ * @param timeoutMs maximum time to sleep in milliseconds, so the caller can check its abort-flag
+ *
+ * @return nullptr, if there is still no segment after the sleep, else next segment in queue
+ */
+AbstractSegment*
+SegmentQueue::waitForSegment(const uint32_t preferredNumaNode,
+                             const uint32_t timeoutMs)
+{
+    AbstractSegment* result = getSegmentFromQueue(preferredNumaNode);
+    if(result != nullptr) {
+        return result;
+    }
+
+    std::unique_lock<std::mutex> lock(m_sleepLock);
+    m_numberOfSleepers.fetch_add(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    // check again after the registration, because a producer could have added a segment in the
+    // meantime without seeing this unit
+    result = takeNextSegment(preferredNumaNode, true);
+    if(result != nullptr)
+    {
+        m_numberOfSleepers.fetch_sub(1, std::memory_order_relaxed);
+        return result;
+    }
+
+    m_wakeupCondition.wait_for(lock, std::chrono::milliseconds(timeoutMs));
+    m_numberOfSleepers.fetch_sub(1, std::memory_order_relaxed);
+
+    // release the lock before taking the segment, so the woken units don't block each other
+    lock.unlock();
+    return getSegmentFromQueue(preferredNumaNode);
+}
@@ -25,21 +25,76 @@
 
 #include <common.h>
 
+#include <core/processing/cluster_queue.h>
+#include <core/processing/worker_deque.h>
+
 class AbstractSegment;
+class Cluster;
 
+/**
+ * @brief Queue of the segments, which are ready for processing, with one sub-queue for each
+ *        cluster. The sub-queues are served by weighted fair scheduling, so a big cluster in a
+ *        learn-task doesn't starve a small cluster, which has to answer direct requests.
+ *        Processing-units without work sleep on a condition-variable and are woken by the
+ *        producers, one for each new segment, so a hand-off doesn't wait for a poll-interval.
+ *        In addition each processing-unit has its own deque for the segments, which became ready
+ *        by its own work. Units without work steal from the deques of the other units.
+ */
 class SegmentQueue
 {
 public:
-    SegmentQueue();
+    SegmentQueue(const uint32_t numberOfNodes = 1,
+                 const uint32_t defaultClusterWeight = DEFAULT_CLUSTER_WEIGHT);
+    ~SegmentQueue();
 
     void addSegmentToQueue(AbstractSegment* newSegment);
     void addSegmentListToQueue(const std::vector<AbstractSegment*> &semgnetList);
+    void addSegmentListToLocalQueue(const std::vector<AbstractSegment*> &semgnetList);
+
+    AbstractSegment* getSegmentFromQueue(const uint32_t preferredNumaNode = 0);
+    AbstractSegment* waitForSegment(const uint32_t preferredNumaNode,
+                                    const uint32_t timeoutMs);
+
+    bool registerWorker();
+    void unregisterWorker();
 
-    AbstractSegment* getSegmentFromQueue();
+    uint32_t registerCluster();
+    void unregisterCluster(const Cluster* cluster);
+    bool setClusterWeight(const uint32_t clusterQueueId, const uint32_t weight);
+    uint32_t getClusterWeight(const uint32_t clusterQueueId);
+    void getClusterWaitTime(const uint32_t clusterQueueId,
+                            uint64_t &averageWaitTime,
+                            uint64_t &maxWaitTime);
+    void addProcessingTime(AbstractSegment* segment, const uint64_t processingTime);
 
 private:
-    std::atomic_flag m_queue_lock = ATOMIC_FLAG_INIT;
-    std::deque<AbstractSegment*> m_segmentQueue;
+    // the sub-queues are never reallocated and the slot 0 is shared by all clusters, which
+    // didn't get an own sub-queue
+    ClusterQueue* m_clusterQueues = nullptr;
+    std::atomic<uint32_t> m_numberOfClusterQueues = {1};
+    std::atomic<uint64_t> m_virtualTime = {0};
+    uint32_t m_numberOfNodes = 1;
+    uint32_t m_defaultClusterWeight = DEFAULT_CLUSTER_WEIGHT;
+
+    // the deques are never reallocated, so they can be accessed without a lock of the list
+    WorkerDeque* m_workerDeques = nullptr;
+    std::atomic<uint32_t> m_numberOfWorkerDeques = {0};
+    std::mutex m_registerLock;
+    static thread_local int32_t s_workerDequeId;
+
+    std::mutex m_sleepLock;
+    std::condition_variable m_wakeupCondition;
+    std::atomic<uint32_t> m_numberOfSleepers = {0};
+
+    void pushSegment(AbstractSegment* segment);
+    void wakeUpUnits(const uint64_t numberOfSegments, const bool sleepLockHeld = false);
+    AbstractSegment* stealSegment();
+
+    ClusterQueue* getClusterQueue(const AbstractSegment* segment);
+    ClusterQueue* selectClusterQueue();
+    AbstractSegment* popFromClusterQueues(const uint32_t preferredNumaNode);
+    AbstractSegment* takeNextSegment(const uint32_t preferredNumaNode, const bool sleepLockHeld);
+    void takeSegment(AbstractSegment* segment);
 };
 
 #endif // KYOUKOMIND_SEGMENTQUEUE_H
@@ -0,0 +1,104 @@
+/**
+ * @file        worker_deque.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+
+#ifndef KYOUKOMIND_WORKER_DEQUE_H
+#define KYOUKOMIND_WORKER_DEQUE_H
+
+#include <common.h>
+
+class AbstractSegment;
+
+/**
+ * @brief Local queue of a single processing-unit. The owner adds and takes segments at the back,
+ *        so a segment, which became ready by the last processed segment, is processed next while
+ *        the shared border-buffer is still in the cache. Other units steal the oldest segments
+ *        from the front. The lock is only contended, while a segment is stolen.
+ */
+struct WorkerDeque
+{
+    std::mutex lock;
+    std::deque<AbstractSegment*> segments;
+    std::atomic<uint32_t> numberOfSegments = {0};
+    bool inUse = false;
+
+    /**
+     * @brief add a segment at the back of the deque
+     *
+     * @param segment segment to add
+     */
+    void
+    pushBack(AbstractSegment* segment)
+    {
+        std::lock_guard<std::mutex> guard(lock);
+        segments.push_back(segment);
+        numberOfSegments.store(segments.size(), std::memory_order_release);
+    }
+
+    /**
+     * @brief take the newest segment of the deque, which is only done by the owner
+     *
+     * @return nullptr, if the deque is empty, else the segment
+     */
+    AbstractSegment*
+    popBack()
+    {
+        if(numberOfSegments.load(std::memory_order_acquire) == 0) {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        if(segments.size() == 0) {
+            return nullptr;
+        }
+
+        AbstractSegment* segment = segments.back();
+        segments.pop_back();
+        numberOfSegments.store(segments.size(), std::memory_order_release);
+        return segment;
+    }
+
+    /**
+     * @brief take the oldest segment of the deque, which is done by the other units
+     *
+     * @return nullptr, if the deque is empty, else the segment
+     */
+    AbstractSegment*
+    steal()
+    {
+        if(numberOfSegments.load(std::memory_order_acquire) == 0) {
+            return nullptr;
+        }
+
+        std::lock_guard<std::mutex> guard(lock);
+        if(segments.size() == 0) {
+            return nullptr;
+        }
+
+        AbstractSegment* segment = segments.front();
+        segments.pop_front();
+        numberOfSegments.store(segments.size(), std::memory_order_release);
+        return segment;
+    }
+};
+
+#endif // KYOUKOMIND_WORKER_DEQUE_H
@@ -0,0 +1,163 @@
+/**
+ * @file        worker_pool.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "worker_pool.h"
+
+#include <core/processing/numa_topology.h>
+
+/**
+ * @brief constructor
+ *
+ * @param numberOfWorker total number of workers, including the calling thread
+ * @param numaTopology topology to pin the workers, nullptr to not pin them
+ * @param numaNode position of the node, to which the workers should be pinned
+ */
+WorkerPool::WorkerPool(const uint32_t numberOfWorker,
+                       const NumaTopology* numaTopology,
+                       const uint32_t numaNode)
+{
+    m_numberOfWorker = numberOfWorker;
+    m_numaTopology = numaTopology;
+    m_numaNode = numaNode;
+    if(m_numberOfWorker == 0) {
+        m_numberOfWorker = 1;
+    }
+
+    // worker 0 is always the thread, which calls runParallel
+    for(uint32_t i = 1; i < m_numberOfWorker; i++) {
+        m_threads.emplace_back(&WorkerPool::workerLoop, this, i);
+    }
+}
+
+/**
+ * @brief destructor
+ */
+WorkerPool::~WorkerPool()
+{
+    {
+        std::unique_lock<std::mutex> lock(m_jobLock);
+        m_abort = true;
+    }
+    m_startCondition.notify_all();
+
+    for(std::thread &thread : m_threads) {
+        thread.join();
+    }
+}
+
+/**
+ * @brief get number of workers of the pool
+ *
+ * @return number of workers, including the calling thread
+ */
+uint32_t
+WorkerPool::getNumberOfWorker() const
+{
+    return m_numberOfWorker;
+}
+
+/**
+ * @brief run a task on all workers of the pool and wait until all of them are finished
+ *
+ * @param task function to run, which gets the id of the worker as argument
+ * @param threaded false to run all parts of the task one after another within the calling thread
+ */
+void
+WorkerPool::runParallel(const std::function<void(const uint32_t workerId)> &task,
+                        const bool threaded)
+{
+    // if the pool is already used by another processing-unit, then run all parts of the task
+    // within the calling thread, to avoid blocking
+    if(threaded == false
+            || m_runLock.try_lock() == false)
+    {
+        for(uint32_t i = 0; i < m_numberOfWorker; i++) {
+            task(i);
+        }
+        return;
+    }
+
+    // start workers
+    {
+        std::unique_lock<std::mutex> lock(m_jobLock);
+        m_task = &task;
+        m_numberOfRunningWorker = m_numberOfWorker - 1;
+        m_generation++;
+    }
+    m_startCondition.notify_all();
+
+    // run own part
+    task(0);
+
+    // wait for all other workers
+    {
+        std::unique_lock<std::mutex> lock(m_jobLock);
+        m_finishCondition.wait(lock, [this] { return m_numberOfRunningWorker == 0; });
+        m_task = nullptr;
+    }
+
+    m_runLock.unlock();
+}
+
+/**
+ * @brief loop of a single worker-thread
+ *
+ * @param workerId id of the worker
+ */
+void
+WorkerPool::workerLoop(const uint32_t workerId)
+{
+    uint64_t lastGeneration = 0;
+
+    if(m_numaTopology != nullptr) {
+        m_numaTopology->pinCurrentThread(m_numaNode);
+    }
+
+    while(true)
+    {
+        const std::function<void(const uint32_t)>* task = nullptr;
+
+        // wait for next task
+        {
+            std::unique_lock<std::mutex> lock(m_jobLock);
+            m_startCondition.wait(lock, [this, lastGeneration] {
+                return m_abort || m_generation != lastGeneration;
+            });
+            if(m_abort) {
+                return;
+            }
+            lastGeneration = m_generation;
+            task = m_task;
+        }
+
+        (*task)(workerId);
+
+        // register as finished
+        {
+            std::unique_lock<std::mutex> lock(m_jobLock);
+            m_numberOfRunningWorker--;
+            if(m_numberOfRunningWorker == 0) {
+                m_finishCondition.notify_one();
+            }
+        }
+    }
+}
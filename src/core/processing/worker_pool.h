@@ -0,0 +1,66 @@
+/**
+ * @file        worker_pool.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_WORKER_POOL_H
+#define KYOUKOMIND_WORKER_POOL_H
+
+#include <common.h>
+
+class NumaTopology;
+
+/**
+ * @brief Fork-join pool to split the work of a single segment over multiple cores. The thread,
+ *        which calls runParallel, takes part in the processing as worker 0. With a numa-topology
+ *        all other workers are pinned to the cpus of the given node.
+ */
+class WorkerPool
+{
+public:
+    WorkerPool(const uint32_t numberOfWorker,
+               const NumaTopology* numaTopology = nullptr,
+               const uint32_t numaNode = 0);
+    ~WorkerPool();
+
+    uint32_t getNumberOfWorker() const;
+    void runParallel(const std::function<void(const uint32_t workerId)> &task,
+                     const bool threaded = true);
+
+private:
+    void workerLoop(const uint32_t workerId);
+
+    uint32_t m_numberOfWorker = 1;
+    const NumaTopology* m_numaTopology = nullptr;
+    uint32_t m_numaNode = 0;
+    std::vector<std::thread> m_threads;
+
+    std::mutex m_runLock;
+    std::mutex m_jobLock;
+    std::condition_variable m_startCondition;
+    std::condition_variable m_finishCondition;
+
+    const std::function<void(const uint32_t)>* m_task = nullptr;
+    uint64_t m_generation = 0;
+    uint32_t m_numberOfRunningWorker = 0;
+    bool m_abort = false;
+};
+
+#endif // KYOUKOMIND_WORKER_POOL_H
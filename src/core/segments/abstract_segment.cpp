@@ -23,6 +23,11 @@
 #include "abstract_segment.h"
 
 #include <core/cluster/cluster.h>
+#include <core/processing/numa_topology.h>
+#include <core/processing/segment_queue.h>
+#include <core/segments/huge_pages.h>
+
+#include <kyouko_root.h>
 
 /**
  * @brief constructor
@@ -32,6 +37,7 @@ AbstractSegment::AbstractSegment() {}
 AbstractSegment::AbstractSegment(const void* data, const uint64_t dataSize)
 {
     segmentData.initBuffer(data, dataSize);
+    prepareSegmentData();
 }
 
 /**
@@ -61,6 +67,22 @@ AbstractSegment::getName() const
     return segmentName->getName();
 }
 
+/**
+ * @brief get the version of the layout of the segment-data, which is read directly from the data,
+ *        so it can be checked before the pointers are initialized for a restored segment
+ *
+ * @return layout-version of the segment, 0 if there are no data
+ */
+uint8_t
+AbstractSegment::getLayoutVersion() const
+{
+    if(segmentData.staticData == nullptr) {
+        return 0;
+    }
+
+    return static_cast<const SegmentHeader*>(segmentData.staticData)->version;
+}
+
 /**
  * @brief set new name for the segment
  *
@@ -93,28 +115,47 @@ AbstractSegment::getSlotId(const std::string &name)
 }
 
 /**
- * @brief check if all border-buffer, which are in use, are ready for processing
+ * @brief (re-)create the transfer-buffers for the batched processing. Each transfer-value has
+ *        batchSize consecutive entries, one for each sample of the batch.
  *
- * @return true, if all border-buffer are ready, else false
+ * @param batchSize number of samples, which are processed together
  */
-bool
-AbstractSegment::isReady()
+void
+AbstractSegment::initBatch(const uint32_t batchSize)
 {
+    batchInputTransfers.assign(segmentHeader->inputTransfers.count * batchSize, 0.0f);
+    batchOutputTransfers.assign(segmentHeader->outputTransfers.count * batchSize, 0.0f);
+}
+
+/**
+ * @brief reset the counter of the missing inputs at the beginning of a cycle
+ *
+ * @param pendingDirection direction of the slots, which have to get an input from a neighbor in
+ *                         the current cycle
+ *
+ * @return number of missing inputs, 0 if the segment is ready for processing
+ */
+uint32_t
+AbstractSegment::initPendingInputs(const uint8_t pendingDirection)
+{
+    uint32_t numberOfInputs = 0;
     for(uint8_t i = 0; i < 16; i++)
     {
         if(segmentSlots->slots[i].inUse == true
-                && segmentSlots->slots[i].inputReady == false)
+                && segmentSlots->slots[i].direction == pendingDirection)
         {
-            return false;
+            numberOfInputs++;
         }
     }
 
-    return true;
+    pendingInputs.store(numberOfInputs, std::memory_order_relaxed);
+    return numberOfInputs;
 }
 
 /**
  * @brief run finishing step of the segment-processing to share the border-buffer with the
- *        neighbor segments
+ *        neighbor segments. Each neighbor, which got its last missing input, is added to the
+ *        segment-queue, so segments are only queued, when they can be processed.
  */
 void
 AbstractSegment::finishSegment()
@@ -126,6 +167,14 @@ AbstractSegment::finishSegment()
     uint64_t targetBufferPos = 0;
     AbstractSegment* targetSegment = nullptr;
     SegmentSlotList* targetNeighbors = nullptr;
+    const uint32_t batchSize = parentCluster->batchSize;
+    std::vector<AbstractSegment*> readySegments;
+
+    // in the backward-cycle the values flow against the direction of the slots
+    uint8_t pendingDirection = INPUT_DIRECTION;
+    if(parentCluster->mode == Cluster::LEARN_BACKWARD_MODE) {
+        pendingDirection = OUTPUT_DIRECTION;
+    }
 
     for(uint8_t i = 0; i < 16; i++)
     {
@@ -141,18 +190,37 @@ AbstractSegment::finishSegment()
             targetNeighbors = targetSegment->segmentSlots;
             targetBufferPos = targetNeighbors->slots[targetSide].inputTransferBufferPos;
             targetBuffer = &targetSegment->inputTransfers[targetBufferPos];
-            memcpy(targetBuffer,
-                   sourceBuffer,
-                   segmentSlots->slots[i].numberOfNeurons * sizeof(float));
-            memset(sourceBuffer,
-                   0,
-                   segmentSlots->slots[i].numberOfNeurons * sizeof(float));
+            uint64_t numberOfValues = segmentSlots->slots[i].numberOfNeurons;
+
+            // in case of a batch, the values of all samples are shared together
+            if(batchSize > 1)
+            {
+                sourceBuffer = &batchOutputTransfers[segmentSlots->slots[i].outputTransferBufferPos
+                                                     * batchSize];
+                targetBuffer = &targetSegment->batchInputTransfers[targetBufferPos * batchSize];
+                numberOfValues *= batchSize;
+            }
+
+            memcpy(targetBuffer, sourceBuffer, numberOfValues * sizeof(float));
+            memset(sourceBuffer, 0, numberOfValues * sizeof(float));
 
             // mark the target as ready for processing
-            targetSegment->segmentSlots->slots[targetSide].inputReady = true;
+            SegmentSlot* targetSlot = &targetSegment->segmentSlots->slots[targetSide];
+            targetSlot->inputReady = true;
+            if(targetSlot->direction == pendingDirection
+                    && targetSegment->pendingInputs.fetch_sub(1, std::memory_order_acq_rel) == 1)
+            {
+                readySegments.push_back(targetSegment);
+            }
         }
     }
 
+    // the ready neighbors are processed next by the same processing-unit, while their inputs
+    // are still in its cache, as long as they are not stolen by another unit
+    if(readySegments.size() > 0) {
+        KyoukoRoot::m_segmentQueue->addSegmentListToLocalQueue(readySegments);
+    }
+
     parentCluster->updateClusterState();
 }
 
@@ -200,3 +268,38 @@ AbstractSegment::createGenericNewHeader(SegmentHeader &header,
 
     return segmentDataPos;
 }
+
+/**
+ * @brief choose the numa-node of the segment, move the segment-data to this node and back it
+ *        with transparent huge pages, if configured
+ */
+void
+AbstractSegment::prepareSegmentData()
+{
+    segmentDataHugePages = adviseHugePages(segmentData.buffer.data,
+                                           segmentData.buffer.totalBufferSize,
+                                           KyoukoRoot::m_hugePageType);
+
+    if(KyoukoRoot::m_numaTopology == nullptr) {
+        return;
+    }
+
+    numaNode = KyoukoRoot::m_numaTopology->getNextNode();
+    bindToNumaNode(segmentData.buffer.data, segmentData.buffer.totalBufferSize);
+}
+
+/**
+ * @brief bind additional memory of the segment to the numa-node of the segment
+ *
+ * @param data pointer to the memory
+ * @param dataSize size of the memory in bytes
+ */
+void
+AbstractSegment::bindToNumaNode(void* data, const uint64_t dataSize)
+{
+    if(KyoukoRoot::m_numaTopology == nullptr) {
+        return;
+    }
+
+    KyoukoRoot::m_numaTopology->bindMemory(data, dataSize, numaNode);
+}
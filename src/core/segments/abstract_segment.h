@@ -48,6 +48,7 @@ public:
     SegmentTypes getType() const;
     const std::string getName() const;
     bool setName(const std::string &name);
+    uint8_t getLayoutVersion() const;
 
     Kitsunemimi::ItemBuffer segmentData;
 
@@ -60,12 +61,29 @@ public:
     float* outputTransfers = nullptr;
     Cluster* parentCluster = nullptr;
 
+    // position of the numa-node, where the memory of the segment is placed
+    uint32_t numaNode = 0;
+
+    // huge pages in effect for the segment-data
+    HugePageType segmentDataHugePages = NO_HUGE_PAGES;
+
+    // number of inputs, which are still missing in the current cycle
+    std::atomic<uint32_t> pendingInputs = {0};
+
+    // time in nanoseconds, where the segment was added to the segment-queue
+    uint64_t queuedTimeStamp = 0;
+
+    // transfer-buffers of the batched processing, which are not part of the segment-data
+    std::vector<float> batchInputTransfers;
+    std::vector<float> batchOutputTransfers;
+
     virtual bool initSegment(const std::string &name,
                              const Kitsunemimi::Hanami::SegmentMeta &segmentMeta) = 0;
     virtual bool reinitPointer(const uint64_t numberOfBytes) = 0;
     uint8_t getSlotId(const std::string &name);
+    virtual void initBatch(const uint32_t batchSize);
 
-    bool isReady();
+    uint32_t initPendingInputs(const uint8_t pendingDirection);
     void finishSegment();
 
 protected:
@@ -74,11 +92,13 @@ protected:
     uint32_t createGenericNewHeader(SegmentHeader &header,
                                     const uint64_t borderbufferSize);
     bool reinitGenericPointer();
+    void prepareSegmentData();
+    void bindToNumaNode(void* data, const uint64_t dataSize);
 
 private:
     virtual void initSegmentPointer(const SegmentHeader &header) = 0;
     virtual bool connectBorderBuffer() = 0;
-    virtual void allocateSegment(SegmentHeader &header) = 0;
+    virtual bool allocateSegment(SegmentHeader &header) = 0;
 };
 
 //==================================================================================================
@@ -26,24 +26,33 @@
 #include <common.h>
 
 #include <kyouko_root.h>
+#include <core/processing/worker_pool.h>
+#include <core/cluster/cluster.h>
 #include <core/segments/brick.h>
 #include <core/segments/dynamic_segment/dynamic_segment.h>
+#include <core/fast_math.h>
 
 #include "objects.h"
+#include "section_geometry.h"
+#include "synapse_access.h"
+#include "synapse_chain.h"
 
 /**
  * @brief backpropagate values of an output-brick
  *
  * @param brick brick to process
- * @param segment segment where the brick belongs to
+ * @param inputTransfers pointer to the input-buffer of the segment
+ * @param neuronSections pointer to all neuron-sections of the segment
+ * @param dynamicSegmentSettings settings of the segment
+ * @param deltaTracker tracker to register the new deltas
  */
 inline bool
 backpropagateOutput(const Brick* brick,
                     float* inputTransfers,
                     NeuronSection* neuronSections,
-                    DynamicSegmentSettings* dynamicSegmentSettings)
+                    DynamicSegmentSettings* dynamicSegmentSettings,
+                    DeltaTracker* deltaTracker)
 {
-    DynamicNeuron* neuron = nullptr;
     NeuronSection* section = nullptr;
     float totalDelta = 0.0f;
 
@@ -53,16 +62,23 @@ backpropagateOutput(const Brick* brick,
         neuronSectionId++)
     {
         section = &neuronSections[neuronSectionId];
+        uint64_t deltaMask = 0;
         for(uint32_t neuronId = 0;
             neuronId < section->numberOfNeurons;
             neuronId++)
         {
-            neuron = &section->neurons[neuronId];
-            neuron->delta = inputTransfers[neuron->targetBorderId];
-            inputTransfers[neuron->targetBorderId] = 0.0f;
-            totalDelta += abs(neuron->delta);
+            const uint32_t borderId = section->targetBorderId[neuronId];
+            section->delta[neuronId] = inputTransfers[borderId];
+            inputTransfers[borderId] = 0.0f;
+            if(section->delta[neuronId] != 0.0f)
+            {
+                deltaMask |= 1ull << neuronId;
+                totalDelta += std::fabs(section->delta[neuronId]);
+            }
         }
+        deltaTracker->deltaMasks[neuronSectionId] = deltaMask;
     }
+    deltaTracker->brickDeltas[brick->brickId] = totalDelta;
 
     return totalDelta > dynamicSegmentSettings->backpropagationBorder;
     //return true;
@@ -72,152 +88,432 @@ backpropagateOutput(const Brick* brick,
  * @brief run backpropagation for a single synapse-section
  *
  * @param section pointer to section to process
- * @param sourceNeuron pointer to the neuron, who triggered the section
+ * @param sourceDelta pointer to the delta of the neuron, who triggered the section
  * @param netH neuron-potential
- * @param outH output-multiplicator
- * @param brick brick where the seciton is located
- * @param segment segment where section belongs to
+ * @param neuronSections pointer to all neuron-sections of the segment
+ * @param sectionId id of the section within the segment
+ * @param roundingSeed seed for the rounding of the compact weights in the current learn-step
+ * @param weightDeltas accumulated weight-changes of the synapses of the section in case of a
+ *                     mini-batch, nullptr to update the weights directly
+ *
+ * @return remaining weight after the section
  */
-inline void
-backpropagateSection(SynapseSection* section,
-                     DynamicNeuron* sourceNeuron,
+template<typename SECTION>
+inline float
+backpropagateSection(SECTION* section,
+                     float* sourceDelta,
                      float netH,
-                     const Brick* brick,
                      NeuronSection* neuronSections,
-                     SynapseSection* synapseSections)
+                     const uint32_t sectionId,
+                     const uint32_t roundingSeed,
+                     float* weightDeltas)
 {
-    Synapse* synapse = nullptr;
-    DynamicNeuron* targetNeuron = nullptr;
+    auto* synapse = &section->synapses[0];
+    float targetDelta = 0.0f;
     NeuronSection* neuronSection = &neuronSections[section->targetNeuronSectionId];
     float learnValue = 0.2f;
     uint16_t pos = 0;
 
     // iterate over all synapses in the section
-    while(pos < SYNAPSES_PER_SYNAPSESECTION
+    while(pos < SECTION::numberOfSynapses
           && netH > 0.0f)
     {
         // break look, if no more synapses to process
         synapse = &section->synapses[pos];
 
+        // skip synapses, which were removed by the reduction
+        if(synapse->targetNeuronId == UNINIT_STATE_16)
+        {
+            pos++;
+            continue;
+        }
+
         // update weight
         learnValue = static_cast<float>(126 - synapse->activeCounter) * 0.0002f;
         learnValue += 0.05f;
-        targetNeuron = &neuronSection->neurons[synapse->targetNeuronId];
-        sourceNeuron->delta += targetNeuron->delta * synapse->weight;
-        synapse->weight -= learnValue * targetNeuron->delta;
+        targetDelta = neuronSection->delta[synapse->targetNeuronId];
+        const float weight = getWeight(synapse);
+        *sourceDelta += targetDelta * weight;
+        if(weightDeltas == nullptr) {
+            updateWeight(synapse,
+                         weight - learnValue * targetDelta,
+                         roundingSeed,
+                         sectionId * SECTION::numberOfSynapses + pos);
+        } else {
+            weightDeltas[pos] += learnValue * targetDelta;
+        }
 
-        netH -= synapse->border;
+        netH -= getBorder(synapse);
         pos++;
     }
 
-    if(section->nextId != UNINIT_STATE_32
-            && netH > 0.01f)
+    return netH;
+}
+
+/**
+ * @brief consume the weight of a synapse-section, whose target-neurons have no delta. The
+ *        weights and the delta of the source stay unchanged, so only the borders are relevant.
+ *
+ * @param section pointer to section to process
+ * @param netH neuron-potential
+ *
+ * @return remaining weight after the section
+ */
+template<typename SECTION>
+inline float
+skipSection(const SECTION* section,
+            float netH)
+{
+    uint16_t pos = 0;
+    while(pos < SECTION::numberOfSynapses
+          && netH > 0.0f)
     {
-        backpropagateSection(&synapseSections[section->nextId],
-                             sourceNeuron,
-                             netH,
-                             brick,
-                             neuronSections,
-                             synapseSections);
+        const auto* synapse = &section->synapses[pos];
+        if(synapse->targetNeuronId != UNINIT_STATE_16) {
+            netH -= getBorder(synapse);
+        }
+        pos++;
     }
+
+    return netH;
 }
 
 /**
- * @brief run back-propagation over the hidden neurons
+ * @brief run backpropagation over the chain of synapse-sections of a neuron
+ *
+ * @param section first synapse-section of the chain
+ * @param sourceDelta pointer to the delta of the neuron, who triggered the section
+ * @param netH neuron-potential
+ * @param neuronSections pointer to all neuron-sections of the segment
+ * @param synapseSections pointer to all synapse-sections of the segment
+ * @param weightDeltas accumulated weight-changes of all synapses of the segment in case of a
+ *                     mini-batch, nullptr to update the weights directly
+ * @param roundingSeed seed for the rounding of the compact weights in the current learn-step
+ * @param deltaMasks masks of the neurons with delta of all neuron-sections
+ */
+template<typename SECTION>
+inline void
+backpropagateSynapses(SECTION* section,
+                      float* sourceDelta,
+                      const float netH,
+                      NeuronSection* neuronSections,
+                      SECTION* synapseSections,
+                      float* weightDeltas,
+                      const uint32_t roundingSeed,
+                      const uint64_t* deltaMasks)
+{
+    walkSynapseChain(section,
+                     synapseSections,
+                     neuronSections,
+                     netH,
+                     [&](const NeuronSection* targetSection) {
+                         if(deltaMasks[targetSection - neuronSections] != 0) {
+                             prefetchNeuronArray(targetSection->delta);
+                         }
+                     },
+                     [&](SECTION* currentSection, const float remainingWeight) {
+                         if(deltaMasks[currentSection->targetNeuronSectionId] == 0) {
+                             return skipSection(currentSection, remainingWeight);
+                         }
+
+                         const uint64_t sectionId = currentSection - synapseSections;
+                         float* sectionDeltas = nullptr;
+                         if(weightDeltas != nullptr) {
+                             sectionDeltas = &weightDeltas[sectionId * SECTION::numberOfSynapses];
+                         }
+                         return backpropagateSection(currentSection,
+                                                     sourceDelta,
+                                                     remainingWeight,
+                                                     neuronSections,
+                                                     static_cast<uint32_t>(sectionId),
+                                                     roundingSeed,
+                                                     sectionDeltas);
+                     });
+}
+
+/**
+ * @brief run back-propagation over the hidden neurons. Only active neurons are processed. If the
+ *        target-bricks of the brick have together a delta below the border, then the synapses
+ *        are not processed at all and the deltas of the brick are only reset.
  *
  * @param brick pointer to current brick
- * @param segment pointer to currect segment to process, which contains the brick
+ * @param neuronSections pointer to all neuron-sections of the segment
+ * @param synapseSections pointer to all synapse-sections of the segment
+ * @param outputTransfers pointer to the output-buffer of the segment
+ * @param weightDeltas accumulated weight-changes in case of a mini-batch, else nullptr
+ * @param roundingSeed seed for the rounding of the compact weights in the current learn-step
+ * @param deltaTracker tracker of the deltas of the segment
+ * @param backpropagationBorder border, below which deltas are ignored
+ * @param useFastMath true to use the approximation of the derivative
  */
+template<typename SECTION>
 inline void
 backpropagateNeurons(const Brick* brick,
                      NeuronSection* neuronSections,
-                     SynapseSection* synapseSections,
-                     UpdatePosSection* updatePosSections,
-                     float* outputTransfers)
+                     SECTION* synapseSections,
+                     float* outputTransfers,
+                     float* weightDeltas,
+                     const uint32_t roundingSeed,
+                     DeltaTracker* deltaTracker,
+                     const float backpropagationBorder,
+                     const bool useFastMath)
 {
-    DynamicNeuron* sourceNeuron = nullptr;
     NeuronSection* neuronSection = nullptr;
-    UpdatePosSection* updatePosSection = nullptr;
+    const uint64_t* deltaMasks = deltaTracker->deltaMasks.data();
+    const bool skipBrick = deltaTracker->getTargetDelta(brick->brickId) <= backpropagationBorder;
+    float brickDelta = 0.0f;
 
     // iterate over all neurons within the brick
     for(uint32_t neuronSectionId = brick->neuronSectionPos;
         neuronSectionId < brick->numberOfNeuronSections + brick->neuronSectionPos;
         neuronSectionId++)
     {
+        // without delta and without synapses to process there is nothing to reset
+        if(skipBrick
+                && deltaMasks[neuronSectionId] == 0
+                && brick->isInputBrick == false)
+        {
+            continue;
+        }
+
         neuronSection = &neuronSections[neuronSectionId];
-        updatePosSection = &updatePosSections[neuronSectionId];
+        uint64_t deltaMask = 0;
         for(uint32_t neuronId = 0;
             neuronId < neuronSection->numberOfNeurons;
             neuronId++)
         {
-            // skip section, if not active
-            sourceNeuron = &neuronSection->neurons[neuronId];
-            //UpdatePos* updatePos = &updatePosSection->positions[neuronId];
-            if(sourceNeuron->targetSectionId == UNINIT_STATE_32) {
+            float* sourceDelta = &neuronSection->delta[neuronId];
+
+            // neurons without synapses keep their delta
+            const uint32_t targetSectionId = neuronSection->targetSectionId[neuronId];
+            if(targetSectionId == UNINIT_STATE_32)
+            {
+                if(*sourceDelta != 0.0f)
+                {
+                    deltaMask |= 1ull << neuronId;
+                    brickDelta += std::fabs(*sourceDelta);
+                }
                 continue;
             }
 
-            sourceNeuron->delta = 0.0f;
+            *sourceDelta = 0.0f;
 
             // set start-values
-            if(sourceNeuron->active)
+            if(skipBrick == false
+                    && neuronSection->active[neuronId])
             {
-                backpropagateSection(&synapseSections[sourceNeuron->targetSectionId],
-                                     sourceNeuron,
-                                     sourceNeuron->potential,
-                                     brick,
-                                     neuronSections,
-                                     synapseSections);
+                const float potential = neuronSection->potential[neuronId];
+                backpropagateSynapses(&synapseSections[targetSectionId],
+                                      sourceDelta,
+                                      potential,
+                                      neuronSections,
+                                      synapseSections,
+                                      weightDeltas,
+                                      roundingSeed,
+                                      deltaMasks);
 
-                sourceNeuron->delta *= 1.4427f * pow(0.5f, sourceNeuron->potential);
+                if(useFastMath) {
+                    *sourceDelta *= 1.4427f * fastExp2(-potential);
+                } else {
+                    *sourceDelta *= 1.4427f * pow(0.5f, potential);
+                }
+                if(*sourceDelta != 0.0f)
+                {
+                    deltaMask |= 1ull << neuronId;
+                    brickDelta += std::fabs(*sourceDelta);
+                }
             }
 
             if(brick->isInputBrick) {
-                outputTransfers[sourceNeuron->targetBorderId] = sourceNeuron->delta;
+                outputTransfers[neuronSection->targetBorderId[neuronId]] = *sourceDelta;
             }
         }
+        deltaTracker->deltaMasks[neuronSectionId] = deltaMask;
     }
+
+    deltaTracker->brickDeltas[brick->brickId] = brickDelta;
 }
 
 /**
- * @brief correct wight of synapses within
+ * @brief correct wight of synapses within. The wavefronts of the bricks are processed in reverse
+ *        order and the bricks of the same wavefront are split between the worker-threads.
  *
  * @param segment segment to process
  */
+template<typename SECTION>
 void
-rewightDynamicSegment(const DynamicSegment &segment)
+rewightDynamicSegment(DynamicSegment &segment)
 {
     Brick* bricks = segment.bricks;
-    uint32_t* brickOrder = segment.brickOrder;
     NeuronSection* neuronSections = segment.neuronSections;
-    SynapseSection* synapseSections = segment.synapseSections;
-    SegmentHeader* segmentHeader = segment.segmentHeader;
+    SECTION* synapseSections = reinterpret_cast<SECTION*>(segment.synapseSections);
     DynamicSegmentSettings* dynamicSegmentSettings = segment.dynamicSegmentSettings;
-    UpdatePosSection* updatePosSections = segment.updatePosSections;
     float* inputTransfers = segment.inputTransfers;
     float* outputTransfers = segment.outputTransfers;
+    DeltaTracker* deltaTracker = &segment.deltaTracker;
+    const float backpropagationBorder = dynamicSegmentSettings->backpropagationBorder;
+    const bool useFastMath = dynamicSegmentSettings->fastMath != 0;
+    const uint32_t roundingSeed = dynamicSegmentSettings->randomSeed + segment.numberOfLearnSteps;
+    segment.numberOfLearnSteps++;
+
+    // in case of a mini-batch, the weight-changes are only collected and applied later
+    float* weightDeltas = nullptr;
+    if(segment.parentCluster->learnBatchSize > 1)
+    {
+        // the values of a section are reset, when it is deleted or allocated within the mini-batch
+        const uint64_t numberOfDeltas = segment.synapseArena.numberOfSections
+                                        * SECTION::numberOfSynapses;
+        if(segment.weightDeltas.size() < numberOfDeltas) {
+            segment.weightDeltas.resize(numberOfDeltas, 0.0f);
+        }
+        weightDeltas = segment.weightDeltas.data();
+    }
+
+    WorkerPool* workerPool = KyoukoRoot::getWorkerPool(segment.numaNode);
+    uint32_t numberOfWorker = 1;
+    if(workerPool != nullptr) {
+        numberOfWorker = workerPool->getNumberOfWorker();
+    }
 
     // run back-propagation over all internal neurons and synapses
-    const uint32_t numberOfBricks = segmentHeader->bricks.count;
-    for(int32_t pos = numberOfBricks - 1; pos >= 0; pos--)
+    for(int32_t level = segment.brickWavefronts.size() - 1; level >= 0; level--)
     {
-        const uint32_t brickId = brickOrder[pos];
-        Brick* brick = &bricks[brickId];
-        if(brick->isOutputBrick)
+        const std::vector<uint32_t> &wavefront = segment.brickWavefronts[level];
+        for(const uint32_t brickId : wavefront)
         {
-            if(backpropagateOutput(brick,
-                                   inputTransfers,
-                                   neuronSections,
-                                   dynamicSegmentSettings) == false)
+            Brick* brick = &bricks[brickId];
+            if(brick->isOutputBrick)
             {
-                return;
+                if(backpropagateOutput(brick,
+                                       inputTransfers,
+                                       neuronSections,
+                                       dynamicSegmentSettings,
+                                       deltaTracker) == false)
+                {
+                    return;
+                }
             }
         }
-        backpropagateNeurons(brick,
-                             neuronSections,
-                             synapseSections,
-                             updatePosSections,
-                             outputTransfers);
+
+        // the bricks of the wavefront don't share any synapses, so they can run at the same time
+        const uint32_t numberOfBricks = wavefront.size();
+        if(numberOfWorker > 1
+                && numberOfBricks > 1)
+        {
+            workerPool->runParallel([&](const uint32_t workerId)
+            {
+                for(uint32_t i = workerId; i < numberOfBricks; i += numberOfWorker)
+                {
+                    backpropagateNeurons(&bricks[wavefront[i]],
+                                         neuronSections,
+                                         synapseSections,
+                                         outputTransfers,
+                                         weightDeltas,
+                                         roundingSeed,
+                                         deltaTracker,
+                                         backpropagationBorder,
+                                         useFastMath);
+                }
+            });
+        }
+        else
+        {
+            for(const uint32_t brickId : wavefront)
+            {
+                backpropagateNeurons(&bricks[brickId],
+                                     neuronSections,
+                                     synapseSections,
+                                     outputTransfers,
+                                     weightDeltas,
+                                     roundingSeed,
+                                     deltaTracker,
+                                     backpropagationBorder,
+                                     useFastMath);
+            }
+        }
+    }
+}
+
+/**
+ * @brief apply the collected weight-changes of a mini-batch to the synapses and reset them. The
+ *        synapse-sections are split between the worker-threads. Sections, which were deleted
+ *        within the mini-batch, are skipped.
+ *
+ * @param segment segment to update
+ */
+template<typename SECTION>
+void
+applyWeightDeltas(DynamicSegment &segment)
+{
+    SECTION* synapseSections = reinterpret_cast<SECTION*>(segment.synapseSections);
+    float* weightDeltas = segment.weightDeltas.data();
+    const uint64_t numberOfSections = segment.weightDeltas.size() / SECTION::numberOfSynapses;
+    const uint32_t roundingSeed = segment.dynamicSegmentSettings->randomSeed
+                                  + segment.numberOfLearnSteps;
+
+    auto applyRange = [&](const uint64_t start, const uint64_t end)
+    {
+        for(uint64_t sectionId = start; sectionId < end; sectionId++)
+        {
+            SECTION* section = &synapseSections[sectionId];
+            float* sectionDeltas = &weightDeltas[sectionId * SECTION::numberOfSynapses];
+            if(section->active != Kitsunemimi::ItemBuffer::ACTIVE_SECTION)
+            {
+                std::fill_n(sectionDeltas, SECTION::numberOfSynapses, 0.0f);
+                continue;
+            }
+
+            for(uint32_t pos = 0; pos < SECTION::numberOfSynapses; pos++)
+            {
+                if(sectionDeltas[pos] != 0.0f)
+                {
+                    auto* synapse = &section->synapses[pos];
+                    updateWeight(synapse,
+                                 getWeight(synapse) - sectionDeltas[pos],
+                                 roundingSeed,
+                                 static_cast<uint32_t>(sectionId * SECTION::numberOfSynapses
+                                                       + pos));
+                    sectionDeltas[pos] = 0.0f;
+                }
+            }
+        }
+    };
+
+    WorkerPool* workerPool = KyoukoRoot::getWorkerPool(segment.numaNode);
+    if(workerPool == nullptr
+            || workerPool->getNumberOfWorker() == 1)
+    {
+        applyRange(0, numberOfSections);
+        return;
+    }
+
+    const uint32_t numberOfWorker = workerPool->getNumberOfWorker();
+    workerPool->runParallel([&](const uint32_t workerId) {
+        applyRange((numberOfSections * workerId) / numberOfWorker,
+                   (numberOfSections * (workerId + 1)) / numberOfWorker);
+    });
+}
+
+/**
+ * @brief correct wight of synapses with the section-type, which was selected at the creation
+ *        of the segment. In case of a mini-batch, the weight-changes are applied after the last
+ *        sample of the batch.
+ *
+ * @param segment segment to process
+ */
+inline void
+rewightDynamicSegment(DynamicSegment &segment)
+{
+    dispatchSectionType(*segment.dynamicSegmentSettings, [&](auto tag) {
+        rewightDynamicSegment<typename decltype(tag)::type>(segment);
+    });
+
+    if(segment.parentCluster->learnBatchSize > 1)
+    {
+        segment.numberOfDeltaSamples++;
+        if(segment.numberOfDeltaSamples >= segment.parentCluster->learnBatchSize) {
+            segment.applyWeightDeltas();
+        }
     }
 }
 
@@ -0,0 +1,247 @@
+/**
+ * @file        batch_processing.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_DYNAMIC_BATCH_PROCESSING_H
+#define KYOUKOMIND_DYNAMIC_BATCH_PROCESSING_H
+
+#include <common.h>
+
+#include <kyouko_root.h>
+#include <core/segments/brick.h>
+#include <core/processing/worker_pool.h>
+#include <core/fast_math.h>
+
+#include "objects.h"
+#include "dynamic_segment.h"
+#include "frozen_network.h"
+#include "neuron_batch.h"
+
+/**
+ * @brief update the neurons of a neuron-section for all samples of a batch
+ *
+ * @param section neuron-section to update
+ * @param neuronSectionId id of the neuron-section
+ * @param segment segment where the section belongs to
+ */
+inline void
+updateBatchNeuronSection(const NeuronSection* section,
+                         const uint32_t neuronSectionId,
+                         DynamicSegment &segment)
+{
+    NeuronBatch* batch = &segment.neuronBatch;
+    const DynamicSegmentSettings* settings = segment.dynamicSegmentSettings;
+    const Brick* brick = &segment.bricks[section->brickId];
+    const uint32_t batchSize = batch->batchSize;
+    const uint64_t sectionPos = static_cast<uint64_t>(neuronSectionId)
+                                * NEURON_LANES_PER_NEURONSECTION
+                                * batchSize;
+
+    for(uint32_t neuronId = 0; neuronId < section->numberOfNeurons; neuronId++)
+    {
+        const uint64_t neuronPos = sectionPos + neuronId * batchSize;
+        float* input = &batch->input[neuronPos];
+        float* potential = &batch->potential[neuronPos];
+        uint8_t* refractionTime = &batch->refractionTime[neuronPos];
+        const uint64_t borderPos = static_cast<uint64_t>(section->targetBorderId[neuronId])
+                                   * batchSize;
+
+        if(brick->isInputBrick)
+        {
+            const float* inputTransfers = &segment.batchInputTransfers[borderPos];
+            for(uint32_t sample = 0; sample < batchSize; sample++) {
+                potential[sample] = inputTransfers[sample];
+            }
+            continue;
+        }
+
+        if(brick->isOutputBrick)
+        {
+            float* outputTransfers = &segment.batchOutputTransfers[borderPos];
+            for(uint32_t sample = 0; sample < batchSize; sample++)
+            {
+                potential[sample] = settings->potentialOverflow * input[sample];
+                input[sample] = 0.0f;
+                outputTransfers[sample] = potential[sample];
+            }
+            continue;
+        }
+
+        const float border = section->border[neuronId];
+        for(uint32_t sample = 0; sample < batchSize; sample++)
+        {
+            float newPotential = potential[sample] / settings->neuronCooldown;
+            uint8_t newRefractionTime = refractionTime[sample] >> 1;
+            if(newRefractionTime == 0)
+            {
+                newPotential = settings->potentialOverflow * input[sample];
+                newRefractionTime = settings->refractionTime;
+            }
+
+            potential[sample] = newPotential - border;
+            refractionTime[sample] = newRefractionTime;
+            input[sample] = 0.0f;
+        }
+
+        applyLog2Activation(potential, batchSize, settings->fastMath != 0);
+    }
+}
+
+/**
+ * @brief process the frozen synapses of a neuron-section for a range of samples of a batch. Each
+ *        run of synapses is read only once and the synapses update the target-neurons of all
+ *        samples of the range. A sample, whose potential doesn't reach the threshold of a
+ *        synapse, adds zero, so the inner loop has no branches.
+ *
+ * @param section neuron-section to process
+ * @param neuronSectionId id of the neuron-section
+ * @param network frozen network of the segment
+ * @param batch batched state of the neurons
+ * @param firstSample first sample of the range
+ * @param endSample end of the range
+ */
+inline void
+processBatchSynapses(const NeuronSection* section,
+                     const uint32_t neuronSectionId,
+                     const FrozenNetwork* network,
+                     NeuronBatch* batch,
+                     const uint32_t firstSample,
+                     const uint32_t endSample)
+{
+    const uint32_t batchSize = batch->batchSize;
+    const uint64_t neuronPos = static_cast<uint64_t>(neuronSectionId)
+                               * NEURON_LANES_PER_NEURONSECTION;
+    const FrozenSynapse* synapses = network->synapses.data();
+    float* inputs = batch->input.data();
+
+    for(uint32_t neuronId = 0; neuronId < section->numberOfNeurons; neuronId++)
+    {
+        const float* potential = &batch->potential[(neuronPos + neuronId) * batchSize];
+
+        // the highest potential of all samples limits the part of the run, which is reached
+        float maxPotential = 0.0f;
+        for(uint32_t sample = firstSample; sample < endSample; sample++) {
+            maxPotential = std::max(maxPotential, potential[sample]);
+        }
+        if(maxPotential <= 0.0f) {
+            continue;
+        }
+
+        const FrozenSynapse* begin = &synapses[network->neuronOffsets[neuronPos + neuronId]];
+        const FrozenSynapse* end = &synapses[network->neuronOffsets[neuronPos + neuronId + 1]];
+        end = std::partition_point(begin, end, [maxPotential](const FrozenSynapse &synapse) {
+            return synapse.threshold < maxPotential;
+        });
+
+        for(const FrozenSynapse* synapse = begin; synapse < end; synapse++)
+        {
+            const uint64_t targetPos = static_cast<uint64_t>(synapse->targetNeuronSectionId)
+                                       * NEURON_LANES_PER_NEURONSECTION
+                                       + synapse->targetNeuronId;
+            float* targetInput = &inputs[targetPos * batchSize];
+            const float weight = synapse->weight;
+            const float threshold = synapse->threshold;
+            for(uint32_t sample = firstSample; sample < endSample; sample++) {
+                targetInput[sample] += weight * static_cast<float>(potential[sample] > threshold);
+            }
+        }
+    }
+}
+
+/**
+ * @brief process a frozen segment for all samples of a batch. The bricks are processed
+ *        wavefront by wavefront like in the single processing. For the synapses the batch is
+ *        split between the worker-threads, so each worker writes only its own samples and the
+ *        synapses are read once per worker instead of once per sample.
+ *
+ * @param segment segment to process
+ */
+inline void
+processBatchDynamicSegment(DynamicSegment &segment)
+{
+    NeuronSection* neuronSections = segment.neuronSections;
+    const FrozenNetwork* network = segment.frozenNetwork;
+    NeuronBatch* batch = &segment.neuronBatch;
+    std::vector<uint32_t> &sectionIds = segment.worklist.currentSections;
+    const uint32_t batchSize = batch->batchSize;
+
+    // split the batch in blocks of 8 samples to keep full vectors for each worker
+    WorkerPool* workerPool = KyoukoRoot::getWorkerPool(segment.numaNode);
+    uint32_t numberOfWorker = 1;
+    if(workerPool != nullptr) {
+        numberOfWorker = workerPool->getNumberOfWorker();
+    }
+    const uint32_t numberOfBlocks = (batchSize + 7) / 8;
+
+    for(const std::vector<uint32_t> &wavefront : segment.brickWavefronts)
+    {
+        sectionIds.clear();
+        for(const uint32_t brickId : wavefront)
+        {
+            const Brick* brick = &segment.bricks[brickId];
+            for(uint32_t i = 0; i < brick->numberOfNeuronSections; i++) {
+                sectionIds.push_back(brick->neuronSectionPos + i);
+            }
+        }
+
+        for(const uint32_t neuronSectionId : sectionIds) {
+            updateBatchNeuronSection(&neuronSections[neuronSectionId], neuronSectionId, segment);
+        }
+
+        if(numberOfWorker == 1
+                || numberOfBlocks == 1)
+        {
+            for(const uint32_t neuronSectionId : sectionIds)
+            {
+                processBatchSynapses(&neuronSections[neuronSectionId],
+                                     neuronSectionId,
+                                     network,
+                                     batch,
+                                     0,
+                                     batchSize);
+            }
+            continue;
+        }
+
+        workerPool->runParallel([&](const uint32_t workerId)
+        {
+            const uint32_t firstSample = ((numberOfBlocks * workerId) / numberOfWorker) * 8;
+            const uint32_t endSample = std::min(((numberOfBlocks * (workerId + 1))
+                                                 / numberOfWorker) * 8,
+                                                batchSize);
+            if(firstSample >= endSample) {
+                return;
+            }
+
+            for(const uint32_t neuronSectionId : sectionIds)
+            {
+                processBatchSynapses(&neuronSections[neuronSectionId],
+                                     neuronSectionId,
+                                     network,
+                                     batch,
+                                     firstSample,
+                                     endSample);
+            }
+        });
+    }
+}
+
+#endif // KYOUKOMIND_DYNAMIC_BATCH_PROCESSING_H
@@ -0,0 +1,68 @@
+/**
+ * @file        delta_tracker.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_DYNAMIC_DELTA_TRACKER_H
+#define KYOUKOMIND_DYNAMIC_DELTA_TRACKER_H
+
+#include <common.h>
+
+#include "objects.h"
+
+static_assert(NEURON_LANES_PER_NEURONSECTION <= 64,
+              "the delta-mask of a neuron-section must fit into 64 bit");
+
+/**
+ * @brief State of the deltas for the backpropagation. Most neurons have no delta, because they
+ *        were not active or their synapses only lead to neurons without delta. So for each
+ *        neuron-section a mask is stored, which neurons have a nonzero delta, and for each brick
+ *        the sum of the absolute deltas of its neurons. A synapse-section, whose target-section
+ *        has no delta, is not updated, and a brick, whose target-bricks together have a delta
+ *        below the border, is skipped completely. The values always describe the actual content
+ *        of the delta-arrays of the neuron-sections. They are only runtime-data and not part of
+ *        the segment-data or a snapshot.
+ */
+struct DeltaTracker
+{
+    std::vector<uint64_t> deltaMasks;
+    std::vector<float> brickDeltas;
+    std::vector<std::vector<uint32_t>> targetBricks;
+
+    /**
+     * @brief get the sum of the deltas of all bricks, which can be reached by the synapses of a
+     *        brick
+     *
+     * @param brickId id of the brick
+     *
+     * @return sum of the absolute deltas
+     */
+    inline float
+    getTargetDelta(const uint32_t brickId) const
+    {
+        float targetDelta = 0.0f;
+        for(const uint32_t targetId : targetBricks[brickId]) {
+            targetDelta += brickDeltas[targetId];
+        }
+        return targetDelta;
+    }
+};
+
+#endif // KYOUKOMIND_DYNAMIC_DELTA_TRACKER_H
@@ -33,32 +33,102 @@
 
 #include <libKitsunemimiHanamiCommon/structs.h>
 #include <core/segments/dynamic_segment/processing.h>
+#include <core/segments/dynamic_segment/worker_input_buffer.h>
+#include <core/segments/dynamic_segment/frozen_processing.h>
+#include <core/segments/dynamic_segment/backpropagation.h>
+
+#include <random>
 
 /**
  * @brief constructor
+ *
+ * @param synapseFormat format of the synapses of the new segment
+ * @param sectionGeometry geometry of the synapse-sections of the new segment
  */
-DynamicSegment::DynamicSegment()
+DynamicSegment::DynamicSegment(const SynapseFormat synapseFormat,
+                               const SectionGeometry sectionGeometry)
     : AbstractSegment()
 {
     m_type = DYNAMIC_SEGMENT;
+    m_synapseFormat = synapseFormat;
+    m_sectionGeometry = sectionGeometry;
 }
 
 /**
- * @brief constructor to create segment from a snapshot
+ * @brief constructor to create segment from a snapshot. The synapse-sections are not part of the
+ *        segment-data and have to be restored afterwards with restoreSynapseSections.
  *
  * @param data pointer to data with snapshot
  * @param dataSize size of snapshot in number of bytes
  */
 DynamicSegment::DynamicSegment(const void* data, const uint64_t dataSize)
-    : AbstractSegment(data, dataSize)
+    : AbstractSegment(data, SectionArena::getStaticSnapshotSize(data, dataSize))
 {
     m_type = DYNAMIC_SEGMENT;
 }
 
+/**
+ * @brief restore the synapse-sections from the snapshot of the segment, which has to be done
+ *        before reinitPointer
+ *
+ * @param data pointer to data with snapshot
+ * @param dataSize size of snapshot in number of bytes
+ * @param error reference for error-output
+ *
+ * @return false, if the snapshot is invalid or the arena can not be initialized, else true
+ */
+bool
+DynamicSegment::restoreSynapseSections(const void* data,
+                                       const uint64_t dataSize,
+                                       Kitsunemimi::ErrorContainer &error)
+{
+    // the synapse-sections are stored behind the static data
+    const uint64_t staticSize = SectionArena::getStaticSnapshotSize(data, dataSize);
+    if(staticSize < sizeof(SegmentHeader)
+            || segmentData.staticData == nullptr)
+    {
+        error.addMeesage("Snapshot of dynamic segment is invalid or has an unsupported format");
+        return false;
+    }
+
+    const uint8_t* staticData = static_cast<const uint8_t*>(segmentData.staticData);
+    const SegmentHeader* header = reinterpret_cast<const SegmentHeader*>(staticData);
+    if(header->settings.bytePos + sizeof(DynamicSegmentSettings) > staticSize)
+    {
+        error.addMeesage("Settings of dynamic segment are not within the snapshot");
+        return false;
+    }
+
+    const DynamicSegmentSettings* settings =
+            reinterpret_cast<const DynamicSegmentSettings*>(staticData + header->settings.bytePos);
+    if(synapseArena.initArena(header->synapseSections.count,
+                              getSectionSize(settings->synapseFormat, settings->sectionGeometry),
+                              KyoukoRoot::m_hugePageType) == false)
+    {
+        error.addMeesage("Failed to initialize the synapse-sections of dynamic segment");
+        return false;
+    }
+    bindToNumaNode(synapseArena.sections, synapseArena.getReservedSize());
+
+    if(synapseArena.restoreSnapshot(data, dataSize) == false)
+    {
+        error.addMeesage("Synapse-sections of the snapshot don't match the dynamic segment");
+        return false;
+    }
+
+    return true;
+}
+
 /**
  * @brief destructor
  */
-DynamicSegment::~DynamicSegment() {}
+DynamicSegment::~DynamicSegment()
+{
+    for(WorkerInputBuffer* buffer : workerBuffers) {
+        delete buffer;
+    }
+    delete frozenNetwork;
+}
 
 uint32_t
 getNumberOfNeuronSections(const uint32_t numberOfNeurons)
@@ -79,6 +149,17 @@ DynamicSegment::initGpu()
 {
     Kitsunemimi::ErrorContainer error;
 
+    // the structs of the kernel only mirror the layout of the default geometry with
+    // full-precision synapses, so segments with other layouts stay on the cpu
+    if(dynamicSegmentSettings->synapseFormat != DEFAULT_SYNAPSE_FORMAT
+            || dynamicSegmentSettings->sectionGeometry != DEFAULT_SECTION_GEOMETRY)
+    {
+        LOG_WARNING("segment '" + getName() + "' is not uploaded to the gpu, because the "
+                    "gpu-kernel only supports the default section-geometry with full-precision "
+                    "synapses");
+        return;
+    }
+
     // create data-object
     data = new Kitsunemimi::GpuData();
     data->numberOfWg.x = 20;
@@ -106,13 +187,11 @@ DynamicSegment::initGpu()
     assert(data->addBuffer("bricks",                 segmentHeader->bricks.count,             sizeof(Brick),                  false, bricks                    ));
     assert(data->addBuffer("brickOrder",             segmentHeader->brickOrder.count,         sizeof(uint32_t),               false, brickOrder                ));
     assert(data->addBuffer("neuronSections",         segmentHeader->neuronSections.count,     sizeof(NeuronSection),          false, neuronSections            ));
-    assert(data->addBuffer("synapseSections",        segmentHeader->synapseSections.count,    sizeof(SynapseSection),         false, synapseSections           ));
+    assert(data->addBuffer("synapseSections",        segmentHeader->synapseSections.count,    synapseArena.getSectionSize(),  false, synapseSections           ));
     assert(data->addBuffer("segmentHeader",          1,                                       sizeof(SegmentHeader),          false, segmentHeader             ));
     assert(data->addBuffer("dynamicSegmentSettings", 1,                                       sizeof(DynamicSegmentSettings), false, dynamicSegmentSettings    ));
     assert(data->addBuffer("inputTransfers",         segmentHeader->inputTransfers.count,     sizeof(float),                  false, inputTransfers            ));
     assert(data->addBuffer("outputTransfers",        segmentHeader->outputTransfers.count,    sizeof(float),                  false, outputTransfers           ));
-    assert(data->addBuffer("updatePosSections",      segmentHeader->updatePosSections.count,  sizeof(UpdatePosSection),       false, updatePosSections         ));
-    assert(data->addBuffer("randomValues",           NUMBER_OF_RAND_VALUES,                   sizeof(uint32_t),               false, KyoukoRoot::m_randomValues));
 
     if(KyoukoRoot::gpuInterface->initCopyToDevice(*data, error) == false) {
         LOG_ERROR(error);
@@ -122,18 +201,15 @@ DynamicSegment::initGpu()
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "prcessDynamicSegment", "brickOrder",             error));
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "prcessDynamicSegment", "neuronSections",         error));
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "prcessDynamicSegment", "synapseSections",        error));
-    assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "prcessDynamicSegment", "updatePosSections",      error));
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "prcessDynamicSegment", "segmentHeader",          error));
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "prcessDynamicSegment", "dynamicSegmentSettings", error));
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "prcessDynamicSegment", "inputTransfers",         error));
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "prcessDynamicSegment", "outputTransfers",        error));
-    assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "prcessDynamicSegment", "randomValues",           error));
 
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "rewightDynamicSegment", "bricks",                 error));
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "rewightDynamicSegment", "brickOrder",             error));
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "rewightDynamicSegment", "neuronSections",         error));
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "rewightDynamicSegment", "synapseSections",        error));
-    assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "rewightDynamicSegment", "updatePosSections",      error));
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "rewightDynamicSegment", "segmentHeader",          error));
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "rewightDynamicSegment", "dynamicSegmentSettings", error));
     assert(KyoukoRoot::gpuInterface->bindKernelToBuffer(*data, "rewightDynamicSegment", "inputTransfers",         error));
@@ -179,7 +255,9 @@ DynamicSegment::initSegment(const std::string &name,
                                            totalBorderSize);
 
     // initialize segment itself
-    allocateSegment(header);
+    if(allocateSegment(header) == false) {
+        return false;
+    }
     initSegmentPointer(header);
     initDefaultValues();
     dynamicSegmentSettings[0] = settings;
@@ -193,6 +271,8 @@ DynamicSegment::initSegment(const std::string &name,
     // init border
     initSlots(segmentMeta);
     connectBorderBuffer();
+    initWorklist();
+    initBrickWavefronts();
 
     // TODO: check result
     setName(name);
@@ -210,6 +290,11 @@ bool
 DynamicSegment::reinitPointer(const uint64_t numberOfBytes)
 {
     // TODO: checks
+    // the synapse-sections have to be restored at first
+    if(synapseArena.sections == nullptr) {
+        return false;
+    }
+
     uint8_t* dataPtr = static_cast<uint8_t*>(segmentData.staticData);
 
     uint64_t pos = 0;
@@ -249,24 +334,325 @@ DynamicSegment::reinitPointer(const uint64_t numberOfBytes)
     neuronSections = reinterpret_cast<NeuronSection*>(dataPtr + pos);
     byteCounter += segmentHeader->neuronSections.count * sizeof(NeuronSection);
 
-    pos = segmentHeader->updatePosSections.bytePos;
-    updatePosSections = reinterpret_cast<UpdatePosSection*>(dataPtr + pos);
-    byteCounter += segmentHeader->updatePosSections.count * sizeof(UpdatePosSection);
+    synapseSections = synapseArena.sections;
 
-    dataPtr = static_cast<uint8_t*>(segmentData.itemData);
-    //pos = segmentHeader->synapseSections.bytePos;
-    synapseSections = reinterpret_cast<SynapseSection*>(dataPtr);
-    byteCounter += segmentHeader->synapseSections.count * sizeof(SynapseSection);
+    // check result, before the runtime-data are derived from the restored data
+    const uint64_t expectedBytes = byteCounter
+                                   + ITEM_BUFFER_META_DATA_SIZE
+                                   + synapseArena.getSnapshotSize();
+    if(expectedBytes != numberOfBytes)
+    {
+        Kitsunemimi::ErrorContainer error;
+        error.addMeesage("Size of the snapshot of dynamic segment doesn't match its content: "
+                         + std::to_string(numberOfBytes) + " bytes instead of "
+                         + std::to_string(expectedBytes));
+        LOG_ERROR(error);
+        return false;
+    }
 
+    initChainTails();
+    initWorklist();
+    initBrickWavefronts();
     initGpu();
 
-    // check result
-    if(byteCounter != numberOfBytes - 48) {
-        std::cout<<"fail!!!!!!!!!!! byteCounter: "<<byteCounter<<"      numberOfBytes: "<<numberOfBytes<<std::endl;
-        return false;
+    return true;
+}
+
+/**
+ * @brief rebuild the tails of the synapse-chains of all neurons on restore. The tails are only
+ *        a shortcut to the last section of each chain, so they are derived from the restored
+ *        chains again and always match them, instead of trusting the values of the snapshot,
+ *        where a wrong tail would append new sections to the wrong chain.
+ */
+void
+DynamicSegment::initChainTails()
+{
+    dispatchSectionType(*dynamicSegmentSettings, [&](auto tag) {
+        typedef typename decltype(tag)::type SECTION;
+        const SECTION* sections = reinterpret_cast<const SECTION*>(synapseSections);
+
+        for(uint32_t sectionId = 0; sectionId < segmentHeader->neuronSections.count; sectionId++)
+        {
+            NeuronSection* section = &neuronSections[sectionId];
+            for(uint32_t neuronId = 0; neuronId < NEURON_LANES_PER_NEURONSECTION; neuronId++)
+            {
+                const uint32_t firstId = section->targetSectionId[neuronId];
+                section->chainTailId[neuronId] = UNINIT_STATE_32;
+                if(firstId != UNINIT_STATE_32) {
+                    section->chainTailId[neuronId] = getForwardLast(firstId, sections);
+                }
+            }
+        }
+    });
+}
+
+/**
+ * @brief (re-)create the buffers for the partial inputs of the worker-threads
+ *
+ * @param numberOfWorker number of workers, which process the segment
+ */
+void
+DynamicSegment::initWorkerBuffers(const uint32_t numberOfWorker)
+{
+    for(WorkerInputBuffer* buffer : workerBuffers) {
+        delete buffer;
     }
+    workerBuffers.clear();
 
-    return true;
+    for(uint32_t i = 0; i < numberOfWorker; i++) {
+        workerBuffers.push_back(new WorkerInputBuffer(segmentHeader->neuronSections.count));
+    }
+}
+
+/**
+ * @brief (re-)create the worklists of the normal bricks. At the beginning all neuron-sections of
+ *        the normal bricks are pending, because their state is not known to be settled. The
+ *        growth-requests are reset too.
+ */
+void
+DynamicSegment::initWorklist()
+{
+    const uint32_t numberOfBricks = segmentHeader->bricks.count;
+    worklist.brickLists.clear();
+    worklist.brickLists.resize(numberOfBricks);
+    worklist.trackedBricks.assign(numberOfBricks, 0);
+    worklist.pendingFlags.assign(segmentHeader->neuronSections.count, 0);
+    growthRequests.init(segmentHeader->neuronSections.count);
+
+    for(uint32_t brickId = 0; brickId < numberOfBricks; brickId++)
+    {
+        const Brick* brick = &bricks[brickId];
+        if(brick->isInputBrick
+                || brick->isOutputBrick)
+        {
+            continue;
+        }
+
+        worklist.trackedBricks[brickId] = 1;
+        for(uint32_t i = 0; i < brick->numberOfNeuronSections; i++) {
+            worklist.markSection(brick->neuronSectionPos + i, brickId);
+        }
+    }
+}
+
+/**
+ * @brief group the bricks into wavefronts, which can be processed one after another. A brick can
+ *        send synapse-outputs to all of its possible target-bricks, so each brick gets a level,
+ *        which is higher than the level of all bricks before it in the brick-order, which are
+ *        connected with it in any direction. Bricks with the same level don't feed each other
+ *        and can be processed at the same time. Additionally the bricks of each wavefront are
+ *        grouped by their type and the target-bricks of each brick are registered for the
+ *        sparse backpropagation. Bricks, which target their own neurons, are marked, because
+ *        their sections can not be processed in parallel.
+ */
+void
+DynamicSegment::initBrickWavefronts()
+{
+    const uint32_t numberOfBricks = segmentHeader->bricks.count;
+
+    // collect the connections between the bricks in both directions
+    std::vector<std::vector<uint32_t>> connections(numberOfBricks);
+    deltaTracker.targetBricks.clear();
+    deltaTracker.targetBricks.resize(numberOfBricks);
+    selfFeedingBricks.assign(numberOfBricks, 0);
+    for(uint32_t brickId = 0; brickId < numberOfBricks; brickId++)
+    {
+        const Brick* brick = &bricks[brickId];
+        if(brick->isOutputBrick) {
+            continue;
+        }
+
+        std::vector<uint32_t> targets;
+        if(brick->isTransactionBrick)
+        {
+            // transaction-bricks have no target-list, so use the direct neighbors instead
+            targets.assign(brick->neighbors, brick->neighbors + 12);
+        }
+        else
+        {
+            targets.assign(brick->possibleTargetNeuronBrickIds,
+                           brick->possibleTargetNeuronBrickIds + 1000);
+        }
+
+        std::sort(targets.begin(), targets.end());
+        targets.erase(std::unique(targets.begin(), targets.end()), targets.end());
+        for(const uint32_t targetId : targets)
+        {
+            if(targetId >= numberOfBricks) {
+                continue;
+            }
+
+            // a brick can also target its own neurons
+            if(targetId == brickId)
+            {
+                selfFeedingBricks[brickId] = 1;
+                deltaTracker.targetBricks[brickId].push_back(targetId);
+                continue;
+            }
+
+            connections[brickId].push_back(targetId);
+            connections[targetId].push_back(brickId);
+            deltaTracker.targetBricks[brickId].push_back(targetId);
+        }
+    }
+
+    // calculate the level of each brick based on the bricks before it in the brick-order
+    std::vector<uint32_t> orderPos(numberOfBricks, 0);
+    for(uint32_t pos = 0; pos < numberOfBricks; pos++) {
+        orderPos[brickOrder[pos]] = pos;
+    }
+
+    std::vector<uint32_t> levels(numberOfBricks, 0);
+    brickWavefronts.clear();
+    for(uint32_t pos = 0; pos < numberOfBricks; pos++)
+    {
+        const uint32_t brickId = brickOrder[pos];
+        uint32_t level = 0;
+        for(const uint32_t otherId : connections[brickId])
+        {
+            if(orderPos[otherId] < pos) {
+                level = std::max(level, levels[otherId] + 1);
+            }
+        }
+
+        levels[brickId] = level;
+        if(level >= brickWavefronts.size()) {
+            brickWavefronts.resize(level + 1);
+        }
+        brickWavefronts[level].push_back(brickId);
+    }
+
+    // group the bricks of each wavefront by their type
+    wavefrontSections.clear();
+    wavefrontSections.resize(brickWavefronts.size());
+    for(uint32_t level = 0; level < brickWavefronts.size(); level++)
+    {
+        WavefrontSections* sections = &wavefrontSections[level];
+        for(const uint32_t brickId : brickWavefronts[level])
+        {
+            const Brick* brick = &bricks[brickId];
+            std::vector<uint32_t>* target = nullptr;
+            if(brick->isInputBrick) {
+                target = &sections->inputSections;
+            } else if(brick->isOutputBrick) {
+                target = &sections->outputSections;
+            } else {
+                sections->normalBricks.push_back(brickId);
+                continue;
+            }
+
+            for(uint32_t i = 0; i < brick->numberOfNeuronSections; i++) {
+                target->push_back(brick->neuronSectionPos + i);
+            }
+        }
+    }
+
+    // take over the deltas, which are already stored in the neuron-sections
+    deltaTracker.deltaMasks.assign(segmentHeader->neuronSections.count, 0);
+    deltaTracker.brickDeltas.assign(numberOfBricks, 0.0f);
+    for(uint32_t sectionId = 0; sectionId < segmentHeader->neuronSections.count; sectionId++)
+    {
+        const NeuronSection* section = &neuronSections[sectionId];
+        for(uint32_t neuronId = 0; neuronId < section->numberOfNeurons; neuronId++)
+        {
+            if(section->delta[neuronId] != 0.0f)
+            {
+                deltaTracker.deltaMasks[sectionId] |= 1ull << neuronId;
+                deltaTracker.brickDeltas[section->brickId] += std::fabs(section->delta[neuronId]);
+            }
+        }
+    }
+}
+
+/**
+ * @brief compile the actual synapses into a read-only network, which is used for the processing
+ *        instead of the synapse-sections, until the segment is unfrozen again
+ */
+void
+DynamicSegment::freeze()
+{
+    if(frozenNetwork == nullptr) {
+        frozenNetwork = new FrozenNetwork();
+    }
+    compileFrozenNetwork(*this, *frozenNetwork);
+}
+
+/**
+ * @brief delete the frozen network and go back to the processing of the synapse-sections
+ */
+void
+DynamicSegment::unfreeze()
+{
+    delete frozenNetwork;
+    frozenNetwork = nullptr;
+
+    // the frozen processing doesn't update the worklist, so all sections have to be checked again
+    initWorklist();
+}
+
+/**
+ * @brief (re-)create the buffers for the batched processing. The neurons of all samples start
+ *        with the actual state of the neurons of the segment.
+ *
+ * @param batchSize number of samples, which are processed together
+ */
+void
+DynamicSegment::initBatch(const uint32_t batchSize)
+{
+    AbstractSegment::initBatch(batchSize);
+
+    const uint64_t numberOfNeurons = static_cast<uint64_t>(segmentHeader->neuronSections.count)
+                                     * NEURON_LANES_PER_NEURONSECTION;
+    neuronBatch.batchSize = batchSize;
+    neuronBatch.input.resize(numberOfNeurons * batchSize);
+    neuronBatch.potential.resize(numberOfNeurons * batchSize);
+    neuronBatch.refractionTime.resize(numberOfNeurons * batchSize);
+
+    for(uint64_t neuronPos = 0; neuronPos < numberOfNeurons; neuronPos++)
+    {
+        const NeuronSection* section = &neuronSections[neuronPos / NEURON_LANES_PER_NEURONSECTION];
+        const uint32_t neuronId = neuronPos % NEURON_LANES_PER_NEURONSECTION;
+        const uint64_t batchPos = neuronPos * batchSize;
+        std::fill_n(&neuronBatch.input[batchPos], batchSize, section->input[neuronId]);
+        std::fill_n(&neuronBatch.potential[batchPos], batchSize, section->potential[neuronId]);
+        std::fill_n(&neuronBatch.refractionTime[batchPos],
+                    batchSize,
+                    section->refractionTime[neuronId]);
+    }
+}
+
+/**
+ * @brief apply the collected weight-changes of a mini-batch to the synapses
+ */
+void
+DynamicSegment::applyWeightDeltas()
+{
+    if(numberOfDeltaSamples == 0) {
+        return;
+    }
+
+    dispatchSectionType(*dynamicSegmentSettings, [&](auto tag) {
+        ::applyWeightDeltas<typename decltype(tag)::type>(*this);
+    });
+    numberOfDeltaSamples = 0;
+}
+
+/**
+ * @brief reset the collected weight-changes of a synapse-section, which was freed or allocated
+ *        within a mini-batch, so the changes of a deleted section are never applied to a new
+ *        section with the same id
+ *
+ * @param sectionId id of the synapse-section
+ * @param numberOfSynapses number of synapses of a section
+ */
+void
+DynamicSegment::resetWeightDeltas(const uint32_t sectionId,
+                                  const uint32_t numberOfSynapses)
+{
+    const uint64_t pos = static_cast<uint64_t>(sectionId) * numberOfSynapses;
+    if(pos + numberOfSynapses <= weightDeltas.size()) {
+        std::fill_n(&weightDeltas[pos], numberOfSynapses, 0.0f);
+    }
 }
 
 /**
@@ -289,24 +675,21 @@ DynamicSegment::initializeNeurons(const Kitsunemimi::Hanami::SegmentMeta &segmen
         {
             const uint32_t sectionId = sectionPositionOffset + sectionCounter;
             NeuronSection* section = &neuronSections[sectionId];
-            UpdatePosSection* updatePosSection = &updatePosSections[sectionId];
 
             if(neuronsInBrick >= NEURONS_PER_NEURONSECTION)
             {
                 for(uint32_t i = 0; i < NEURONS_PER_NEURONSECTION; i++) {
-                    section->neurons[i].border = 0.0f;
+                    section->border[i] = 0.0f;
                 }
                 section->numberOfNeurons = NEURONS_PER_NEURONSECTION;
-                updatePosSection->numberOfPositions = NEURONS_PER_NEURONSECTION;
                 neuronsInBrick -= NEURONS_PER_NEURONSECTION;
             }
             else
             {
                 for(uint32_t i = 0; i < neuronsInBrick; i++) {
-                    section->neurons[i].border = 0.0f;
+                    section->border[i] = 0.0f;
                 }
                 section->numberOfNeurons = neuronsInBrick;
-                updatePosSection->numberOfPositions = neuronsInBrick;
                 break;
             }
             sectionCounter++;
@@ -345,7 +728,7 @@ DynamicSegment::connectBorderBuffer()
                 section = &neuronSections[brick->neuronSectionPos + j];
                 for(uint32_t k = 0; k < section->numberOfNeurons; k++)
                 {
-                    section->neurons[k].targetBorderId = transferCounter;
+                    section->targetBorderId[k] = transferCounter;
                     transferCounter++;
                 }
             }
@@ -365,7 +748,7 @@ DynamicSegment::connectBorderBuffer()
                 section = &neuronSections[brick->neuronSectionPos + j];
                 for(uint32_t k = 0; k < section->numberOfNeurons; k++)
                 {
-                    section->neurons[k].targetBorderId = transferCounter;
+                    section->targetBorderId[k] = transferCounter;
                     transferCounter++;
                 }
             }
@@ -391,6 +774,12 @@ DynamicSegment::initSettings(const Kitsunemimi::Hanami::SegmentMeta &segmentMeta
     settings.synapseSegmentation = segmentMeta.synapseSegmentation;
     settings.signNeg = segmentMeta.signNeg;
     settings.maxSynapseSections = segmentMeta.maxSynapseSections;
+    // all random-values of the segment are derived from this seed with the counter-based
+    // random-generator, so only the seed itself needs a real source of randomness
+    std::random_device randomDevice;
+    settings.randomSeed = randomDevice();
+    settings.synapseFormat = m_synapseFormat;
+    settings.sectionGeometry = m_sectionGeometry;
 
     return settings;
 }
@@ -430,11 +819,6 @@ DynamicSegment::createNewHeader(const uint32_t numberOfBricks,
     segmentHeader.neuronSections.bytePos = segmentDataPos;
     segmentDataPos += numberOfNeuronSections * sizeof(NeuronSection);
 
-    // init section-updates
-    segmentHeader.updatePosSections.count = numberOfNeuronSections;
-    segmentHeader.updatePosSections.bytePos = segmentDataPos;
-    segmentDataPos += numberOfNeuronSections * sizeof(UpdatePosSection);
-
     segmentHeader.staticDataSize = segmentDataPos;
 
     // init synapse sections
@@ -483,24 +867,35 @@ DynamicSegment::initSegmentPointer(const SegmentHeader &header)
     pos = segmentHeader->neuronSections.bytePos;
     neuronSections = reinterpret_cast<NeuronSection*>(dataPtr + pos);
 
-    pos = segmentHeader->updatePosSections.bytePos;
-    updatePosSections = reinterpret_cast<UpdatePosSection*>(dataPtr + pos);
-
-    dataPtr = static_cast<uint8_t*>(segmentData.itemData);
-    pos = segmentHeader->synapseSections.bytePos;
-    synapseSections = reinterpret_cast<SynapseSection*>(dataPtr + pos);
+    synapseSections = synapseArena.sections;
 }
 
 /**
- * @brief allocate memory for the segment
+ * @brief allocate memory for the segment. The synapse-sections are stored in their own arena,
+ *        where the memory for the maximum number of sections is only reserved and not allocated.
  *
  * @param header header with the size-information
+ *
+ * @return false, if the buffer or the arena couldn't be reserved, else true
  */
-void
+bool
 DynamicSegment::allocateSegment(SegmentHeader &header)
 {
-    segmentData.initBuffer<SynapseSection>(header.synapseSections.count, header.staticDataSize);
-    segmentData.deleteAll();
+    if(segmentData.initBuffer(header.staticDataSize) == false) {
+        return false;
+    }
+    prepareSegmentData();
+
+    // bind the arena before the first touch, so all new blocks are created on the node
+    if(synapseArena.initArena(header.synapseSections.count,
+                              getSectionSize(m_synapseFormat, m_sectionGeometry),
+                              KyoukoRoot::m_hugePageType) == false)
+    {
+        return false;
+    }
+    bindToNumaNode(synapseArena.sections, synapseArena.getReservedSize());
+
+    return true;
 }
 
 /**
@@ -527,11 +922,6 @@ DynamicSegment::initDefaultValues()
         neuronSections[i] = NeuronSection();
         neuronSections[i].id = i;
     }
-
-    // init section-updates
-    for(uint32_t i = 0; i < segmentHeader->updatePosSections.count; i++) {
-        updatePosSections[i] = UpdatePosSection();
-    }
 }
 
 /**
@@ -583,7 +973,6 @@ DynamicSegment::addBricksToSegment(const Kitsunemimi::Hanami::SegmentMeta &segme
     uint32_t neuronBrickIdCounter = 0;
     uint32_t neuronSectionPosCounter = 0;
     NeuronSection* section = nullptr;
-    uint32_t neuronIdCounter = 0;
 
     for(uint32_t i = 0; i < segmentMeta.bricks.size(); i++)
     {
@@ -594,11 +983,6 @@ DynamicSegment::addBricksToSegment(const Kitsunemimi::Hanami::SegmentMeta &segme
         {
             section = &neuronSections[j + neuronSectionPosCounter];
             section->brickId = newBrick.brickId;
-            for(uint32_t k = 0; k < section->numberOfNeurons; k++)
-            {
-                section->neurons[k].id = neuronIdCounter;
-                neuronIdCounter++;
-            }
         }
 
         // copy new brick to segment
@@ -659,12 +1043,19 @@ DynamicSegment::connectAllBricks()
  *
  * @param currentBrick actual brick
  * @param maxPathLength maximum path length left
+ * @param randomKey key of the random-stream of the path
+ * @param randomPos position within the random-stream, which is increased for each value
  *
  * @return last brick-id of the gone path
  */
 uint32_t
-DynamicSegment::goToNextInitBrick(Brick* currentBrick, uint32_t* maxPathLength)
+DynamicSegment::goToNextInitBrick(Brick* currentBrick,
+                                  uint32_t* maxPathLength,
+                                  const uint32_t randomKey,
+                                  uint32_t* randomPos)
 {
+    const uint32_t seed = dynamicSegmentSettings->randomSeed;
+
     // check path-length to not go too far
     (*maxPathLength)--;
     if(*maxPathLength == 0) {
@@ -673,19 +1064,21 @@ DynamicSegment::goToNextInitBrick(Brick* currentBrick, uint32_t* maxPathLength)
 
     // check based on the chance, if you go to the next, or not
     const float chanceForNext = 0.0f;  // TODO: make hard-coded value configurable
-    if(1000.0f * chanceForNext > (rand() % 1000)) {
+    (*randomPos)++;
+    if(1000.0f * chanceForNext > (getRandomValue(seed, randomKey, *randomPos) % 1000)) {
         return currentBrick->brickId;
     }
 
     // get a random possible next brick
     const uint8_t possibleNextSides[7] = {9, 3, 1, 4, 11, 5, 2};
-    const uint8_t startSide = possibleNextSides[rand() % 7];
+    (*randomPos)++;
+    const uint8_t startSide = possibleNextSides[getRandomValue(seed, randomKey, *randomPos) % 7];
     for(uint32_t i = 0; i < 7; i++)
     {
         const uint8_t side = possibleNextSides[(i + startSide) % 7];
         const uint32_t nextBrickId = currentBrick->neighbors[side];
         if(nextBrickId != UNINIT_STATE_32) {
-            return goToNextInitBrick(&bricks[nextBrickId], maxPathLength);
+            return goToNextInitBrick(&bricks[nextBrickId], maxPathLength, randomKey, randomPos);
         }
     }
 
@@ -713,11 +1106,16 @@ DynamicSegment::initTargetBrickList()
             continue;
         }
 
-        // test 1000 samples for possible next bricks
+        // test 1000 samples for possible next bricks, which all use the random-stream of the
+        // base-brick
+        uint32_t randomPos = 0;
         for(uint32_t counter = 0; counter < 1000; counter++)
         {
             uint32_t maxPathLength = 2; // TODO: make configurable
-            const uint32_t brickId = goToNextInitBrick(baseBrick, &maxPathLength);
+            const uint32_t brickId = goToNextInitBrick(baseBrick,
+                                                       &maxPathLength,
+                                                       baseBrick->brickId,
+                                                       &randomPos);
             if(brickId == baseBrick->brickId)
             {
                 LOG_WARNING("brick has no next brick and is a dead-end. Brick-ID: "
@@ -27,32 +27,93 @@
 
 #include <core/segments/abstract_segment.h>
 #include "objects.h"
+#include "neuron_worklist.h"
+#include "delta_tracker.h"
+#include "growth_requests.h"
+#include "neuron_batch.h"
+#include "section_arena.h"
+
+struct WorkerInputBuffer;
+struct FrozenNetwork;
 
 namespace Kitsunemimi {
 class GpuData;
 }
 
+/**
+ * @brief Bricks of a wavefront grouped by their type, so each group can be processed by its own
+ *        specialized loop. Input- and output-bricks are always processed completely, so their
+ *        neuron-sections are listed directly.
+ */
+struct WavefrontSections
+{
+    std::vector<uint32_t> inputSections;
+    std::vector<uint32_t> normalBricks;
+    std::vector<uint32_t> outputSections;
+};
+
 class DynamicSegment
         : public AbstractSegment
 {
 public:
-    DynamicSegment();
+    DynamicSegment(const SynapseFormat synapseFormat = DEFAULT_SYNAPSE_FORMAT,
+                   const SectionGeometry sectionGeometry = DEFAULT_SECTION_GEOMETRY);
     DynamicSegment(const void* data, const uint64_t dataSize);
     ~DynamicSegment();
 
     bool initSegment(const std::string &name,
                      const Kitsunemimi::Hanami::SegmentMeta &segmentMeta);
+    bool restoreSynapseSections(const void* data,
+                                const uint64_t dataSize,
+                                Kitsunemimi::ErrorContainer &error);
     bool reinitPointer(const uint64_t numberOfBytes);
+    void initWorkerBuffers(const uint32_t numberOfWorker);
+    void initWorklist();
+    void initChainTails();
+    void initBrickWavefronts();
+    void freeze();
+    void unfreeze();
+    void initBatch(const uint32_t batchSize);
+    void applyWeightDeltas();
+    void resetWeightDeltas(const uint32_t sectionId, const uint32_t numberOfSynapses);
 
     Brick* bricks = nullptr;
     uint32_t* brickOrder = nullptr;
     NeuronSection* neuronSections = nullptr;
-    SynapseSection* synapseSections = nullptr;
-    UpdatePosSection* updatePosSections = nullptr;
+    // the type of the sections depends on the settings and is selected by the processing
+    void* synapseSections = nullptr;
+
+    SectionArena synapseArena;
 
     Kitsunemimi::GpuData* data = nullptr;
 
+    // runtime-buffers for the parallel processing, which are not part of the segment-data
+    std::vector<WorkerInputBuffer*> workerBuffers;
+    NeuronWorklist worklist;
+    GrowthRequests growthRequests;
+    std::vector<std::vector<uint32_t>> brickWavefronts;
+    std::vector<WavefrontSections> wavefrontSections;
+    std::vector<uint8_t> selfFeedingBricks;
+    DeltaTracker deltaTracker;
+    FrozenNetwork* frozenNetwork = nullptr;
+    NeuronBatch neuronBatch;
+
+    // collected weight-changes of a mini-batch for each synapse
+    std::vector<float> weightDeltas;
+    uint32_t numberOfDeltaSamples = 0;
+
+    // counter of the learn-steps for the stochastic rounding of compact weights
+    uint32_t numberOfLearnSteps = 0;
+
+    // next neuron-section for the incremental reduction of the synapses
+    uint32_t reductionPos = 0;
+    uint32_t cyclesToReduction = 0;
+    bool sectionLimitReached = false;
+
 private:
+    SynapseFormat m_synapseFormat = DEFAULT_SYNAPSE_FORMAT;
+    SectionGeometry m_sectionGeometry = DEFAULT_SECTION_GEOMETRY;
+
     DynamicSegmentSettings initSettings(const Kitsunemimi::Hanami::SegmentMeta &segmentMeta);
     SegmentHeader createNewHeader(const uint32_t numberOfBricks,
                                   const uint32_t numberOfNeuronSections,
@@ -60,7 +121,7 @@ private:
                                   const uint64_t borderbufferSize);
     void initSegmentPointer(const SegmentHeader &header);
     bool connectBorderBuffer();
-    void allocateSegment(SegmentHeader &header);
+    bool allocateSegment(SegmentHeader &header);
     void initDefaultValues();
     void initGpu();
 
@@ -71,7 +132,10 @@ private:
     void connectBrick(Brick *sourceBrick, const uint8_t side);
     void connectAllBricks();
     bool initializeNeurons(const Kitsunemimi::Hanami::SegmentMeta &segmentMeta);
-    uint32_t goToNextInitBrick(Brick* currentBrick, uint32_t* maxPathLength);
+    uint32_t goToNextInitBrick(Brick* currentBrick,
+                               uint32_t* maxPathLength,
+                               const uint32_t randomKey,
+                               uint32_t* randomPos);
     bool initSlots(const Kitsunemimi::Hanami::SegmentMeta &segmentMeta);
 };
 
@@ -0,0 +1,58 @@
+/**
+ * @file        frozen_network.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_DYNAMIC_FROZEN_NETWORK_H
+#define KYOUKOMIND_DYNAMIC_FROZEN_NETWORK_H
+
+#include <common.h>
+
+struct FrozenSynapse
+{
+    uint32_t targetNeuronSectionId = 0;
+    uint16_t targetNeuronId = 0;
+    uint8_t padding[2];
+    float weight = 0.0f;
+
+    // the synapse is only reached, if the potential of the source-neuron is above this value
+    float threshold = 0.0f;
+
+    // total size: 16 Byte
+};
+
+/**
+ * @brief Read-only copy of the synapses of a trained segment in CSR-format. The synapses of each
+ *        neuron are stored as one contiguous run, ordered like in the synapse-chain, and the
+ *        consumption of the incoming weight by the borders of the synapses is resolved into a
+ *        threshold per synapse. The thresholds within a run are not decreasing, so the reached
+ *        part of a run can be found by a single search. The network is only runtime-data and
+ *        not part of the segment-data or a snapshot.
+ */
+struct FrozenNetwork
+{
+    // start of the run of each neuron in the synapse-list with the index
+    // (neuronSectionId * NEURON_LANES_PER_NEURONSECTION + neuronId) and the end of the list as
+    // last entry
+    std::vector<uint64_t> neuronOffsets;
+    std::vector<FrozenSynapse> synapses;
+};
+
+#endif // KYOUKOMIND_DYNAMIC_FROZEN_NETWORK_H
@@ -0,0 +1,301 @@
+/**
+ * @file        frozen_processing.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_DYNAMIC_FROZEN_PROCESSING_H
+#define KYOUKOMIND_DYNAMIC_FROZEN_PROCESSING_H
+
+#include <common.h>
+
+#include <kyouko_root.h>
+#include <core/segments/brick.h>
+#include <core/processing/worker_pool.h>
+
+#include "objects.h"
+#include "dynamic_segment.h"
+#include "frozen_network.h"
+#include "neuron_kernels.h"
+#include "synapse_access.h"
+#include "worker_input_buffer.h"
+#include "processing.h"
+#include "section_geometry.h"
+
+/**
+ * @brief compile the synapse-chains of all neurons of a segment into a frozen network
+ *
+ * @param segment segment to compile
+ * @param network network to fill
+ */
+template<typename SECTION>
+inline void
+compileFrozenNetwork(const DynamicSegment &segment,
+                     FrozenNetwork &network)
+{
+    Brick* bricks = segment.bricks;
+    NeuronSection* neuronSections = segment.neuronSections;
+    SECTION* synapseSections = reinterpret_cast<SECTION*>(segment.synapseSections);
+    const uint32_t numberOfNeuronSections = segment.segmentHeader->neuronSections.count;
+
+    network.synapses.clear();
+    network.neuronOffsets.assign(static_cast<uint64_t>(numberOfNeuronSections)
+                                 * NEURON_LANES_PER_NEURONSECTION + 1, 0);
+
+    uint64_t neuronPos = 0;
+    for(uint32_t neuronSectionId = 0;
+        neuronSectionId < numberOfNeuronSections;
+        neuronSectionId++)
+    {
+        const NeuronSection* section = &neuronSections[neuronSectionId];
+        const bool isOutput = bricks[section->brickId].isOutputBrick;
+
+        for(uint32_t neuronId = 0; neuronId < NEURON_LANES_PER_NEURONSECTION; neuronId++)
+        {
+            network.neuronOffsets[neuronPos] = network.synapses.size();
+            neuronPos++;
+
+            const uint32_t targetSectionId = section->targetSectionId[neuronId];
+            if(isOutput
+                    || neuronId >= section->numberOfNeurons
+                    || targetSectionId == UNINIT_STATE_32)
+            {
+                continue;
+            }
+
+            // follow the chain like the forward-pass and sum up the borders, which reduce the
+            // incoming weight before a synapse is reached
+            const SECTION* synapseSection = &synapseSections[targetSectionId];
+            float consumed = 0.0f;
+            float threshold = 0.0f;
+            while(true)
+            {
+                for(uint32_t pos = 0; pos < SECTION::numberOfSynapses; pos++)
+                {
+                    const auto* synapse = &synapseSection->synapses[pos];
+                    threshold = std::max(threshold, consumed);
+                    if(synapse->targetNeuronId != UNINIT_STATE_16)
+                    {
+                        FrozenSynapse frozenSynapse;
+                        frozenSynapse.targetNeuronSectionId = synapseSection->targetNeuronSectionId;
+                        frozenSynapse.targetNeuronId = synapse->targetNeuronId;
+                        frozenSynapse.weight = getWeight(synapse);
+                        frozenSynapse.threshold = threshold;
+                        network.synapses.push_back(frozenSynapse);
+                        consumed += getBorder(synapse);
+                    }
+                }
+
+                // the next section is only reached, if more than 0.01 of the weight is left
+                threshold = std::max(threshold, consumed + 0.01f);
+                if(synapseSection->nextId == UNINIT_STATE_32) {
+                    break;
+                }
+                synapseSection = &synapseSections[synapseSection->nextId];
+            }
+        }
+    }
+
+    network.neuronOffsets[neuronPos] = network.synapses.size();
+    network.synapses.shrink_to_fit();
+}
+
+/**
+ * @brief compile the synapse-chains of a segment with the synapse-format, which was selected at
+ *        the creation of the segment, into a frozen network
+ *
+ * @param segment segment to compile
+ * @param network network to fill
+ */
+inline void
+compileFrozenNetwork(const DynamicSegment &segment,
+                     FrozenNetwork &network)
+{
+    dispatchSectionType(*segment.dynamicSegmentSettings, [&](auto tag) {
+        compileFrozenNetwork<typename decltype(tag)::type>(segment, network);
+    });
+}
+
+/**
+ * @brief process the frozen synapses of all active neurons of a neuron-section
+ *
+ * @param section neuron-section to process
+ * @param neuronSectionId id of the neuron-section
+ * @param network frozen network of the segment
+ * @param neuronSections pointer to all neuron-sections of the segment
+ * @param workerBuffer buffer for the partial inputs of a worker in case of parallel processing,
+ *                     nullptr to write the inputs directly into the target-neurons
+ */
+inline void
+processFrozenSynapses(const NeuronSection* section,
+                      const uint32_t neuronSectionId,
+                      const FrozenNetwork* network,
+                      NeuronSection* neuronSections,
+                      WorkerInputBuffer* workerBuffer)
+{
+    const uint64_t neuronPos = static_cast<uint64_t>(neuronSectionId)
+                               * NEURON_LANES_PER_NEURONSECTION;
+    const FrozenSynapse* synapses = network->synapses.data();
+
+    for(uint32_t neuronId = 0; neuronId < section->numberOfNeurons; neuronId++)
+    {
+        if(section->active[neuronId] == 0) {
+            continue;
+        }
+
+        // find the end of the reached part of the run
+        const float potential = section->potential[neuronId];
+        const FrozenSynapse* begin = &synapses[network->neuronOffsets[neuronPos + neuronId]];
+        const FrozenSynapse* end = &synapses[network->neuronOffsets[neuronPos + neuronId + 1]];
+        end = std::partition_point(begin, end, [potential](const FrozenSynapse &synapse) {
+            return synapse.threshold < potential;
+        });
+
+        if(workerBuffer == nullptr)
+        {
+            for(const FrozenSynapse* synapse = begin; synapse < end; synapse++)
+            {
+                NeuronSection* targetSection = &neuronSections[synapse->targetNeuronSectionId];
+                targetSection->input[synapse->targetNeuronId] += synapse->weight;
+            }
+        }
+        else
+        {
+            for(const FrozenSynapse* synapse = begin; synapse < end; synapse++)
+            {
+                float* inputs = workerBuffer->getSectionInputs(synapse->targetNeuronSectionId);
+                inputs[synapse->targetNeuronId] += synapse->weight;
+            }
+        }
+    }
+}
+
+/**
+ * @brief update the neurons of a neuron-section of a frozen segment
+ *
+ * @param section neuron-section to update
+ * @param segment segment where the section belongs to
+ */
+inline void
+updateFrozenNeuronSection(NeuronSection* section,
+                          DynamicSegment &segment)
+{
+    const Brick* brick = &segment.bricks[section->brickId];
+    if(brick->isOutputBrick) {
+        processOutputNeuronSection(section, segment.outputTransfers, segment.dynamicSegmentSettings);
+    } else if(brick->isInputBrick) {
+        processInputNeuronSection(section, segment.inputTransfers);
+    } else if(isEventDriven(segment.dynamicSegmentSettings)) {
+        processNeuronSection<true>(section, segment.dynamicSegmentSettings);
+    } else {
+        processNeuronSection<false>(section, segment.dynamicSegmentSettings);
+    }
+}
+
+/**
+ * @brief process a frozen segment. In contrast to the normal forward-pass no synapses are
+ *        created, no active-counters are updated and no new sections are requested. All
+ *        neuron-sections of a wavefront are processed and split between the worker-threads
+ *        in the same 3 steps like in the normal parallel processing.
+ *
+ * @param segment segment to process
+ */
+inline void
+processFrozenDynamicSegment(DynamicSegment &segment)
+{
+    NeuronSection* neuronSections = segment.neuronSections;
+    const FrozenNetwork* network = segment.frozenNetwork;
+    std::vector<uint32_t> &sectionIds = segment.worklist.currentSections;
+    std::vector<WorkerInputBuffer*> &workerBuffers = segment.workerBuffers;
+
+    WorkerPool* workerPool = KyoukoRoot::getWorkerPool(segment.numaNode);
+    uint32_t numberOfWorker = 1;
+    if(workerPool != nullptr) {
+        numberOfWorker = workerPool->getNumberOfWorker();
+    }
+
+    const uint32_t minParallelSections = numberOfWorker * MIN_NEURON_SECTIONS_PER_WORKER;
+    if(numberOfWorker > 1
+            && workerBuffers.size() != numberOfWorker)
+    {
+        segment.initWorkerBuffers(numberOfWorker);
+    }
+
+    for(const std::vector<uint32_t> &wavefront : segment.brickWavefronts)
+    {
+        sectionIds.clear();
+        for(const uint32_t brickId : wavefront)
+        {
+            const Brick* brick = &segment.bricks[brickId];
+            for(uint32_t i = 0; i < brick->numberOfNeuronSections; i++) {
+                sectionIds.push_back(brick->neuronSectionPos + i);
+            }
+        }
+
+        const uint32_t numberOfSections = sectionIds.size();
+        if(numberOfWorker == 1
+                || numberOfSections < minParallelSections)
+        {
+            for(const uint32_t neuronSectionId : sectionIds)
+            {
+                NeuronSection* section = &neuronSections[neuronSectionId];
+                updateFrozenNeuronSection(section, segment);
+                processFrozenSynapses(section, neuronSectionId, network, neuronSections, nullptr);
+            }
+            continue;
+        }
+
+        // update neurons
+        workerPool->runParallel([&](const uint32_t workerId)
+        {
+            const uint32_t start = (numberOfSections * workerId) / numberOfWorker;
+            const uint32_t end = (numberOfSections * (workerId + 1)) / numberOfWorker;
+            for(uint32_t i = start; i < end; i++) {
+                updateFrozenNeuronSection(&neuronSections[sectionIds[i]], segment);
+            }
+        });
+
+        // process synapses into the worker-buffers
+        workerPool->runParallel([&](const uint32_t workerId)
+        {
+            const uint32_t start = (numberOfSections * workerId) / numberOfWorker;
+            const uint32_t end = (numberOfSections * (workerId + 1)) / numberOfWorker;
+            for(uint32_t i = start; i < end; i++)
+            {
+                const uint32_t neuronSectionId = sectionIds[i];
+                processFrozenSynapses(&neuronSections[neuronSectionId],
+                                      neuronSectionId,
+                                      network,
+                                      neuronSections,
+                                      workerBuffers[workerId]);
+            }
+        });
+
+        // add worker-buffers to the neurons
+        workerPool->runParallel([&](const uint32_t workerId) {
+            reduceWorkerInputs(workerId, neuronSections, workerBuffers);
+        });
+
+        for(WorkerInputBuffer* buffer : workerBuffers) {
+            buffer->resetTouchedSections();
+        }
+    }
+}
+
+#endif // KYOUKOMIND_DYNAMIC_FROZEN_PROCESSING_H
@@ -28,10 +28,11 @@
 #define UNINIT_STATE_8  0xFF
 
 // common information
+// The synapse-sections only match the default section-geometry with full-precision synapses of
+// the host. Segments with other geometries or compact synapses are not uploaded to the gpu.
 #define SYNAPSES_PER_SYNAPSESECTION 30
 #define NEURONS_PER_NEURONSECTION 62
-#define NUMBER_OF_RAND_VALUES 10485760
-#define RAND_MAX 2147483647
+#define NEURON_LANES_PER_NEURONSECTION 64
 
 typedef struct kuuid_struct
 {
@@ -100,27 +101,6 @@ typedef struct SegmentHeader_struct
 
 //==================================================================================================
 
-typedef struct DynamicNeuron_struct
-{
-    float input;
-    float border;
-    float potential;
-    float delta;
-
-    uchar refractionTime;
-    uchar active;
-    uchar padding[2];
-
-    uint id;
-
-    uint targetBorderId;
-    uint targetSectionId;
-
-    // total size: 32 Byte
-} DynamicNeuron;
-
-//==================================================================================================
-
 typedef struct Synapse_struct
 {
     float weight;
@@ -158,12 +138,21 @@ typedef struct Brick_struct
 
 typedef struct NeuronSection_struct
 {
-    DynamicNeuron neurons[NEURONS_PER_NEURONSECTION];
+    float input[NEURON_LANES_PER_NEURONSECTION];
+    float border[NEURON_LANES_PER_NEURONSECTION];
+    float potential[NEURON_LANES_PER_NEURONSECTION];
+    float delta[NEURON_LANES_PER_NEURONSECTION];
+    uint targetBorderId[NEURON_LANES_PER_NEURONSECTION];
+    uint targetSectionId[NEURON_LANES_PER_NEURONSECTION];
+    uint chainTailId[NEURON_LANES_PER_NEURONSECTION];
+    uchar refractionTime[NEURON_LANES_PER_NEURONSECTION];
+    uchar active[NEURON_LANES_PER_NEURONSECTION];
+
     uint numberOfNeurons;
     uint id;
     uint brickId;
     uint backwardNextId;
-    uchar padding[48];
+    uchar padding[112];
     // total size: 2048 Byte
 } NeuronSection;
 
@@ -224,19 +213,54 @@ typedef struct DynamicSegmentSettings_struct
     uchar refractionTime;
     uchar doLearn;
     uchar updateSections;
+    uchar synapseFormat;
+    uint randomSeed;
+    uchar fastMath;
+    uchar sectionGeometry;
+    uchar padding1[2];
+    float synapsePruneBorder;
 
-    uchar padding[213];
+    uchar padding[200];
 
     // total size: 256 Byte
 } DynamicSegmentSettings;
 
 //==================================================================================================
 
+/**
+ * @brief stateless counter-based random-generator, which is the same like getRandomValue in the
+ *        cpu-code, so both give the same values
+ *
+ * @param seed seed of the segment
+ * @param key key of the random-stream
+ * @param counter position within the random-stream
+ *
+ * @return 32-bit random-value
+ */
+inline uint
+getRandomValue(const uint seed, const uint key, const uint counter)
+{
+    ulong z = ((ulong)(key) << 32) | (ulong)(counter);
+    z += ((ulong)(seed) + 1) * 0x9E3779B97F4A7C15UL;
+    z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9UL;
+    z = (z ^ (z >> 27)) * 0x94D049BB133111EBUL;
+    z = z ^ (z >> 31);
+    return (uint)(z >> 32);
+}
+
+/**
+ * @brief get counter-based random-value in range [0, 1)
+ */
+inline float
+getRandomFloat(const uint seed, const uint key, const uint counter)
+{
+    return (float)(getRandomValue(seed, key, counter) >> 8) / 16777216.0f;
+}
+
 inline void
 initNewSection(const uint position,
                __global SynapseSection* synapseSections,
-               __global UpdatePos* updatePos,
-               __global const uint* randomValues)
+               __global UpdatePos* updatePos)
 {
     __global SynapseSection* targetSection = &synapseSections[position];
     targetSection->active = 1;
@@ -256,35 +280,35 @@ initNewSection(const uint position,
  */
 inline void
 createNewSynapse(__global SynapseSection* section,
+                 const uint sectionId,
                  __global Synapse* synapse,
                  __global const NeuronSection* neuronSections,
                  __global const DynamicSegmentSettings* segmentSettings,
                  const float remainingWeight,
-                 const float outH,
-                 __global const uint* randomValues)
+                 const float outH)
 {
-    const float randMax = (float)(RAND_MAX);
+    const uint seed = segmentSettings->randomSeed;
     const float maxWeight = outH / (float)(segmentSettings->synapseSegmentation);
     uint signRand = 0;
     const float sigNeg = 0.5f;
 
     // set activation-border
-    section->randomPos = (section->randomPos + 1) % NUMBER_OF_RAND_VALUES;
-    float newWeight = maxWeight * ((float)(randomValues[section->randomPos]) / randMax);
+    section->randomPos++;
+    float newWeight = maxWeight * getRandomFloat(seed, sectionId, section->randomPos);
     synapse->border = (float)(remainingWeight < newWeight) * remainingWeight
                       + (float)(remainingWeight >= newWeight) * newWeight;
 
     // set target neuron
-    section->randomPos = (section->randomPos + 1) % NUMBER_OF_RAND_VALUES;
-    synapse->targetNeuronId = (ushort)(randomValues[section->randomPos]
+    section->randomPos++;
+    synapse->targetNeuronId = (ushort)(getRandomValue(seed, sectionId, section->randomPos)
                               % neuronSections[section->targetNeuronSectionId].numberOfNeurons);
 
-    section->randomPos = (section->randomPos + 1) % NUMBER_OF_RAND_VALUES;
-    synapse->weight = ((float)(randomValues[section->randomPos]) / randMax) / 10.0f;
+    section->randomPos++;
+    synapse->weight = getRandomFloat(seed, sectionId, section->randomPos) / 10.0f;
 
     // update weight with sign
-    section->randomPos = (section->randomPos + 1) % NUMBER_OF_RAND_VALUES;
-    signRand = randomValues[section->randomPos] % 1000;
+    section->randomPos++;
+    signRand = getRandomValue(seed, sectionId, section->randomPos) % 1000;
     synapse->weight *= (float)(1.0f - (1000.0f * sigNeg > signRand) * 2);
     synapse->active = 0;
 
@@ -300,14 +324,12 @@ synapseProcessingBackward(const uint neuronSectionId,
 {
     uint pos = 0;
     __global Synapse* synapse = NULL;
-    __global DynamicNeuron* targetNeuron = NULL;
-    uchar active = 0;
 
     // iterate over all synapses in the section
     while(pos < SYNAPSES_PER_SYNAPSESECTION)
     {
         synapse = &section->synapses[pos];
-        neuronSection->neurons[synapse->targetNeuronId].input += ((float)(synapse->active)) * synapse->weight;
+        neuronSection->input[synapse->targetNeuronId] += ((float)(synapse->active)) * synapse->weight;
         synapse->active = 0;
         pos++;
     }
@@ -324,7 +346,7 @@ synapseProcessingBackward(const uint neuronSectionId,
             if(targetSection->active != 1) 
             {
                 targetSection->active = 1;
-                targetSection->randomPos = neuronSectionId % NUMBER_OF_RAND_VALUES;
+                targetSection->randomPos = neuronSectionId;
                 targetSection->targetNeuronSectionId = neuronSectionId;
             }
         }
@@ -360,7 +382,7 @@ processSingleSectionBackward(const uint neuronSectionId,
             if(targetSection->active != 1) 
             {
                 targetSection->active = 1;
-                targetSection->randomPos = neuronSectionId % NUMBER_OF_RAND_VALUES;
+                targetSection->randomPos = neuronSectionId;
                 targetSection->targetNeuronSectionId = neuronSectionId;
             }
         }
@@ -382,7 +404,6 @@ processSingleSectionBackward(const uint neuronSectionId,
  *
  * @param section current processed synapse-section
  * @param segment refernece to the processed segment
- * @param sourceNeuron source-neuron, who triggered the section
  * @param netH wight-value, which comes into the section
  * @param outH multiplicator
  */
@@ -390,18 +411,16 @@ inline void
 synapseProcessing(const uint neuronId,
                   const uint neuronSectionId,
                   __global SynapseSection* section,
-                  __global const DynamicNeuron* sourceNeuron,
                   __global NeuronSection* neuronSections,
                   __global SynapseSection* synapseSections,
                   __global UpdatePosSection* updatePosSections,
                   __global DynamicSegmentSettings* dynamicSegmentSettings,
                   float netH,
-                  const float outH,
-                  __global const uint* randomValues)
+                  const float outH)
 {
     uint pos = 0;
     __global Synapse* synapse = NULL;
-    __global DynamicNeuron* targetNeuron = NULL;
+    __global NeuronSection* targetSection = &neuronSections[section->targetNeuronSectionId];
     uchar active = 0;
 
     // iterate over all synapses in the section
@@ -414,20 +433,20 @@ synapseProcessing(const uint neuronId,
         if(synapse->targetNeuronId == UNINIT_STATE_16)
         {
             createNewSynapse(section,
+                             (uint)(section - synapseSections),
                              synapse,
                              neuronSections,
                              dynamicSegmentSettings,
                              netH,
-                             outH,
-                             randomValues);
+                             outH);
         }
 
         // update target-neuron
-        //targetNeuron = &(neuronSections[section->targetNeuronSectionId].neurons[synapse->targetNeuronId]);
-        //targetNeuron->input += synapse->weight;
+        //targetSection->input[synapse->targetNeuronId] += synapse->weight;
 
         // update active-counter
-        active = (synapse->weight > 0) == (targetNeuron->potential > targetNeuron->border);
+        active = (synapse->weight > 0) == (targetSection->potential[synapse->targetNeuronId]
+                                           > targetSection->border[synapse->targetNeuronId]);
         synapse->activeCounter += active * (uchar)(synapse->activeCounter < 126);
         synapse->active = 1;
 
@@ -460,14 +479,12 @@ synapseProcessing(const uint neuronId,
                 synapseProcessing(neuronId,
                                   neuronSectionId,
                                   &synapseSections[section->forwardNext],
-                                  sourceNeuron,
                                   neuronSections,
                                   synapseSections,
                                   updatePosSections,
                                   dynamicSegmentSettings,
                                   netH,
-                                  outH,
-                                  randomValues);
+                                  outH);
         }
     }
 }
@@ -481,45 +498,42 @@ synapseProcessing(const uint neuronId,
 inline void
 processSingleNeuron(const uint neuronId,
                     const uint neuronSectionId,
-                    __global DynamicNeuron* neuron,
+                    __global NeuronSection* section,
                     __global NeuronSection* neuronSections,
                     __global SynapseSection* synapseSections,
                     __global UpdatePosSection* updatePosSections,
-                    __global DynamicSegmentSettings* dynamicSegmentSettings,
-                    __global const uint* randomValues)
+                    __global DynamicSegmentSettings* dynamicSegmentSettings)
 {
     // handle active-state
-    if(neuron->active != 0)
+    if(section->active[neuronId] != 0)
     {
-        if(neuron->targetSectionId == UNINIT_STATE_32)
+        if(section->targetSectionId[neuronId] == UNINIT_STATE_32)
         {
             __global UpdatePos* updatePos = &updatePosSections[neuronSectionId].positions[neuronId];
-            neuron->targetSectionId = updatePos->forwardNewId;
+            section->targetSectionId[neuronId] = updatePos->forwardNewId;
             updatePos->forwardNewId = UNINIT_STATE_32;
-            updatePos->type = neuron->targetSectionId == UNINIT_STATE_32;
+            updatePos->type = section->targetSectionId[neuronId] == UNINIT_STATE_32;
 
-            if(neuron->targetSectionId != UNINIT_STATE_32)
+            if(section->targetSectionId[neuronId] != UNINIT_STATE_32)
             {
-                __global SynapseSection* targetSection = &synapseSections[neuron->targetSectionId];
+                __global SynapseSection* targetSection = &synapseSections[section->targetSectionId[neuronId]];
                 targetSection->active = 1;
                 targetSection->randomPos = updatePos->randomPos;
                 targetSection->targetNeuronSectionId = updatePos->targetNeuronSectionId;
             }
         }
 
-        if(neuron->targetSectionId != UNINIT_STATE_32)
+        if(section->targetSectionId[neuronId] != UNINIT_STATE_32)
         {
             synapseProcessing(neuronId,
                               neuronSectionId,
-                              &synapseSections[neuron->targetSectionId],
-                              neuron,
+                              &synapseSections[section->targetSectionId[neuronId]],
                               neuronSections,
                               synapseSections,
                               updatePosSections,
                               dynamicSegmentSettings,
-                              neuron->potential,
-                              neuron->potential,
-                              randomValues);
+                              section->potential[neuronId],
+                              section->potential[neuronId]);
         }
     }
 }
@@ -530,23 +544,25 @@ processSingleNeuron(const uint neuronId,
  * @param segment
  */
 inline void
-processNeuron(__global DynamicNeuron* neuron,
+processNeuron(__global NeuronSection* section,
+              const uint neuronId,
               __global DynamicSegmentSettings* dynamicSegmentSettings)
 {
-    neuron->potential /= dynamicSegmentSettings->neuronCooldown;
-    neuron->refractionTime = neuron->refractionTime >> 1;
+    section->potential[neuronId] /= dynamicSegmentSettings->neuronCooldown;
+    section->refractionTime[neuronId] = section->refractionTime[neuronId] >> 1;
 
-    if(neuron->refractionTime == 0)
+    if(section->refractionTime[neuronId] == 0)
     {
-        neuron->potential = dynamicSegmentSettings->potentialOverflow * neuron->input;
-        neuron->refractionTime = dynamicSegmentSettings->refractionTime;
+        section->potential[neuronId] = dynamicSegmentSettings->potentialOverflow
+                                       * section->input[neuronId];
+        section->refractionTime[neuronId] = dynamicSegmentSettings->refractionTime;
     }
 
     // update neuron
-    neuron->potential -= neuron->border;
-    neuron->active = neuron->potential > 0.0f;
-    neuron->input = 0.0f;
-    neuron->potential = log2(neuron->potential + 1.0f);
+    section->potential[neuronId] -= section->border[neuronId];
+    section->active[neuronId] = section->potential[neuronId] > 0.0f;
+    section->input[neuronId] = 0.0f;
+    section->potential[neuronId] = log2(section->potential[neuronId] + 1.0f);
 }
 
 /**
@@ -563,7 +579,6 @@ processNeuronsOfOutputBrick(__global const Brick* brick,
                             __global UpdatePosSection* updatePosSections,
                             __global DynamicSegmentSettings* dynamicSegmentSettings)
 {
-    __global DynamicNeuron* neuron = NULL;
     __global NeuronSection* section = NULL;
 
     // iterate over all neurons within the brick
@@ -582,10 +597,10 @@ processNeuronsOfOutputBrick(__global const Brick* brick,
             neuronId < section->numberOfNeurons;
             neuronId++)
         {
-            neuron = &section->neurons[neuronId];
-            neuron->potential = dynamicSegmentSettings->potentialOverflow * neuron->input;
-            outputTransfers[neuron->targetBorderId] = neuron->potential;
-            neuron->input = 0.0f;
+            section->potential[neuronId] = dynamicSegmentSettings->potentialOverflow
+                                           * section->input[neuronId];
+            outputTransfers[section->targetBorderId[neuronId]] = section->potential[neuronId];
+            section->input[neuronId] = 0.0f;
         }
     }
 }
@@ -602,10 +617,8 @@ processNeuronsOfInputBrick(__global const Brick* brick,
                            __global float* inputTransfers,
                            __global SynapseSection* synapseSections,
                            __global UpdatePosSection* updatePosSections,
-                           __global DynamicSegmentSettings* dynamicSegmentSettings,
-                           __global const uint* randomValues)
+                           __global DynamicSegmentSettings* dynamicSegmentSettings)
 {
-    __global DynamicNeuron* neuron = NULL;
     __global NeuronSection* section = NULL;
 
     // iterate over all neurons within the brick
@@ -618,18 +631,16 @@ processNeuronsOfInputBrick(__global const Brick* brick,
             neuronId < section->numberOfNeurons;
             neuronId++)
         {
-            neuron = &section->neurons[neuronId];
-            neuron->potential = inputTransfers[neuron->targetBorderId];
-            neuron->active = neuron->potential > 0.0f;
+            section->potential[neuronId] = inputTransfers[section->targetBorderId[neuronId]];
+            section->active[neuronId] = section->potential[neuronId] > 0.0f;
 
             processSingleNeuron(neuronId,
                                 neuronSectionId,
-                                neuron,
+                                section,
                                 neuronSections,
                                 synapseSections,
                                 updatePosSections,
-                                dynamicSegmentSettings,
-                                randomValues);
+                                dynamicSegmentSettings);
         }
     }
 }
@@ -645,10 +656,8 @@ processNeuronsOfNormalBrick(__global const Brick* brick,
                             __global NeuronSection* neuronSections,
                             __global SynapseSection* synapseSections,
                             __global UpdatePosSection* updatePosSections,
-                            __global DynamicSegmentSettings* dynamicSegmentSettings,
-                            __global const uint* randomValues)
+                            __global DynamicSegmentSettings* dynamicSegmentSettings)
 {
-    __global DynamicNeuron* neuron = NULL;
     __global NeuronSection* section = NULL;
 
     // iterate over all neurons within the brick
@@ -667,16 +676,14 @@ processNeuronsOfNormalBrick(__global const Brick* brick,
             neuronId < section->numberOfNeurons;
             neuronId++)
         {
-            neuron = &section->neurons[neuronId];
-            processNeuron(neuron, dynamicSegmentSettings);
+            processNeuron(section, neuronId, dynamicSegmentSettings);
             processSingleNeuron(neuronId,
                                 neuronSectionId,
-                                neuron,
+                                section,
                                 neuronSections,
                                 synapseSections,
                                 updatePosSections,
-                                dynamicSegmentSettings,
-                                randomValues);
+                                dynamicSegmentSettings);
         }
     }
 }
@@ -696,8 +703,7 @@ prcessDynamicSegment(__global Brick* bricks,
                      __global SegmentHeader* segmentHeader,
                      __global DynamicSegmentSettings* dynamicSegmentSettings,
                      __global float* inputTransfers,
-                     __global float* outputTransfers,
-                     __global uint* randomValues)
+                     __global float* outputTransfers)
 {
     const uint numberOfBricks = segmentHeader->bricks.count;
     for(uint pos = 0; pos < numberOfBricks; pos++)
@@ -711,8 +717,7 @@ prcessDynamicSegment(__global Brick* bricks,
                                        inputTransfers,
                                        synapseSections,
                                        updatePosSections,
-                                       dynamicSegmentSettings,
-                                       randomValues);
+                                       dynamicSegmentSettings);
         }
         else if(brick->isOutputBrick)
         {
@@ -729,8 +734,7 @@ prcessDynamicSegment(__global Brick* bricks,
                                         neuronSections,
                                         synapseSections,
                                         updatePosSections,
-                                        dynamicSegmentSettings,
-                                        randomValues);
+                                        dynamicSegmentSettings);
         }
 
         barrier(CLK_GLOBAL_MEM_FENCE);
@@ -750,7 +754,6 @@ backpropagateOutput(__global const Brick* brick,
                     __global NeuronSection* neuronSections,
                     __global DynamicSegmentSettings* dynamicSegmentSettings)
 {
-    __global DynamicNeuron* neuron = NULL;
     __global NeuronSection* section = NULL;
 
     for(uint neuronSectionId = brick->neuronSectionPos + get_group_id(0);
@@ -762,9 +765,8 @@ backpropagateOutput(__global const Brick* brick,
             neuronId < section->numberOfNeurons;
             neuronId += get_local_size(0))
         {
-            neuron = &section->neurons[neuronId];
-            neuron->delta = inputTransfers[neuron->targetBorderId];
-            inputTransfers[neuron->targetBorderId] = 0.0f;
+            section->delta[neuronId] = inputTransfers[section->targetBorderId[neuronId]];
+            inputTransfers[section->targetBorderId[neuronId]] = 0.0f;
         }
     }
 }
@@ -773,7 +775,7 @@ backpropagateOutput(__global const Brick* brick,
  * @brief run backpropagation for a single synapse-section
  *
  * @param section pointer to section to process
- * @param sourceNeuron pointer to the neuron, who triggered the section
+ * @param sourceDelta pointer to the delta of the neuron, who triggered the section
  * @param netH neuron-potential
  * @param outH output-multiplicator
  * @param brick brick where the seciton is located
@@ -781,14 +783,14 @@ backpropagateOutput(__global const Brick* brick,
  */
 inline void
 backpropagateSection(__global SynapseSection* section,
-                     __global DynamicNeuron* sourceNeuron,
+                     __global float* sourceDelta,
                      float netH,
                      __global const Brick* brick,
                      __global NeuronSection* neuronSections,
                      __global SynapseSection* synapseSections)
 {
     __global Synapse* synapse = NULL;
-    __global DynamicNeuron* targetNeuron = NULL;
+    float targetDelta = 0.0f;
     __global NeuronSection* neuronSection = &neuronSections[section->targetNeuronSectionId];
     float learnValue = 0.2f;
     ushort pos = 0;
@@ -803,9 +805,9 @@ backpropagateSection(__global SynapseSection* section,
         // update weight
         learnValue = (float)(126 - synapse->activeCounter) * 0.0002f;
         learnValue += 0.05f;
-        targetNeuron = &neuronSection->neurons[synapse->targetNeuronId];
-        sourceNeuron->delta += targetNeuron->delta * synapse->weight;
-        synapse->weight -= learnValue * targetNeuron->delta;
+        targetDelta = neuronSection->delta[synapse->targetNeuronId];
+        *sourceDelta += targetDelta * synapse->weight;
+        synapse->weight -= learnValue * targetDelta;
 
         netH -= synapse->border;
         pos++;
@@ -815,7 +817,7 @@ backpropagateSection(__global SynapseSection* section,
             && netH > 0.01f)
     {
         backpropagateSection(&synapseSections[section->forwardNext],
-                             sourceNeuron,
+                             sourceDelta,
                              netH,
                              brick,
                              neuronSections,
@@ -836,7 +838,6 @@ backpropagateNeurons(__global const Brick* brick,
                      __global UpdatePosSection* updatePosSections,
                      __global float* outputTransfers)
 {
-    __global DynamicNeuron* sourceNeuron = NULL;
     __global NeuronSection* neuronSection = NULL;
     __global UpdatePosSection* updatePosSection = NULL;
 
@@ -852,27 +853,26 @@ backpropagateNeurons(__global const Brick* brick,
             neuronId += get_local_size(0))
         {
             // skip section, if not active
-            sourceNeuron = &neuronSection->neurons[neuronId];
             //UpdatePos* updatePos = &updatePosSection->positions[neuronId];
-            if(sourceNeuron->targetSectionId != UNINIT_STATE_32)
+            if(neuronSection->targetSectionId[neuronId] != UNINIT_STATE_32)
             {
-                sourceNeuron->delta = 0.0f;
+                neuronSection->delta[neuronId] = 0.0f;
 
                 // set start-values
-                if(sourceNeuron->active)
+                if(neuronSection->active[neuronId])
                 {
-                    backpropagateSection(&synapseSections[sourceNeuron->targetSectionId],
-                                         sourceNeuron,
-                                         sourceNeuron->potential,
+                    backpropagateSection(&synapseSections[neuronSection->targetSectionId[neuronId]],
+                                         &neuronSection->delta[neuronId],
+                                         neuronSection->potential[neuronId],
                                          brick,
                                          neuronSections,
                                          synapseSections);
 
-                    sourceNeuron->delta *= 1.4427f * pow(0.5f, sourceNeuron->potential);
+                    neuronSection->delta[neuronId] *= 1.4427f * pow(0.5f, neuronSection->potential[neuronId]);
                 }
 
                 if(brick->isInputBrick) {
-                    outputTransfers[sourceNeuron->targetBorderId] = sourceNeuron->delta;
+                    outputTransfers[neuronSection->targetBorderId[neuronId]] = neuronSection->delta[neuronId];
                 }
             }
         }
@@ -0,0 +1,95 @@
+/**
+ * @file        growth_requests.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+
+#ifndef KYOUKOMIND_DYNAMIC_GROWTH_REQUESTS_H
+#define KYOUKOMIND_DYNAMIC_GROWTH_REQUESTS_H
+
+#include <common.h>
+
+#include "objects.h"
+
+static_assert(NEURON_LANES_PER_NEURONSECTION <= 64,
+              "the pending neurons of a section must fit into a single bitmap-word");
+
+/**
+ * @brief Neurons, which need a new synapse-section at the end of their chain. Each
+ *        neuron-section has a bitmap of its pending neurons and the sections with at least one
+ *        pending neuron are listed, so the update after the forward-pass only touches the
+ *        neurons, which really requested a new section. The requests are only runtime-data and
+ *        not part of the segment-data or a snapshot.
+ */
+struct GrowthRequests
+{
+    std::vector<uint64_t> pendingNeurons;
+    std::vector<uint32_t> dirtySections;
+
+    /**
+     * @brief (re-)initialize the requests without any pending neuron
+     *
+     * @param numberOfNeuronSections number of neuron-sections of the segment
+     */
+    inline void
+    init(const uint32_t numberOfNeuronSections)
+    {
+        pendingNeurons.assign(numberOfNeuronSections, 0);
+        dirtySections.clear();
+    }
+
+    /**
+     * @brief request a new synapse-section for a neuron
+     *
+     * @param neuronSectionId id of the section of the neuron
+     * @param neuronId id of the neuron within its section
+     */
+    inline void
+    markNeuron(const uint32_t neuronSectionId, const uint32_t neuronId)
+    {
+        uint64_t &pending = pendingNeurons[neuronSectionId];
+        if(pending == 0) {
+            dirtySections.push_back(neuronSectionId);
+        }
+        pending |= static_cast<uint64_t>(1) << neuronId;
+    }
+
+    /**
+     * @brief move all requests into another request-list
+     *
+     * @param target request-list, which gets the requests
+     */
+    inline void
+    moveTo(GrowthRequests &target)
+    {
+        for(const uint32_t neuronSectionId : dirtySections)
+        {
+            uint64_t &targetPending = target.pendingNeurons[neuronSectionId];
+            if(targetPending == 0) {
+                target.dirtySections.push_back(neuronSectionId);
+            }
+            targetPending |= pendingNeurons[neuronSectionId];
+            pendingNeurons[neuronSectionId] = 0;
+        }
+        dirtySections.clear();
+    }
+};
+
+#endif // KYOUKOMIND_DYNAMIC_GROWTH_REQUESTS_H
@@ -0,0 +1,44 @@
+/**
+ * @file        neuron_batch.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_DYNAMIC_NEURON_BATCH_H
+#define KYOUKOMIND_DYNAMIC_NEURON_BATCH_H
+
+#include <common.h>
+
+/**
+ * @brief State of the neurons of a segment for each sample of a batch. The values of all samples
+ *        of a neuron are stored one after another with the index
+ *        ((neuronSectionId * NEURON_LANES_PER_NEURONSECTION + neuronId) * batchSize + sample),
+ *        so a synapse can update the target-neuron of all samples with vector-instructions. The
+ *        border of a neuron is the same for all samples and is taken from the neuron-section.
+ *        The state is only runtime-data and not part of the segment-data or a snapshot.
+ */
+struct NeuronBatch
+{
+    uint32_t batchSize = 0;
+    std::vector<float> input;
+    std::vector<float> potential;
+    std::vector<uint8_t> refractionTime;
+};
+
+#endif // KYOUKOMIND_DYNAMIC_NEURON_BATCH_H
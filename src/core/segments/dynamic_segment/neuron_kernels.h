@@ -0,0 +1,362 @@
+/**
+ * @file        neuron_kernels.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_DYNAMIC_NEURON_KERNELS_H
+#define KYOUKOMIND_DYNAMIC_NEURON_KERNELS_H
+
+#include <common.h>
+
+#include <core/fast_math.h>
+
+#include "objects.h"
+
+#if defined(__AVX512F__) || defined(__AVX2__)
+#include <immintrin.h>
+#endif
+
+// The kernels in this file update all neurons of a neuron-section at once. Which instruction-set
+// is used, is defined at compile-time with the qmake-configs "avx2" or "avx512". Without one of
+// them the scalar fallback is used. All variants give the same results. Because the arrays of a
+// neuron-section are NEURON_LANES_PER_NEURONSECTION wide, the vectorized loops can run over the
+// last incomplete vector of a section without a remainder-loop.
+
+#if defined(__AVX2__) && !defined(__AVX512F__)
+/**
+ * @brief store the lowest byte of 8 int32-values
+ *
+ * @param target pointer to the 8 bytes to write
+ * @param values values to store, which have to be in range 0-255
+ */
+inline void
+storeLanesAsBytes(uint8_t* target, const __m256i values)
+{
+    const __m128i packed16 = _mm_packus_epi32(_mm256_castsi256_si128(values),
+                                              _mm256_extracti128_si256(values, 1));
+    const __m128i packed8 = _mm_packus_epi16(packed16, packed16);
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(target), packed8);
+}
+#endif
+
+/**
+ * @brief update the potential and active-state of all neurons of a normal neuron-section
+ *
+ * @param section neuron-section to process
+ * @param dynamicSegmentSettings settings of the segment
+ *
+ * SINGLE_REFRACTION has to be true, if the refraction-time of the segment is 1. Then every
+ * neuron is reset in each cycle, so the cooldown and the refraction-times have no effect and
+ * are neither loaded nor written.
+ *
+ * @return true, if at least one neuron had an input or is active after the update, so the
+ *         section is not yet settled and has to be processed again in the next cycle
+ */
+template<bool SINGLE_REFRACTION>
+inline bool
+processNeuronSection(NeuronSection* section,
+                     const DynamicSegmentSettings* dynamicSegmentSettings)
+{
+    const uint32_t numberOfNeurons = section->numberOfNeurons;
+    bool notSettled = false;
+
+#if defined(__AVX512F__)
+    const __m512 cooldown = _mm512_set1_ps(dynamicSegmentSettings->neuronCooldown);
+    const __m512 overflow = _mm512_set1_ps(dynamicSegmentSettings->potentialOverflow);
+    const __m512i refractionReset = _mm512_set1_epi32(dynamicSegmentSettings->refractionTime);
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512i one = _mm512_set1_epi32(1);
+    __mmask16 pending = 0;
+
+    for(uint32_t i = 0; i < numberOfNeurons; i += 16)
+    {
+        __m512 potential;
+        const __m512 input = _mm512_loadu_ps(&section->input[i]);
+        const __m512 border = _mm512_loadu_ps(&section->border[i]);
+
+        if constexpr(SINGLE_REFRACTION)
+        {
+            potential = _mm512_mul_ps(overflow, input);
+        }
+        else
+        {
+            potential = _mm512_loadu_ps(&section->potential[i]);
+            const __m128i refractionBytes =
+                    _mm_loadu_si128(reinterpret_cast<const __m128i*>(&section->refractionTime[i]));
+            __m512i refraction = _mm512_cvtepu8_epi32(refractionBytes);
+
+            potential = _mm512_div_ps(potential, cooldown);
+            refraction = _mm512_srli_epi32(refraction, 1);
+
+            // reset neurons at the end of the refraction-time
+            const __mmask16 reset = _mm512_cmpeq_epi32_mask(refraction, _mm512_setzero_si512());
+            potential = _mm512_mask_mul_ps(potential, reset, overflow, input);
+            refraction = _mm512_mask_mov_epi32(refraction, reset, refractionReset);
+
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(&section->refractionTime[i]),
+                             _mm512_cvtepi32_epi8(refraction));
+        }
+
+        // update neuron
+        potential = _mm512_sub_ps(potential, border);
+        const __mmask16 active = _mm512_cmp_ps_mask(potential, zero, _CMP_GT_OQ);
+        pending |= active | _mm512_cmp_ps_mask(input, zero, _CMP_NEQ_UQ);
+
+        _mm512_storeu_ps(&section->potential[i], potential);
+        _mm512_storeu_ps(&section->input[i], zero);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&section->active[i]),
+                         _mm512_cvtepi32_epi8(_mm512_maskz_mov_epi32(active, one)));
+    }
+    notSettled = pending != 0;
+#elif defined(__AVX2__)
+    const __m256 cooldown = _mm256_set1_ps(dynamicSegmentSettings->neuronCooldown);
+    const __m256 overflow = _mm256_set1_ps(dynamicSegmentSettings->potentialOverflow);
+    const __m256i refractionReset = _mm256_set1_epi32(dynamicSegmentSettings->refractionTime);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256i one = _mm256_set1_epi32(1);
+    __m256 pending = _mm256_setzero_ps();
+
+    for(uint32_t i = 0; i < numberOfNeurons; i += 8)
+    {
+        __m256 potential;
+        const __m256 input = _mm256_loadu_ps(&section->input[i]);
+        const __m256 border = _mm256_loadu_ps(&section->border[i]);
+
+        if constexpr(SINGLE_REFRACTION)
+        {
+            potential = _mm256_mul_ps(overflow, input);
+        }
+        else
+        {
+            potential = _mm256_loadu_ps(&section->potential[i]);
+            const __m128i refractionBytes =
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i*>(&section->refractionTime[i]));
+            __m256i refraction = _mm256_cvtepu8_epi32(refractionBytes);
+
+            potential = _mm256_div_ps(potential, cooldown);
+            refraction = _mm256_srli_epi32(refraction, 1);
+
+            // reset neurons at the end of the refraction-time
+            const __m256i reset = _mm256_cmpeq_epi32(refraction, _mm256_setzero_si256());
+            potential = _mm256_blendv_ps(potential,
+                                         _mm256_mul_ps(overflow, input),
+                                         _mm256_castsi256_ps(reset));
+            refraction = _mm256_blendv_epi8(refraction, refractionReset, reset);
+
+            storeLanesAsBytes(&section->refractionTime[i], refraction);
+        }
+
+        // update neuron
+        potential = _mm256_sub_ps(potential, border);
+        const __m256 active = _mm256_cmp_ps(potential, zero, _CMP_GT_OQ);
+        pending = _mm256_or_ps(pending, active);
+        pending = _mm256_or_ps(pending, _mm256_cmp_ps(input, zero, _CMP_NEQ_UQ));
+
+        _mm256_storeu_ps(&section->potential[i], potential);
+        _mm256_storeu_ps(&section->input[i], zero);
+        storeLanesAsBytes(&section->active[i], _mm256_and_si256(_mm256_castps_si256(active), one));
+    }
+    notSettled = _mm256_movemask_ps(pending) != 0;
+#else
+    const float cooldown = dynamicSegmentSettings->neuronCooldown;
+    const float overflow = dynamicSegmentSettings->potentialOverflow;
+    const uint8_t refractionReset = dynamicSegmentSettings->refractionTime;
+
+    for(uint32_t i = 0; i < numberOfNeurons; i++)
+    {
+        const float input = section->input[i];
+        notSettled |= input != 0.0f;
+
+        float potential = 0.0f;
+        if constexpr(SINGLE_REFRACTION)
+        {
+            potential = overflow * input;
+        }
+        else
+        {
+            potential = section->potential[i] / cooldown;
+            section->refractionTime[i] = section->refractionTime[i] >> 1;
+
+            if(section->refractionTime[i] == 0)
+            {
+                potential = overflow * input;
+                section->refractionTime[i] = refractionReset;
+            }
+        }
+
+        // update neuron
+        potential -= section->border[i];
+        section->potential[i] = potential;
+        section->active[i] = potential > 0.0f;
+        section->input[i] = 0.0f;
+        notSettled |= section->active[i] != 0;
+    }
+#endif
+
+    applyLog2Activation(section->potential,
+                        numberOfNeurons,
+                        dynamicSegmentSettings->fastMath != 0);
+
+    return notSettled;
+}
+
+/**
+ * @brief update all neurons of a neuron-section of an output-brick and write the potentials into
+ *        the output-buffer
+ *
+ * @param section neuron-section to process
+ * @param outputTransfers buffer for the output-values of the segment
+ * @param dynamicSegmentSettings settings of the segment
+ */
+inline void
+processOutputNeuronSection(NeuronSection* section,
+                           float* outputTransfers,
+                           const DynamicSegmentSettings* dynamicSegmentSettings)
+{
+    const uint32_t numberOfNeurons = section->numberOfNeurons;
+
+#if defined(__AVX512F__)
+    const __m512 overflow = _mm512_set1_ps(dynamicSegmentSettings->potentialOverflow);
+    const __m512 zero = _mm512_setzero_ps();
+    for(uint32_t i = 0; i < numberOfNeurons; i += 16)
+    {
+        const __m512 input = _mm512_loadu_ps(&section->input[i]);
+        _mm512_storeu_ps(&section->potential[i], _mm512_mul_ps(overflow, input));
+        _mm512_storeu_ps(&section->input[i], zero);
+    }
+#elif defined(__AVX2__)
+    const __m256 overflow = _mm256_set1_ps(dynamicSegmentSettings->potentialOverflow);
+    const __m256 zero = _mm256_setzero_ps();
+    for(uint32_t i = 0; i < numberOfNeurons; i += 8)
+    {
+        const __m256 input = _mm256_loadu_ps(&section->input[i]);
+        _mm256_storeu_ps(&section->potential[i], _mm256_mul_ps(overflow, input));
+        _mm256_storeu_ps(&section->input[i], zero);
+    }
+#else
+    for(uint32_t i = 0; i < numberOfNeurons; i++)
+    {
+        section->potential[i] = dynamicSegmentSettings->potentialOverflow * section->input[i];
+        section->input[i] = 0.0f;
+    }
+#endif
+
+    for(uint32_t i = 0; i < numberOfNeurons; i++) {
+        outputTransfers[section->targetBorderId[i]] = section->potential[i];
+    }
+}
+
+/**
+ * @brief set the potentials of all neurons of a neuron-section of an input-brick from the
+ *        input-buffer
+ *
+ * @param section neuron-section to process
+ * @param inputTransfers buffer with the input-values of the segment
+ */
+inline void
+processInputNeuronSection(NeuronSection* section,
+                          const float* inputTransfers)
+{
+    const uint32_t numberOfNeurons = section->numberOfNeurons;
+
+#if defined(__AVX512F__)
+    const __m512i laneOffsets = _mm512_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7,
+                                                  8, 9, 10, 11, 12, 13, 14, 15);
+    const __m512i numberOfLanes = _mm512_set1_epi32(numberOfNeurons);
+    const __m512 zero = _mm512_setzero_ps();
+    const __m512i one = _mm512_set1_epi32(1);
+
+    for(uint32_t i = 0; i < numberOfNeurons; i += 16)
+    {
+        // lanes behind the last neuron have no valid border-id and must not be loaded
+        const __m512i laneIds = _mm512_add_epi32(_mm512_set1_epi32(i), laneOffsets);
+        const __mmask16 valid = _mm512_cmplt_epu32_mask(laneIds, numberOfLanes);
+        const __m512i borderIds = _mm512_loadu_si512(&section->targetBorderId[i]);
+        const __m512 potential = _mm512_mask_i32gather_ps(zero, valid, borderIds, inputTransfers, 4);
+        const __mmask16 active = _mm512_cmp_ps_mask(potential, zero, _CMP_GT_OQ);
+
+        _mm512_storeu_ps(&section->potential[i], potential);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(&section->active[i]),
+                         _mm512_cvtepi32_epi8(_mm512_maskz_mov_epi32(active, one)));
+    }
+#elif defined(__AVX2__)
+    const __m256i laneOffsets = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+    const __m256i numberOfLanes = _mm256_set1_epi32(numberOfNeurons);
+    const __m256 zero = _mm256_setzero_ps();
+    const __m256i one = _mm256_set1_epi32(1);
+
+    for(uint32_t i = 0; i < numberOfNeurons; i += 8)
+    {
+        // lanes behind the last neuron have no valid border-id and must not be loaded
+        const __m256i laneIds = _mm256_add_epi32(_mm256_set1_epi32(i), laneOffsets);
+        const __m256i valid = _mm256_cmpgt_epi32(numberOfLanes, laneIds);
+        const __m256i borderIds =
+                _mm256_loadu_si256(reinterpret_cast<const __m256i*>(&section->targetBorderId[i]));
+        const __m256 potential = _mm256_mask_i32gather_ps(zero,
+                                                          inputTransfers,
+                                                          borderIds,
+                                                          _mm256_castsi256_ps(valid),
+                                                          4);
+        const __m256 active = _mm256_cmp_ps(potential, zero, _CMP_GT_OQ);
+
+        _mm256_storeu_ps(&section->potential[i], potential);
+        storeLanesAsBytes(&section->active[i], _mm256_and_si256(_mm256_castps_si256(active), one));
+    }
+#else
+    for(uint32_t i = 0; i < numberOfNeurons; i++)
+    {
+        section->potential[i] = inputTransfers[section->targetBorderId[i]];
+        section->active[i] = section->potential[i] > 0.0f;
+    }
+#endif
+}
+
+/**
+ * @brief add the partial inputs of a worker lane by lane to the inputs of a neuron-section
+ *
+ * @param inputs inputs of the neuron-section
+ * @param partialInputs partial inputs of the worker for the same neuron-section
+ */
+inline void
+addPartialInputs(float* inputs,
+                 const float* partialInputs)
+{
+#if defined(__AVX512F__)
+    for(uint32_t i = 0; i < NEURON_LANES_PER_NEURONSECTION; i += 16)
+    {
+        const __m512 sum = _mm512_add_ps(_mm512_loadu_ps(&inputs[i]),
+                                         _mm512_loadu_ps(&partialInputs[i]));
+        _mm512_storeu_ps(&inputs[i], sum);
+    }
+#elif defined(__AVX2__)
+    for(uint32_t i = 0; i < NEURON_LANES_PER_NEURONSECTION; i += 8)
+    {
+        const __m256 sum = _mm256_add_ps(_mm256_loadu_ps(&inputs[i]),
+                                         _mm256_loadu_ps(&partialInputs[i]));
+        _mm256_storeu_ps(&inputs[i], sum);
+    }
+#else
+    for(uint32_t i = 0; i < NEURON_LANES_PER_NEURONSECTION; i++) {
+        inputs[i] += partialInputs[i];
+    }
+#endif
+}
+
+#endif // KYOUKOMIND_DYNAMIC_NEURON_KERNELS_H
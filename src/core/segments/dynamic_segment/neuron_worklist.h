@@ -0,0 +1,179 @@
+/**
+ * @file        neuron_worklist.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_DYNAMIC_NEURON_WORKLIST_H
+#define KYOUKOMIND_DYNAMIC_NEURON_WORKLIST_H
+
+#include <common.h>
+
+#include "objects.h"
+
+/**
+ * @brief Lists of the neuron-sections of the normal bricks, which have to be processed in the
+ *        next cycle. With a refraction-time of 1, a neuron without input and without activity
+ *        is in a fixed point: its next update gives exactly the same potential and active-state
+ *        again. So a section only has to be processed, when it received an input, or when it
+ *        was not yet settled after the last update. All other sections are skipped and the cycle
+ *        time depends on the activity instead of the total number of neurons. The lists are
+ *        only runtime-data and not part of the segment-data or a snapshot.
+ */
+struct NeuronWorklist
+{
+    std::vector<std::vector<uint32_t>> brickLists;
+    std::vector<uint8_t> trackedBricks;
+    std::vector<uint8_t> pendingFlags;
+
+    // buffers for the processing of a single brick
+    std::vector<uint32_t> currentSections;
+    std::vector<uint8_t> keepFlags;
+
+    // Brick, which is actually processed by the serial path. Like in a dense scan over all
+    // sections, an input from a section to a later section of the same brick is consumed
+    // within the same pass. So these sections are collected in a min-heap and merged with the
+    // remaining sorted list of the brick, instead of being registered for the next cycle.
+    uint32_t activeBrickId = UNINIT_STATE_32;
+    uint32_t activeSectionId = 0;
+    const uint32_t* activeListPos = nullptr;
+    const uint32_t* activeListEnd = nullptr;
+    std::vector<uint32_t> activeSections;
+
+    /**
+     * @brief register a neuron-section to be processed in the next cycle or, if it belongs to
+     *        the active brick and comes behind the actual section, later in the actual pass
+     *
+     * @param neuronSectionId id of the neuron-section
+     * @param brickId id of the brick of the neuron-section
+     */
+    inline void
+    markSection(const uint32_t neuronSectionId, const uint32_t brickId)
+    {
+        if(pendingFlags[neuronSectionId] != 0
+                || trackedBricks[brickId] == 0)
+        {
+            return;
+        }
+
+        if(brickId == activeBrickId
+                && neuronSectionId > activeSectionId)
+        {
+            // sections, which are already in the remaining list, consume the input anyway
+            if(std::binary_search(activeListPos, activeListEnd, neuronSectionId)) {
+                return;
+            }
+
+            pendingFlags[neuronSectionId] = 1;
+            activeSections.push_back(neuronSectionId);
+            std::push_heap(activeSections.begin(), activeSections.end(), std::greater<uint32_t>());
+            return;
+        }
+
+        pendingFlags[neuronSectionId] = 1;
+        brickLists[brickId].push_back(neuronSectionId);
+    }
+
+    /**
+     * @brief start the serial processing of a brick
+     *
+     * @param brickId id of the brick
+     * @param listBegin pointer to the first section of the sorted list of the brick
+     * @param listEnd pointer behind the last section of the sorted list of the brick
+     */
+    inline void
+    beginBrick(const uint32_t brickId, const uint32_t* listBegin, const uint32_t* listEnd)
+    {
+        activeBrickId = brickId;
+        activeSectionId = 0;
+        activeListPos = listBegin;
+        activeListEnd = listEnd;
+        activeSections.clear();
+    }
+
+    /**
+     * @brief get the next section of the active brick in ascending order, out of the remaining
+     *        list and the sections, which received an input within the actual pass
+     *
+     * @param neuronSectionId reference for the id of the next section
+     *
+     * @return false, if all sections of the brick are processed, else true
+     */
+    inline bool
+    nextSectionOfBrick(uint32_t &neuronSectionId)
+    {
+        const bool hasListEntry = activeListPos != activeListEnd;
+        if(activeSections.size() > 0
+                && (hasListEntry == false || activeSections.front() < *activeListPos))
+        {
+            std::pop_heap(activeSections.begin(), activeSections.end(), std::greater<uint32_t>());
+            neuronSectionId = activeSections.back();
+            activeSections.pop_back();
+
+            // the section can be registered again for the next cycle after its update
+            pendingFlags[neuronSectionId] = 0;
+        }
+        else if(hasListEntry)
+        {
+            neuronSectionId = *activeListPos;
+            activeListPos++;
+        }
+        else
+        {
+            return false;
+        }
+
+        activeSectionId = neuronSectionId;
+        return true;
+    }
+
+    /**
+     * @brief finish the serial processing of the active brick
+     */
+    inline void
+    endBrick()
+    {
+        activeBrickId = UNINIT_STATE_32;
+        activeListPos = nullptr;
+        activeListEnd = nullptr;
+    }
+
+    /**
+     * @brief append the pending neuron-sections of a brick to the list of the current sections.
+     *        Sections, which get new input while the brick is processed, are registered again
+     *        for the next cycle.
+     *
+     * @param brickId id of the brick
+     */
+    inline void
+    takeBrickList(const uint32_t brickId)
+    {
+        std::vector<uint32_t> &brickList = brickLists[brickId];
+        for(const uint32_t neuronSectionId : brickList) {
+            pendingFlags[neuronSectionId] = 0;
+        }
+
+        // process the sections in memory-order
+        std::sort(brickList.begin(), brickList.end());
+        currentSections.insert(currentSections.end(), brickList.begin(), brickList.end());
+        brickList.clear();
+    }
+};
+
+#endif // KYOUKOMIND_DYNAMIC_NEURON_WORKLIST_H
@@ -28,40 +28,44 @@
 
 //==================================================================================================
 
-struct DynamicNeuron
-{
-    float input = 0.0f;
-    float border = 100.0f;
-    float potential = 0.0f;
-    float delta = 0.0f;
-
-    uint8_t refractionTime = 1;
-    uint8_t active = 0;
-    uint8_t padding[2];
-
-    uint32_t id = 0;
-
-    uint32_t targetBorderId = UNINIT_STATE_32;
-    uint32_t targetSectionId = UNINIT_STATE_32;
-
-    // total size: 32 Byte
-};
-
-//==================================================================================================
-
+/**
+ * @brief Neurons of a section stored as structure-of-arrays for the vectorized processing. Each
+ *        array has NEURON_LANES_PER_NEURONSECTION entries, so every array starts at a 64-byte
+ *        offset within the section and the vectorized kernels can process the last neurons of a
+ *        section without a scalar remainder-loop. The lanes behind numberOfNeurons are never
+ *        active.
+ */
 struct NeuronSection
 {
-    DynamicNeuron neurons[NEURONS_PER_NEURONSECTION];
+    float input[NEURON_LANES_PER_NEURONSECTION];
+    float border[NEURON_LANES_PER_NEURONSECTION];
+    float potential[NEURON_LANES_PER_NEURONSECTION];
+    float delta[NEURON_LANES_PER_NEURONSECTION];
+    uint32_t targetBorderId[NEURON_LANES_PER_NEURONSECTION];
+    uint32_t targetSectionId[NEURON_LANES_PER_NEURONSECTION];
+    uint32_t chainTailId[NEURON_LANES_PER_NEURONSECTION];
+    uint8_t refractionTime[NEURON_LANES_PER_NEURONSECTION];
+    uint8_t active[NEURON_LANES_PER_NEURONSECTION];
+
     uint32_t numberOfNeurons = 0;
     uint32_t id = 0;
     uint32_t brickId = 0;
     uint32_t backwardNextId = UNINIT_STATE_32;
-    uint8_t padding[48];
+    uint8_t padding[112];
 
     NeuronSection()
     {
-        for(uint32_t i = 0; i < NEURONS_PER_NEURONSECTION; i++) {
-            neurons[i] = DynamicNeuron();
+        for(uint32_t i = 0; i < NEURON_LANES_PER_NEURONSECTION; i++)
+        {
+            input[i] = 0.0f;
+            border[i] = 100.0f;
+            potential[i] = 0.0f;
+            delta[i] = 0.0f;
+            targetBorderId[i] = UNINIT_STATE_32;
+            targetSectionId[i] = UNINIT_STATE_32;
+            chainTailId[i] = UNINIT_STATE_32;
+            refractionTime[i] = 1;
+            active[i] = 0;
         }
     }
     // total size: 2048 Byte
@@ -81,7 +85,14 @@ struct Synapse
 
 //==================================================================================================
 
-struct SynapseSection
+/**
+ * @brief Section with a fixed number of synapses, which is given as template-parameter. All
+ *        layouts have the same 16 byte header, so the links of the chains can be followed
+ *        without knowing the layout. Narrow sections waste less memory on neurons with only a
+ *        few synapses, while wide sections need less jumps over the chain of dense neurons.
+ */
+template<typename SYNAPSE, uint32_t NUMBER_OF_SYNAPSES>
+struct BasicSynapseSection
 {
     uint8_t active = Kitsunemimi::ItemBuffer::ACTIVE_SECTION;
     uint8_t padding[3];
@@ -90,45 +101,43 @@ struct SynapseSection
     uint32_t targetNeuronSectionId = 0;
     uint32_t nextId = UNINIT_STATE_32;
 
-    Synapse synapses[SYNAPSES_PER_SYNAPSESECTION];
+    static const uint32_t numberOfSynapses = NUMBER_OF_SYNAPSES;
+    SYNAPSE synapses[NUMBER_OF_SYNAPSES];
 
-    SynapseSection()
+    BasicSynapseSection()
     {
-        for(uint32_t i = 0; i < SYNAPSES_PER_SYNAPSESECTION; i++) {
-            synapses[i] = Synapse();
+        for(uint32_t i = 0; i < NUMBER_OF_SYNAPSES; i++) {
+            synapses[i] = SYNAPSE();
         }
     }
-    // total size: 512 Byte
 };
 
 //==================================================================================================
 
-struct UpdatePos
+struct CompactSynapse
 {
-    uint32_t type = 0;
-    uint32_t forwardNewId = UNINIT_STATE_32;
-    uint32_t randomPos = UNINIT_STATE_32;
-    uint32_t targetNeuronSectionId = UNINIT_STATE_32;
-    // total size: 16 Byte
+    // weight and border are stored as half-precision float
+    uint16_t weight = 0;
+    uint16_t border = 0;
+    uint16_t targetNeuronId = UNINIT_STATE_16;
+    int8_t activeCounter = 0;
+    uint8_t padding[1];
+    // total size: 8 Byte
 };
 
 //==================================================================================================
 
-struct UpdatePosSection
-{
-    UpdatePos positions[NEURONS_PER_NEURONSECTION];
-    uint32_t numberOfPositions = 0;
-    uint32_t backwardNewId = UNINIT_STATE_32;
-    uint8_t padding[24];
+// total size: 256 / 512 / 1024 Byte
+typedef BasicSynapseSection<Synapse, SMALL_SYNAPSES_PER_SYNAPSESECTION> SmallSynapseSection;
+typedef BasicSynapseSection<Synapse, SYNAPSES_PER_SYNAPSESECTION> SynapseSection;
+typedef BasicSynapseSection<Synapse, LARGE_SYNAPSES_PER_SYNAPSESECTION> LargeSynapseSection;
 
-    UpdatePosSection()
-    {
-        for(uint32_t i = 0; i < NEURONS_PER_NEURONSECTION; i++) {
-            positions[i] = UpdatePos();
-        }
-    }
-    // total size: 1024 Byte
-};
+typedef BasicSynapseSection<CompactSynapse, SMALL_COMPACT_SYNAPSES_PER_SYNAPSESECTION>
+        SmallCompactSynapseSection;
+typedef BasicSynapseSection<CompactSynapse, COMPACT_SYNAPSES_PER_SYNAPSESECTION>
+        CompactSynapseSection;
+typedef BasicSynapseSection<CompactSynapse, LARGE_COMPACT_SYNAPSES_PER_SYNAPSESECTION>
+        LargeCompactSynapseSection;
 
 //==================================================================================================
 
@@ -146,8 +155,15 @@ struct DynamicSegmentSettings
     uint8_t refractionTime = 1;
     uint8_t doLearn = 0;
     uint8_t updateSections = 0;
-
-    uint8_t padding[213];
+    uint8_t synapseFormat = DEFAULT_SYNAPSE_FORMAT;
+    uint32_t randomSeed = 0;
+    uint8_t fastMath = 0;
+    uint8_t sectionGeometry = DEFAULT_SECTION_GEOMETRY;
+    uint8_t padding1[2];
+    // inactive synapses below this weight are removed; new synapses get a weight below 0.1
+    float synapsePruneBorder = 0.01f;
+
+    uint8_t padding[200];
 
     // total size: 256 Byte
 };
@@ -28,85 +28,114 @@
 #include <kyouko_root.h>
 #include <core/segments/brick.h>
 
+#include <core/processing/worker_pool.h>
+
 #include "objects.h"
 #include "dynamic_segment.h"
+#include "growth_requests.h"
+#include "neuron_kernels.h"
+#include "neuron_worklist.h"
+#include "section_geometry.h"
+#include "synapse_access.h"
+#include "synapse_chain.h"
+#include "worker_input_buffer.h"
 
 /**
  * @brief initialize a new specific synapse
  *
  * @param section current processed synapse-section
+ * @param sectionId id of the synapse-section, which is the key of its random-stream
  * @param synapse new synapse, which has to be initialized
  * @param bricks array of all bricks
  * @param sourceNeuron source-neuron, who triggered the section
  * @param segmentSettings settings of the section
  * @param remainingWeight weight of which to cut of a part for the new synapse
  */
+template<typename SECTION, typename SYNAPSE>
 inline void
-createNewSynapse(SynapseSection* section,
-                 Synapse* synapse,
+createNewSynapse(SECTION* section,
+                 const uint32_t sectionId,
+                 SYNAPSE* synapse,
                  const NeuronSection* neuronSections,
                  const DynamicSegmentSettings* segmentSettings,
                  const float remainingWeight,
                  const float outH)
 {
-    const uint32_t* randomValues = KyoukoRoot::m_randomValues;
-    const float randMax = static_cast<float>(RAND_MAX);
+    const uint32_t seed = segmentSettings->randomSeed;
     const float maxWeight = outH / static_cast<float>(segmentSettings->synapseSegmentation);
     uint32_t signRand = 0;
     const float sigNeg = segmentSettings->signNeg;
 
     // set activation-border
-    section->randomPos = (section->randomPos + 1) % NUMBER_OF_RAND_VALUES;
-    float newWeight = maxWeight * (static_cast<float>(randomValues[section->randomPos]) / randMax);
-    synapse->border = static_cast<float>(remainingWeight < newWeight) * remainingWeight
-                      + static_cast<float>(remainingWeight >= newWeight) * newWeight;
+    section->randomPos++;
+    float newWeight = maxWeight * getRandomFloat(seed, sectionId, section->randomPos);
+    setBorder(synapse, static_cast<float>(remainingWeight < newWeight) * remainingWeight
+                       + static_cast<float>(remainingWeight >= newWeight) * newWeight);
 
     // set target neuron
-    section->randomPos = (section->randomPos + 1) % NUMBER_OF_RAND_VALUES;
-    synapse->targetNeuronId = static_cast<uint16_t>(randomValues[section->randomPos]
+    section->randomPos++;
+    const uint32_t targetRand = getRandomValue(seed, sectionId, section->randomPos);
+    synapse->targetNeuronId = static_cast<uint16_t>(targetRand
                               % neuronSections[section->targetNeuronSectionId].numberOfNeurons);
 
 
-    section->randomPos = (section->randomPos + 1) % NUMBER_OF_RAND_VALUES;
-    synapse->weight = (static_cast<float>(randomValues[section->randomPos]) / randMax) / 10.0f;
+    section->randomPos++;
+    float weight = getRandomFloat(seed, sectionId, section->randomPos) / 10.0f;
 
     // update weight with sign
-    section->randomPos = (section->randomPos + 1) % NUMBER_OF_RAND_VALUES;
-    signRand = randomValues[section->randomPos] % 1000;
-    synapse->weight *= static_cast<float>(1.0f - (1000.0f * sigNeg > signRand) * 2);
+    section->randomPos++;
+    signRand = getRandomValue(seed, sectionId, section->randomPos) % 1000;
+    weight *= static_cast<float>(1.0f - (1000.0f * sigNeg > signRand) * 2);
+    setWeight(synapse, weight);
 
 
     synapse->activeCounter = 1;
 }
 
 /**
- * @brief process synapse-section
+ * @brief process a single synapse-section
  *
  * @param section current processed synapse-section
- * @param segment refernece to the processed segment
- * @param sourceNeuron source-neuron, who triggered the section
+ * @param sectionId id of the current processed synapse-section
+ * @param neuronSections pointer to all neuron-sections of the segment
+ * @param dynamicSegmentSettings settings of the segment
  * @param netH wight-value, which comes into the section
  * @param outH multiplicator
+ * @param workerBuffer buffer for the partial inputs of a worker in case of parallel processing,
+ *                     nullptr to write the inputs directly into the target-neurons
+ * @param worklist worklist to register the target-section for the next cycle, in case the inputs
+ *                 are written directly into the target-neurons
+ *
+ * Without DO_LEARN no new synapses are created and the active-counters are not updated.
+ *
+ * @return remaining weight after the section
  */
-inline void
-synapseProcessing(const uint32_t neuronId,
-                  const uint32_t neuronSectionId,
-                  SynapseSection* section,
-                  const DynamicNeuron* sourceNeuron,
-                  NeuronSection* neuronSections,
-                  SynapseSection* synapseSections,
-                  UpdatePosSection* updatePosSections,
-                  DynamicSegmentSettings* dynamicSegmentSettings,
-                  float netH,
-                  const float outH)
+template<typename SECTION, bool DO_LEARN>
+inline float
+processSynapseSection(SECTION* section,
+                      const uint32_t sectionId,
+                      NeuronSection* neuronSections,
+                      DynamicSegmentSettings* dynamicSegmentSettings,
+                      float netH,
+                      const float outH,
+                      WorkerInputBuffer* workerBuffer,
+                      NeuronWorklist* worklist)
 {
     uint32_t pos = 0;
-    Synapse* synapse = nullptr;
-    DynamicNeuron* targetNeuron = nullptr;
+    auto* synapse = &section->synapses[0];
+    NeuronSection* targetSection = &neuronSections[section->targetNeuronSectionId];
+    uint16_t targetId = 0;
     uint8_t active = 0;
 
+    float* inputs = targetSection->input;
+    if(workerBuffer != nullptr) {
+        inputs = workerBuffer->getSectionInputs(section->targetNeuronSectionId);
+    } else if(worklist != nullptr) {
+        worklist->markSection(section->targetNeuronSectionId, targetSection->brickId);
+    }
+
     // iterate over all synapses in the section
-    while(pos < SYNAPSES_PER_SYNAPSESECTION
+    while(pos < SECTION::numberOfSynapses
           && netH > 0.0f)
     {
         synapse = &section->synapses[pos];
@@ -114,7 +143,14 @@ synapseProcessing(const uint32_t neuronId,
         // create new synapse if necesarry and learning is active
         if(synapse->targetNeuronId == UNINIT_STATE_16)
         {
+            if constexpr(DO_LEARN == false)
+            {
+                pos++;
+                continue;
+            }
+
             createNewSynapse(section,
+                             sectionId,
                              synapse,
                              neuronSections,
                              dynamicSegmentSettings,
@@ -123,267 +159,632 @@ synapseProcessing(const uint32_t neuronId,
         }
 
         // update target-neuron
-        targetNeuron = &(neuronSections[section->targetNeuronSectionId].neurons[synapse->targetNeuronId]);
-        targetNeuron->input += synapse->weight;
+        targetId = synapse->targetNeuronId;
+        const float weight = getWeight(synapse);
+        inputs[targetId] += weight;
 
         // update active-counter
-        active = (synapse->weight > 0) == (targetNeuron->potential > targetNeuron->border);
-        synapse->activeCounter += active * static_cast<uint8_t>(synapse->activeCounter < 126);
+        if constexpr(DO_LEARN)
+        {
+            active = (weight > 0)
+                     == (targetSection->potential[targetId] > targetSection->border[targetId]);
+            synapse->activeCounter += active * static_cast<uint8_t>(synapse->activeCounter < 126);
+        }
 
         // update loop-counter
-        netH -= synapse->border;
+        netH -= getBorder(synapse);
         pos++;
     }
 
-    if(netH > 0.01f)
-    {
-        if(section->nextId == UNINIT_STATE_32)
-        {
-            updatePosSections[neuronSectionId].positions[neuronId].type = 1;
-            dynamicSegmentSettings->updateSections = 1;
-            return;
-        }
+    return netH;
+}
 
-        synapseProcessing(neuronId,
-                          neuronSectionId,
-                          &synapseSections[section->nextId],
-                          sourceNeuron,
-                          neuronSections,
-                          synapseSections,
-                          updatePosSections,
-                          dynamicSegmentSettings,
-                          netH,
-                          outH);
+/**
+ * @brief process the chain of synapse-sections of a neuron
+ *
+ * @param neuronId id of the source-neuron within its section
+ * @param neuronSectionId id of the section of the source-neuron
+ * @param section first synapse-section of the chain
+ * @param neuronSections pointer to all neuron-sections of the segment
+ * @param synapseSections pointer to all synapse-sections of the segment
+ * @param growthRequests list to request a new synapse-section for the neuron
+ * @param dynamicSegmentSettings settings of the segment
+ * @param netH wight-value, which comes into the section
+ * @param outH multiplicator
+ * @param workerBuffer buffer for the partial inputs of a worker in case of parallel processing,
+ *                     nullptr to write the inputs directly into the target-neurons
+ * @param worklist worklist to register the target-sections for the next cycle
+ */
+template<typename SECTION, bool DO_LEARN>
+inline void
+synapseProcessing(const uint32_t neuronId,
+                  const uint32_t neuronSectionId,
+                  SECTION* section,
+                  NeuronSection* neuronSections,
+                  SECTION* synapseSections,
+                  GrowthRequests* growthRequests,
+                  DynamicSegmentSettings* dynamicSegmentSettings,
+                  const float netH,
+                  const float outH,
+                  WorkerInputBuffer* workerBuffer,
+                  NeuronWorklist* worklist)
+{
+    const SECTION* lastSection = walkSynapseChain(
+                section,
+                synapseSections,
+                neuronSections,
+                netH,
+                [workerBuffer](const NeuronSection* targetSection)
+                {
+                    if(workerBuffer == nullptr) {
+                        prefetchNeuronArray(targetSection->input);
+                    }
+                    prefetchNeuronArray(targetSection->potential);
+                    prefetchNeuronArray(targetSection->border);
+                },
+                [&](SECTION* currentSection, const float remainingWeight)
+                {
+                    return processSynapseSection<SECTION, DO_LEARN>(currentSection,
+                                                                    currentSection - synapseSections,
+                                                                    neuronSections,
+                                                                    dynamicSegmentSettings,
+                                                                    remainingWeight,
+                                                                    outH,
+                                                                    workerBuffer,
+                                                                    worklist);
+                });
+
+    // request a new section at the end of the chain, if the weight was not consumed
+    if(DO_LEARN
+            && lastSection != nullptr)
+    {
+        growthRequests->markNeuron(neuronSectionId, neuronId);
     }
 }
 
 /**
  * @brief process only a single neuron
  *
- * @param neuron pointer to neuron to process
- * @param segment segment where the neuron belongs to
+ * @param neuronId id of the neuron within its section
+ * @param neuronSectionId id of the section of the neuron
+ * @param section section of the neuron
+ * @param neuronSections pointer to all neuron-sections of the segment
+ * @param synapseSections pointer to all synapse-sections of the segment
+ * @param growthRequests list to request a new synapse-section for the neuron
+ * @param dynamicSegmentSettings settings of the segment
+ * @param workerBuffer buffer for the partial inputs of a worker in case of parallel processing
+ * @param worklist worklist to register the target-sections for the next cycle
  */
+template<typename SECTION, bool DO_LEARN>
 inline void
 processSingleNeuron(const uint32_t neuronId,
                     const uint32_t neuronSectionId,
-                    DynamicNeuron* neuron,
+                    NeuronSection* section,
                     NeuronSection* neuronSections,
-                    SynapseSection* synapseSections,
-                    UpdatePosSection* updatePosSections,
-                    DynamicSegmentSettings* dynamicSegmentSettings)
+                    SECTION* synapseSections,
+                    GrowthRequests* growthRequests,
+                    DynamicSegmentSettings* dynamicSegmentSettings,
+                    WorkerInputBuffer* workerBuffer,
+                    NeuronWorklist* worklist)
 {
     // handle active-state
-    if(neuron->active == 0) {
+    if(section->active[neuronId] == 0) {
         return;
     }
 
-    if(neuron->targetSectionId == UNINIT_STATE_32)
+    const uint32_t targetSectionId = section->targetSectionId[neuronId];
+    if(targetSectionId == UNINIT_STATE_32)
     {
-        updatePosSections[neuronSectionId].positions[neuronId].type = 1;
-        dynamicSegmentSettings->updateSections = 1;
+        if(DO_LEARN) {
+            growthRequests->markNeuron(neuronSectionId, neuronId);
+        }
         return;
     }
 
-    synapseProcessing(neuronId,
-                      neuronSectionId,
-                      &synapseSections[neuron->targetSectionId],
-                      neuron,
-                      neuronSections,
-                      synapseSections,
-                      updatePosSections,
-                      dynamicSegmentSettings,
-                      neuron->potential,
-                      neuron->potential);
+    synapseProcessing<SECTION, DO_LEARN>(neuronId,
+                                         neuronSectionId,
+                                         &synapseSections[targetSectionId],
+                                         neuronSections,
+                                         synapseSections,
+                                         growthRequests,
+                                         dynamicSegmentSettings,
+                                         section->potential[neuronId],
+                                         section->potential[neuronId],
+                                         workerBuffer,
+                                         worklist);
+}
+
+/**
+ * @brief check if the quiet neurons of a segment are in a fixed point, so neuron-sections
+ *        without input and without active neurons can be skipped. This is only the case, if the
+ *        refraction-time is 1, because otherwise the potential of a neuron still decays over
+ *        multiple cycles without any input.
+ *
+ * @param dynamicSegmentSettings settings of the segment
+ *
+ * @return true, if the neurons can be processed event-driven
+ */
+inline bool
+isEventDriven(const DynamicSegmentSettings* dynamicSegmentSettings)
+{
+    return dynamicSegmentSettings->refractionTime == 1;
 }
 
 /**
- * @brief processNeuron
- * @param neuron
- * @param segment
+ * @brief process the synapses of all active neurons of a neuron-section
+ *
+ * @param neuronSectionId id of the neuron-section
+ * @param segment segment where the section belongs to
+ * @param workerBuffer buffer for the partial inputs and the growth-requests of a worker in case
+ *                     of parallel processing
+ * @param worklist worklist to register the target-sections for the next cycle
  */
+template<typename SECTION, bool DO_LEARN>
 inline void
-processNeuron(DynamicNeuron* neuron,
-              DynamicSegmentSettings* dynamicSegmentSettings)
+processSectionSynapses(const uint32_t neuronSectionId,
+                       DynamicSegment &segment,
+                       WorkerInputBuffer* workerBuffer,
+                       NeuronWorklist* worklist)
 {
-    neuron->potential /= dynamicSegmentSettings->neuronCooldown;
-    neuron->refractionTime = neuron->refractionTime >> 1;
+    NeuronSection* neuronSections = segment.neuronSections;
+    SECTION* synapseSections = reinterpret_cast<SECTION*>(segment.synapseSections);
+    DynamicSegmentSettings* dynamicSegmentSettings = segment.dynamicSegmentSettings;
+    NeuronSection* section = &neuronSections[neuronSectionId];
 
-    if(neuron->refractionTime == 0)
-    {
-        neuron->potential = dynamicSegmentSettings->potentialOverflow * neuron->input;
-        neuron->refractionTime = dynamicSegmentSettings->refractionTime;
+    GrowthRequests* growthRequests = &segment.growthRequests;
+    if(workerBuffer != nullptr) {
+        growthRequests = &workerBuffer->growthRequests;
     }
 
-    // update neuron
-    neuron->potential -= neuron->border;
-    neuron->active = neuron->potential > 0.0f;
-    neuron->input = 0.0f;
-    neuron->potential = log2(neuron->potential + 1.0f);
+    for(uint32_t neuronId = 0;
+        neuronId < section->numberOfNeurons;
+        neuronId++)
+    {
+        processSingleNeuron<SECTION, DO_LEARN>(neuronId,
+                                               neuronSectionId,
+                                               section,
+                                               neuronSections,
+                                               synapseSections,
+                                               growthRequests,
+                                               dynamicSegmentSettings,
+                                               workerBuffer,
+                                               worklist);
+    }
 }
 
 /**
- * @brief reset neurons of a output brick
+ * @brief process a range of neuron-sections within the calling thread. The synapse-outputs are
+ *        written directly into the target-neurons. Like in a dense scan, an input to a later
+ *        section of the same brick is consumed within the same cycle, while an input to an
+ *        earlier one is consumed in the next cycle. Normal sections, which are not settled
+ *        after the update, are registered again for the next cycle.
  *
- * @param brick pointer to the brick
- * @param segment segment where the brick belongs to
+ * @param sectionIds ids of the neuron-sections to process, which are ordered by the type of
+ *                   their bricks: input-sections, normal sections and output-sections
+ * @param begin position of the first section of the range
+ * @param end position behind the last section of the range
+ * @param inputEnd position behind the last input-section in the list
+ * @param normalEnd position behind the last normal section in the list
+ * @param segment segment where the sections belong to
  */
+template<typename SECTION, bool DO_LEARN, bool SINGLE_REFRACTION>
 inline void
-processNeuronsOfOutputBrick(const Brick* brick,
-                            NeuronSection* neuronSections,
-                            float* outputTransfers,
-                            DynamicSegmentSettings* dynamicSegmentSettings)
+processNeuronSections(const std::vector<uint32_t> &sectionIds,
+                      const uint32_t begin,
+                      const uint32_t end,
+                      const uint32_t inputEnd,
+                      const uint32_t normalEnd,
+                      DynamicSegment &segment)
 {
-    DynamicNeuron* neuron = nullptr;
-    NeuronSection* section = nullptr;
+    NeuronSection* neuronSections = segment.neuronSections;
+    DynamicSegmentSettings* dynamicSegmentSettings = segment.dynamicSegmentSettings;
+    NeuronWorklist* worklist = &segment.worklist;
 
-    // iterate over all neurons within the brick
-    for(uint32_t neuronSectionId = brick->neuronSectionPos;
-        neuronSectionId < brick->numberOfNeuronSections + brick->neuronSectionPos;
-        neuronSectionId++)
+    for(uint32_t i = begin; i < std::min(end, inputEnd); i++)
     {
-        section = &neuronSections[neuronSectionId];
-        for(uint32_t neuronId = 0;
-            neuronId < section->numberOfNeurons;
-            neuronId++)
+        const uint32_t neuronSectionId = sectionIds[i];
+        processInputNeuronSection(&neuronSections[neuronSectionId], segment.inputTransfers);
+        processSectionSynapses<SECTION, DO_LEARN>(neuronSectionId, segment, nullptr, worklist);
+    }
+
+    // the normal sections are processed brick by brick, where sections, which get an input
+    // from a section before them in the same brick, are processed within the same pass
+    uint32_t brickStart = std::max(begin, inputEnd);
+    const uint32_t brickRangeEnd = std::min(end, normalEnd);
+    while(brickStart < brickRangeEnd)
+    {
+        const uint32_t brickId = neuronSections[sectionIds[brickStart]].brickId;
+        uint32_t brickEnd = brickStart + 1;
+        while(brickEnd < brickRangeEnd
+              && neuronSections[sectionIds[brickEnd]].brickId == brickId)
         {
-            neuron = &section->neurons[neuronId];
-            neuron->potential = dynamicSegmentSettings->potentialOverflow * neuron->input;
-            outputTransfers[neuron->targetBorderId] = neuron->potential;
-            neuron->input = 0.0f;
+            brickEnd++;
         }
+
+        worklist->beginBrick(brickId,
+                             sectionIds.data() + brickStart,
+                             sectionIds.data() + brickEnd);
+
+        uint32_t neuronSectionId = 0;
+        while(worklist->nextSectionOfBrick(neuronSectionId))
+        {
+            NeuronSection* section = &neuronSections[neuronSectionId];
+            const bool notSettled = processNeuronSection<SINGLE_REFRACTION>(
+                                        section, dynamicSegmentSettings);
+            processSectionSynapses<SECTION, DO_LEARN>(neuronSectionId,
+                                                      segment,
+                                                      nullptr,
+                                                      worklist);
+
+            // only with a refraction-time of 1 the settled sections can be skipped
+            if(notSettled || SINGLE_REFRACTION == false) {
+                worklist->markSection(neuronSectionId, section->brickId);
+            }
+        }
+
+        worklist->endBrick();
+        brickStart = brickEnd;
+    }
+
+    // output-neurons have no synapses
+    for(uint32_t i = std::max(begin, normalEnd); i < end; i++)
+    {
+        processOutputNeuronSection(&neuronSections[sectionIds[i]],
+                                   segment.outputTransfers,
+                                   dynamicSegmentSettings);
     }
 }
 
 /**
- * @brief reset neurons of a input brick
+ * @brief add the partial inputs of all workers to the target-neurons. Each worker only handles
+ *        the neuron-sections with (sectionId % numberOfWorker == workerId), so every neuron is
+ *        written by exactly one worker. The buffers are added in the order of the workers, so
+ *        the result doesn't depend on the timing of the threads.
  *
- * @param brick pointer to the brick
- * @param segment segment where the brick belongs to
+ * @param workerId id of the worker
+ * @param neuronSections pointer to all neuron-sections of the segment
+ * @param workerBuffers buffers with the partial inputs of all workers
  */
 inline void
-processNeuronsOfInputBrick(const Brick* brick,
-                           NeuronSection* neuronSections,
-                           float* inputTransfers,
-                           SynapseSection* synapseSections,
-                           UpdatePosSection* updatePosSections,
-                           DynamicSegmentSettings* dynamicSegmentSettings)
+reduceWorkerInputs(const uint32_t workerId,
+                   NeuronSection* neuronSections,
+                   std::vector<WorkerInputBuffer*> &workerBuffers)
 {
-    DynamicNeuron* neuron = nullptr;
-    NeuronSection* section = nullptr;
+    const uint32_t numberOfWorker = workerBuffers.size();
 
-    // iterate over all neurons within the brick
-    for(uint32_t neuronSectionId = brick->neuronSectionPos;
-        neuronSectionId < brick->numberOfNeuronSections + brick->neuronSectionPos;
-        neuronSectionId++)
+    for(WorkerInputBuffer* buffer : workerBuffers)
     {
-        section = &neuronSections[neuronSectionId];
-        for(uint32_t neuronId = 0;
-            neuronId < section->numberOfNeurons;
-            neuronId++)
+        for(uint32_t slotPos = 0; slotPos < buffer->numberOfTouchedSections; slotPos++)
         {
-            neuron = &section->neurons[neuronId];
-            neuron->potential = inputTransfers[neuron->targetBorderId];
-            neuron->active = neuron->potential > 0.0f;
-
-            processSingleNeuron(neuronId,
-                                neuronSectionId,
-                                neuron,
-                                neuronSections,
-                                synapseSections,
-                                updatePosSections,
-                                dynamicSegmentSettings);
+            const uint32_t neuronSectionId = buffer->touchedSections[slotPos];
+            if(neuronSectionId % numberOfWorker == workerId) {
+                addPartialInputs(neuronSections[neuronSectionId].input,
+                                 buffer->slots[slotPos].input);
+            }
         }
     }
 }
 
 /**
- * @brief reset neurons of a normal brick
+ * @brief process a range of neuron-sections with multiple threads. The sections are statically
+ *        split in contiguous parts between the workers, so the result is the same for each run
+ *        with the same number of workers. Because each worker sums up its inputs at first, the
+ *        result can differ from the processing within a single thread by the rounding of the
+ *        additions. The processing runs in 3 steps, which are separated by a join of all
+ *        workers:
+ *            1. update the neurons of the sections
+ *            2. process the synapse-sections of the active neurons into the worker-buffers
+ *            3. add the worker-buffers lane-wise to the target-neurons
+ *        Because of the separation, the range must not contain a brick, which has synapses into
+ *        its own neurons. The worklist is updated afterwards within the calling thread.
  *
- * @param brick pointer to the brick
- * @param segment segment where the brick belongs to
+ * @param sectionIds ids of the neuron-sections to process, which are ordered by the type of
+ *                   their bricks: input-sections, normal sections and output-sections
+ * @param begin position of the first section of the range
+ * @param end position behind the last section of the range
+ * @param inputEnd position behind the last input-section in the list
+ * @param normalEnd position behind the last normal section in the list
+ * @param segment segment where the sections belong to
+ * @param workerPool pool with the worker-threads
+ * @param threaded false to run the parts of the workers one after another within the calling
+ *                 thread
  */
+template<typename SECTION, bool DO_LEARN, bool SINGLE_REFRACTION>
 inline void
-processNeuronsOfNormalBrick(const Brick* brick,
-                            NeuronSection* neuronSections,
-                            SynapseSection* synapseSections,
-                            UpdatePosSection* updatePosSections,
-                            DynamicSegmentSettings* dynamicSegmentSettings)
+processNeuronSectionsParallel(const std::vector<uint32_t> &sectionIds,
+                              const uint32_t begin,
+                              const uint32_t end,
+                              const uint32_t inputEnd,
+                              const uint32_t normalEnd,
+                              DynamicSegment &segment,
+                              WorkerPool* workerPool,
+                              const bool threaded)
 {
-    DynamicNeuron* neuron = nullptr;
-    NeuronSection* section = nullptr;
+    NeuronSection* neuronSections = segment.neuronSections;
+    DynamicSegmentSettings* dynamicSegmentSettings = segment.dynamicSegmentSettings;
+    float* inputTransfers = segment.inputTransfers;
+    float* outputTransfers = segment.outputTransfers;
+    std::vector<WorkerInputBuffer*> &workerBuffers = segment.workerBuffers;
+    NeuronWorklist &worklist = segment.worklist;
 
-    // iterate over all neurons within the brick
-    for(uint32_t neuronSectionId = brick->neuronSectionPos;
-        neuronSectionId < brick->numberOfNeuronSections + brick->neuronSectionPos;
-        neuronSectionId++)
+    const uint32_t numberOfWorker = workerBuffers.size();
+    const uint32_t numberOfSections = end - begin;
+    worklist.keepFlags.assign(numberOfSections, 0);
+
+    // update neurons, where the range of each worker is split by the types of the bricks
+    workerPool->runParallel([&](const uint32_t workerId)
     {
-        section = &neuronSections[neuronSectionId];
-        for(uint32_t neuronId = 0;
-            neuronId < section->numberOfNeurons;
-            neuronId++)
+        const uint32_t start = begin + (numberOfSections * workerId) / numberOfWorker;
+        const uint32_t stop = begin + (numberOfSections * (workerId + 1)) / numberOfWorker;
+
+        for(uint32_t i = start; i < std::min(stop, inputEnd); i++) {
+            processInputNeuronSection(&neuronSections[sectionIds[i]], inputTransfers);
+        }
+
+        for(uint32_t i = std::max(start, inputEnd); i < std::min(stop, normalEnd); i++)
         {
-            neuron = &section->neurons[neuronId];
-            processNeuron(neuron, dynamicSegmentSettings);
-            processSingleNeuron(neuronId,
-                                neuronSectionId,
-                                neuron,
-                                neuronSections,
-                                synapseSections,
-                                updatePosSections,
-                                dynamicSegmentSettings);
+            const bool notSettled = processNeuronSection<SINGLE_REFRACTION>(
+                                        &neuronSections[sectionIds[i]],
+                                        dynamicSegmentSettings);
+            worklist.keepFlags[i - begin] = notSettled || SINGLE_REFRACTION == false;
         }
+
+        for(uint32_t i = std::max(start, normalEnd); i < stop; i++)
+        {
+            processOutputNeuronSection(&neuronSections[sectionIds[i]],
+                                       outputTransfers,
+                                       dynamicSegmentSettings);
+        }
+    }, threaded);
+
+    // process synapses into the worker-buffers
+    workerPool->runParallel([&](const uint32_t workerId)
+    {
+        WorkerInputBuffer* buffer = workerBuffers[workerId];
+
+        // output-neurons have no synapses
+        const uint32_t start = begin + (numberOfSections * workerId) / numberOfWorker;
+        const uint32_t stop = begin + (numberOfSections * (workerId + 1)) / numberOfWorker;
+        for(uint32_t i = start; i < std::min(stop, normalEnd); i++)
+        {
+            processSectionSynapses<SECTION, DO_LEARN>(sectionIds[i], segment, buffer, nullptr);
+        }
+    }, threaded);
+
+    // add worker-buffers to the neurons
+    workerPool->runParallel([&](const uint32_t workerId) {
+        reduceWorkerInputs(workerId, neuronSections, workerBuffers);
+    }, threaded);
+
+    // register the sections for the next cycle
+    for(uint32_t i = 0; i < numberOfSections; i++)
+    {
+        if(worklist.keepFlags[i] != 0)
+        {
+            const uint32_t neuronSectionId = sectionIds[begin + i];
+            worklist.markSection(neuronSectionId, neuronSections[neuronSectionId].brickId);
+        }
+    }
+
+    for(WorkerInputBuffer* buffer : workerBuffers)
+    {
+        for(uint32_t i = 0; i < buffer->numberOfTouchedSections; i++)
+        {
+            const uint32_t neuronSectionId = buffer->touchedSections[i];
+            worklist.markSection(neuronSectionId, neuronSections[neuronSectionId].brickId);
+        }
+
+        buffer->resetTouchedSections();
+        buffer->growthRequests.moveTo(segment.growthRequests);
     }
 }
 
 /**
  * @brief process all neurons within a specific brick and also all synapse-sections,
- *        which are connected to an active neuron
+ *        which are connected to an active neuron. The bricks are processed wavefront by
+ *        wavefront. Bricks within the same wavefront don't feed each other, so the sections of
+ *        all of them are processed together and can be split between the worker-threads. Only
+ *        bricks with synapses into their own neurons are always processed serially, because
+ *        there a section can consume the inputs of an earlier section within the same pass.
  *
  * @param segment segment to process
+ * @param threaded false to run the parts of the workers one after another within the calling
+ *                 thread, which gives the same result like the threaded run
  */
+template<typename SECTION, bool DO_LEARN, bool SINGLE_REFRACTION>
 inline void
-prcessDynamicSegment(DynamicSegment &segment)
+prcessDynamicSegment(DynamicSegment &segment,
+                     const bool threaded = true)
 {
-    Brick* bricks = segment.bricks;
-    uint32_t* brickOrder = segment.brickOrder;
     NeuronSection* neuronSections = segment.neuronSections;
-    SynapseSection* synapseSections = segment.synapseSections;
-    UpdatePosSection* updatePosSections = segment.updatePosSections;
-    SegmentHeader* segmentHeader = segment.segmentHeader;
-    DynamicSegmentSettings* dynamicSegmentSettings = segment.dynamicSegmentSettings;
-    float* inputTransfers = segment.inputTransfers;
-    float* outputTransfers = segment.outputTransfers;
+    NeuronWorklist* worklist = &segment.worklist;
+    std::vector<uint32_t> &sectionIds = worklist->currentSections;
+
+    // check if the sections can be split between multiple worker-threads
+    WorkerPool* workerPool = KyoukoRoot::getWorkerPool(segment.numaNode);
+    uint32_t numberOfWorker = 1;
+    if(workerPool != nullptr) {
+        numberOfWorker = workerPool->getNumberOfWorker();
+    }
 
-    const uint32_t numberOfBricks = segmentHeader->bricks.count;
-    for(uint32_t pos = 0; pos < numberOfBricks; pos++)
+    const uint32_t minParallelSections = numberOfWorker * MIN_NEURON_SECTIONS_PER_WORKER;
+    if(numberOfWorker > 1
+            && segment.workerBuffers.size() != numberOfWorker)
     {
-        const uint32_t brickId = brickOrder[pos];
-        Brick* brick = &bricks[brickId];
-        if(brick->isInputBrick)
-        {
-            processNeuronsOfInputBrick(brick,
-                                       neuronSections,
-                                       inputTransfers,
-                                       synapseSections,
-                                       updatePosSections,
-                                       dynamicSegmentSettings);
+        segment.initWorkerBuffers(numberOfWorker);
+    }
+
+    for(const WavefrontSections &wavefront : segment.wavefrontSections)
+    {
+        // collect the sections of the wavefront, which have to be processed, ordered by type
+        sectionIds.assign(wavefront.inputSections.begin(), wavefront.inputSections.end());
+        const uint32_t inputEnd = sectionIds.size();
+
+        // only the pending sections of a normal brick have to be processed
+        for(const uint32_t brickId : wavefront.normalBricks) {
+            worklist->takeBrickList(brickId);
         }
-        else if(brick->isOutputBrick)
+        const uint32_t normalEnd = sectionIds.size();
+
+        sectionIds.insert(sectionIds.end(),
+                          wavefront.outputSections.begin(),
+                          wavefront.outputSections.end());
+
+        // split the list into ranges, which can be processed in parallel, and the bricks with
+        // synapses into their own neurons, whose sections are always processed serially
+        const uint32_t numberOfSections = sectionIds.size();
+        uint32_t begin = 0;
+        while(begin < numberOfSections)
         {
-            processNeuronsOfOutputBrick(brick,
-                                        neuronSections,
-                                        outputTransfers,
-                                        dynamicSegmentSettings);
+            const uint32_t brickId = neuronSections[sectionIds[begin]].brickId;
+            const bool selfFeeding = segment.selfFeedingBricks[brickId] != 0;
+            uint32_t end = begin + 1;
+            while(end < numberOfSections)
+            {
+                const uint32_t nextBrickId = neuronSections[sectionIds[end]].brickId;
+                if(selfFeeding && nextBrickId != brickId) {
+                    break;
+                }
+                if(selfFeeding == false && segment.selfFeedingBricks[nextBrickId] != 0) {
+                    break;
+                }
+                end++;
+            }
+
+            if(selfFeeding == false
+                    && numberOfWorker > 1
+                    && end - begin >= minParallelSections)
+            {
+                processNeuronSectionsParallel<SECTION, DO_LEARN, SINGLE_REFRACTION>(
+                            sectionIds, begin, end, inputEnd, normalEnd, segment, workerPool,
+                            threaded);
+            }
+            else
+            {
+                processNeuronSections<SECTION, DO_LEARN, SINGLE_REFRACTION>(
+                            sectionIds, begin, end, inputEnd, normalEnd, segment);
+            }
+
+            begin = end;
         }
-        else
-        {
-            processNeuronsOfNormalBrick(brick,
-                                        neuronSections,
-                                        synapseSections,
-                                        updatePosSections,
-                                        dynamicSegmentSettings);
+    }
+}
+
+#ifdef KYOUKO_VERIFY_PARALLEL
+/**
+ * @brief process a segment with the parts of the workers one after another and in parallel from
+ *        the same state and compare the results, which have to be identical, so a race between
+ *        the workers shows up as mismatch. This is only a check for the development, which is
+ *        enabled with "CONFIG += verify_parallel", because the state of the segment is copied
+ *        twice in each cycle.
+ *
+ * @param segment segment to process
+ */
+template<typename SECTION, bool DO_LEARN, bool SINGLE_REFRACTION>
+inline void
+verifyParallelProcessing(DynamicSegment &segment)
+{
+    uint8_t* neurons = reinterpret_cast<uint8_t*>(segment.neuronSections);
+    const uint64_t neuronBytes = segment.segmentHeader->neuronSections.count
+                                 * sizeof(NeuronSection);
+    uint8_t* synapses = static_cast<uint8_t*>(segment.synapseSections);
+    const uint64_t synapseBytes = segment.synapseArena.numberOfSections * sizeof(SECTION);
+    float* outputs = segment.outputTransfers;
+    const uint64_t outputCount = segment.segmentHeader->outputTransfers.count;
+
+    // save the state before the processing
+    const std::vector<uint8_t> neuronsBefore(neurons, neurons + neuronBytes);
+    const std::vector<uint8_t> synapsesBefore(synapses, synapses + synapseBytes);
+    const std::vector<float> outputsBefore(outputs, outputs + outputCount);
+    const NeuronWorklist worklistBefore = segment.worklist;
+    const GrowthRequests growthBefore = segment.growthRequests;
+
+    prcessDynamicSegment<SECTION, DO_LEARN, SINGLE_REFRACTION>(segment, false);
+    const std::vector<uint8_t> sequentialNeurons(neurons, neurons + neuronBytes);
+    const std::vector<uint8_t> sequentialSynapses(synapses, synapses + synapseBytes);
+    const std::vector<float> sequentialOutputs(outputs, outputs + outputCount);
+    const std::vector<uint64_t> sequentialGrowth = segment.growthRequests.pendingNeurons;
+
+    // go back to the saved state and process the segment again
+    memcpy(neurons, neuronsBefore.data(), neuronBytes);
+    memcpy(synapses, synapsesBefore.data(), synapseBytes);
+    memcpy(outputs, outputsBefore.data(), outputCount * sizeof(float));
+    segment.worklist = worklistBefore;
+    segment.growthRequests = growthBefore;
+
+    prcessDynamicSegment<SECTION, DO_LEARN, SINGLE_REFRACTION>(segment, true);
+    if(memcmp(neurons, sequentialNeurons.data(), neuronBytes) != 0
+            || memcmp(synapses, sequentialSynapses.data(), synapseBytes) != 0
+            || memcmp(outputs, sequentialOutputs.data(), outputCount * sizeof(float)) != 0
+            || segment.growthRequests.pendingNeurons != sequentialGrowth)
+    {
+        Kitsunemimi::ErrorContainer error;
+        error.addMeesage("parallel processing of segment '" + segment.getName()
+                         + "' gives a different result than the sequential run of its workers");
+        LOG_ERROR(error);
+    }
+}
+#endif
+
+/**
+ * @brief process a segment with a specific instantiation of the kernels
+ *
+ * @param segment segment to process
+ */
+template<typename SECTION, bool DO_LEARN, bool SINGLE_REFRACTION>
+inline void
+prcessDynamicSegmentKernels(DynamicSegment &segment)
+{
+#ifdef KYOUKO_VERIFY_PARALLEL
+    verifyParallelProcessing<SECTION, DO_LEARN, SINGLE_REFRACTION>(segment);
+#else
+    prcessDynamicSegment<SECTION, DO_LEARN, SINGLE_REFRACTION>(segment);
+#endif
+}
+
+/**
+ * @brief process a segment with the specialized kernels, which fit to its actual settings
+ *
+ * @param segment segment to process
+ */
+template<typename SECTION>
+inline void
+prcessDynamicSegmentWithSettings(DynamicSegment &segment)
+{
+    const DynamicSegmentSettings* settings = segment.dynamicSegmentSettings;
+    const bool singleRefraction = isEventDriven(settings);
+
+    if(settings->doLearn != 0)
+    {
+        if(singleRefraction) {
+            prcessDynamicSegmentKernels<SECTION, true, true>(segment);
+        } else {
+            prcessDynamicSegmentKernels<SECTION, true, false>(segment);
         }
     }
+    else
+    {
+        if(singleRefraction) {
+            prcessDynamicSegmentKernels<SECTION, false, true>(segment);
+        } else {
+            prcessDynamicSegmentKernels<SECTION, false, false>(segment);
+        }
+    }
+}
+
+/**
+ * @brief process a segment with the section-type, which was selected at its creation. The
+ *        instantiation of the kernels is selected only once for the whole segment and not for
+ *        each brick or section.
+ *
+ * @param segment segment to process
+ */
+inline void
+prcessDynamicSegment(DynamicSegment &segment)
+{
+    dispatchSectionType(*segment.dynamicSegmentSettings, [&](auto tag) {
+        prcessDynamicSegmentWithSettings<typename decltype(tag)::type>(segment);
+    });
 }
 
 #endif // KYOUKOMIND_DYNAMIC_PROCESSING_H
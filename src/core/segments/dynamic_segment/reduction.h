@@ -24,92 +24,140 @@
 #define KYOUKOMIND_CREATE_REDUCE_H
 
 #include <common.h>
+#include <type_traits>
 
 #include <kyouko_root.h>
 #include <core/segments/brick.h>
 
 #include "objects.h"
 #include "dynamic_segment.h"
+#include "section_geometry.h"
+#include "synapse_access.h"
 
 /**
- * @brief reduce synapses of a specific section
+ * @brief decay the active-counters of the synapses of a section and remove the synapses, which
+ *        were not active since the last passes and which are weaker than the prune-border of
+ *        the segment. Removed synapses are reset to uninitialized, so their place can be used
+ *        again for a new synapse.
  *
- * @param segment segment where the section belongs to
- * @param section section to resuce
+ * @param section section to reduce
+ * @param dynamicSegmentSettings settings of the segment
  *
  * @return true, if section is empty and can be deleted, else false
  */
+template<typename SECTION>
 inline bool
-reduceSynapses(DynamicSegment &segment,
-               SynapseSection &section)
+reduceSynapses(SECTION* section,
+               const DynamicSegmentSettings* dynamicSegmentSettings)
 {
-    bool foundEnd = false;
+    bool isEmpty = true;
 
-    /*if(section.next != UNINIT_STATE_32)
+    // iterate over all synapses in synapse-section
+    for(uint32_t pos = 0; pos < SECTION::numberOfSynapses; pos++)
     {
-        // delete if sections is empty
-        foundEnd = true;
-        if(reduceSynapses(segment, segment.synapseSections[section.next]) == false)
+        // skip not connected synapses
+        auto* synapse = &section->synapses[pos];
+        if(synapse->targetNeuronId == UNINIT_STATE_16) {
+            continue;
+        }
+
+        synapse->activeCounter -= synapse->activeCounter > 0;
+        if(synapse->activeCounter == 0
+                && std::fabs(getWeight(synapse)) < dynamicSegmentSettings->synapsePruneBorder)
         {
-            segment.segmentData.deleteItem(section.next);
-            section.next = UNINIT_STATE_32;
-            foundEnd = false;
+            // reset the whole slot, so the old border doesn't stay in the chain
+            *synapse = std::remove_reference_t<decltype(*synapse)>();
+            continue;
         }
-    }
 
-    Synapse* synapse = nullptr;
+        isEmpty = false;
+    }
 
-    // iterate over all synapses in synapse-section
-    for(int32_t pos = SYNAPSES_PER_SYNAPSESECTION - 1;
-        pos >= 0;
-        pos--)
-    {
-        // skip not connected synapses
-        synapse = &section.synapses[pos];
+    return isEmpty;
+}
 
-        synapse->activeCounter -= synapse->activeCounter < 100;
-        if(synapse->activeCounter < 5) {
-            synapse->targetNeuronId = UNINIT_STATE_16;
-        }
+/**
+ * @brief reduce the synapse-chains of all neurons of a neuron-section. Empty synapse-sections
+ *        are unlinked from their chain and given back to the section-arena, so they can be used
+ *        again for new sections.
+ *
+ * @param segment segment where the section belongs to
+ * @param neuronSectionId id of the neuron-section
+ */
+template<typename SECTION>
+inline void
+reduceNeuronSection(DynamicSegment &segment,
+                    const uint32_t neuronSectionId)
+{
+    NeuronSection* section = &segment.neuronSections[neuronSectionId];
+    SECTION* synapseSections = reinterpret_cast<SECTION*>(segment.synapseSections);
 
-        if(synapse->targetNeuronId != UNINIT_STATE_16) {
-            foundEnd = true;
+    for(uint32_t neuronId = 0; neuronId < section->numberOfNeurons; neuronId++)
+    {
+        // link, which points to the actual section of the chain
+        uint32_t* link = &section->targetSectionId[neuronId];
+        uint32_t lastId = UNINIT_STATE_32;
+        while(*link != UNINIT_STATE_32)
+        {
+            SECTION* current = &synapseSections[*link];
+            if(reduceSynapses(current, segment.dynamicSegmentSettings))
+            {
+                // delete if sections is empty
+                const uint32_t deleteId = *link;
+                *link = current->nextId;
+                segment.synapseArena.deleteSection(deleteId);
+                segment.resetWeightDeltas(deleteId, SECTION::numberOfSynapses);
+            }
+            else
+            {
+                lastId = *link;
+                link = &current->nextId;
+            }
         }
-    }*/
 
-    return foundEnd;
+        // the tail is the last remaining section of the chain
+        section->chainTailId[neuronId] = lastId;
+    }
 }
 
 /**
- * @brief reduce all synapses within the segment and delete them, if the reach a deletion-border
+ * @brief Reduce the synapses of the segment incrementally. Only every CYCLES_PER_REDUCTION-th
+ *        call handles the next few neuron-sections, so a complete pass is spread over many
+ *        cycles and adds only a small part to each learn-step. Because it runs between two
+ *        cycles, the chains can be relinked without any other access. It is skipped while the
+ *        weight-changes of a mini-batch are collected, because they are bound to the ids of the
+ *        synapse-sections.
  *
  * @param segment current segemnt to process
  */
 inline void
 reduceNeurons(DynamicSegment &segment)
 {
-    SynapseSection* section = nullptr;
-    DynamicNeuron* sourceNeuron = nullptr;
-
-    /*for(uint32_t neuronId = 0;
-        neuronId < segment.segmentHeader->neuronSections.count;
-        neuronId++)
+    const uint32_t numberOfSections = segment.segmentHeader->neuronSections.count;
+    if(numberOfSections == 0
+            || segment.numberOfDeltaSamples != 0)
     {
-        //sourceNeuron = &segment.neurons[neuronId];
-        if(sourceNeuron->targetSectionId == UNINIT_STATE_32) {
-            continue;
-        }
+        return;
+    }
 
-        // set start-values
-        section = &segment.synapseSections[sourceNeuron->targetSectionId];
+    if(segment.cyclesToReduction > 0)
+    {
+        segment.cyclesToReduction--;
+        return;
+    }
+    segment.cyclesToReduction = CYCLES_PER_REDUCTION - 1;
 
-        // delete if sections is empty
-        if(reduceSynapses(segment, *section) == false)
+    dispatchSectionType(*segment.dynamicSegmentSettings, [&](auto tag) {
+        for(uint32_t i = 0; i < NEURON_SECTIONS_PER_REDUCTION; i++)
         {
-            segment.segmentData.deleteItem(sourceNeuron->targetSectionId);
-            sourceNeuron->targetSectionId = UNINIT_STATE_32;
+            if(segment.reductionPos >= numberOfSections) {
+                segment.reductionPos = 0;
+            }
+
+            reduceNeuronSection<typename decltype(tag)::type>(segment, segment.reductionPos);
+            segment.reductionPos++;
         }
-    }*/
+    });
 }
 
 #endif // KYOUKOMIND_CREATE_REDUCE_H
@@ -0,0 +1,298 @@
+/**
+ * @file        section_arena.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+
+#include "section_arena.h"
+
+#include <sys/mman.h>
+
+#include <core/segments/huge_pages.h>
+
+/**
+ * @brief constructor
+ */
+SectionArena::SectionArena() {}
+
+/**
+ * @brief destructor
+ */
+SectionArena::~SectionArena()
+{
+    if(sections != nullptr) {
+        munmap(sections, m_reservedBytes);
+    }
+}
+
+/**
+ * @brief reserve the address-space for the sections. The reservation doesn't commit any memory,
+ *        so the maximum number of sections can be much higher than the actual used number.
+ *
+ * @param maxSections maximum number of sections, which can be stored in the arena
+ * @param sectionSize number of bytes of a single section
+ * @param requestedHugePages type of huge pages, which should back the arena, if available
+ *
+ * @return false, if the address-space can not be reserved, else true
+ */
+bool
+SectionArena::initArena(const uint64_t maxSections,
+                        const uint32_t sectionSize,
+                        const HugePageType requestedHugePages)
+{
+    if(sections != nullptr
+            || sectionSize == 0)
+    {
+        return false;
+    }
+
+    // the highest id is reserved as marker for the end of a chain
+    maxNumberOfSections = std::min(maxSections, static_cast<uint64_t>(UNINIT_STATE_32));
+    const uint64_t maxNumberOfBlocks = (maxNumberOfSections + SYNAPSE_SECTIONS_PER_BLOCK - 1)
+                                       / SYNAPSE_SECTIONS_PER_BLOCK;
+    m_reservedBytes = std::max(maxNumberOfBlocks, static_cast<uint64_t>(1))
+                      * SYNAPSE_SECTIONS_PER_BLOCK
+                      * sectionSize;
+    m_sectionSize = sectionSize;
+
+    hugePageType = requestedHugePages;
+    void* reserved = reserveMemory(m_reservedBytes, hugePageType);
+    if(reserved == nullptr)
+    {
+        Kitsunemimi::ErrorContainer error;
+        error.addMeesage("Failed to reserve memory for "
+                         + std::to_string(maxNumberOfSections)
+                         + " synapse-sections");
+        LOG_ERROR(error);
+        m_reservedBytes = 0;
+        return false;
+    }
+
+    sections = reserved;
+    return true;
+}
+
+/**
+ * @brief get the position of a section within the arena
+ *
+ * @param sectionId id of the section
+ *
+ * @return pointer to the first byte of the section
+ */
+uint8_t*
+SectionArena::getSectionData(const uint32_t sectionId) const
+{
+    return &static_cast<uint8_t*>(sections)[static_cast<uint64_t>(sectionId) * m_sectionSize];
+}
+
+/**
+ * @brief get the id of an unused section. Deleted sections are used again at first, before the
+ *        next block is taken.
+ *
+ * @return id of the section, UNINIT_STATE_32 if the arena is full
+ */
+uint32_t
+SectionArena::getFreeId()
+{
+    if(m_freeIds.size() > 0)
+    {
+        const uint32_t sectionId = m_freeIds.back();
+        m_freeIds.pop_back();
+        return sectionId;
+    }
+
+    if(numberOfSections >= maxNumberOfSections) {
+        return UNINIT_STATE_32;
+    }
+
+    // take the next block
+    if(numberOfSections == numberOfBlocks * SYNAPSE_SECTIONS_PER_BLOCK) {
+        numberOfBlocks++;
+    }
+
+    const uint32_t sectionId = static_cast<uint32_t>(numberOfSections);
+    numberOfSections++;
+    return sectionId;
+}
+
+/**
+ * @brief delete a section, so its place can be used for a new section
+ *
+ * @param sectionId id of the section to delete
+ *
+ * @return false, if the id is invalid or the section was already deleted, else true
+ */
+bool
+SectionArena::deleteSection(const uint32_t sectionId)
+{
+    // the active-flag is the first byte of the header of all section-layouts
+    if(sectionId >= numberOfSections
+            || *getSectionData(sectionId) == Kitsunemimi::ItemBuffer::DELETED_SECTION)
+    {
+        return false;
+    }
+
+    *getSectionData(sectionId) = Kitsunemimi::ItemBuffer::DELETED_SECTION;
+    m_freeIds.push_back(sectionId);
+    return true;
+}
+
+/**
+ * @brief get the size of a single section within the arena
+ *
+ * @return number of bytes
+ */
+uint32_t
+SectionArena::getSectionSize() const
+{
+    return m_sectionSize;
+}
+
+/**
+ * @brief get the size of the reserved address-space of the arena
+ *
+ * @return number of bytes
+ */
+uint64_t
+SectionArena::getReservedSize() const
+{
+    return m_reservedBytes;
+}
+
+/**
+ * @brief get the size of the sections within a snapshot. The used sections are followed by a
+ *        trailer with a marker of the format, the size of a single section and their number, so
+ *        the size can be read from the end of the snapshot of the segment.
+ *
+ * @return number of bytes
+ */
+uint64_t
+SectionArena::getSnapshotSize() const
+{
+    return numberOfSections * m_sectionSize + SYNAPSE_SNAPSHOT_TRAILER_SIZE;
+}
+
+/**
+ * @brief read the trailer at the end of the snapshot of a segment
+ *
+ * @param data pointer to the snapshot of the segment
+ * @param dataSize size of the snapshot of the segment
+ * @param sectionSize reference for the size of a single section
+ * @param numberOfSections reference for the number of sections
+ *
+ * @return false, if the snapshot has no valid trailer of the actual format, else true
+ */
+bool
+SectionArena::readSnapshotTrailer(const void* data,
+                                  const uint64_t dataSize,
+                                  uint64_t &sectionSize,
+                                  uint64_t &numberOfSections)
+{
+    if(data == nullptr
+            || dataSize < SYNAPSE_SNAPSHOT_TRAILER_SIZE)
+    {
+        return false;
+    }
+
+    uint64_t magic = 0;
+    const uint8_t* trailer = static_cast<const uint8_t*>(data)
+                             + dataSize
+                             - SYNAPSE_SNAPSHOT_TRAILER_SIZE;
+    memcpy(&magic, &trailer[0], sizeof(uint64_t));
+    memcpy(&sectionSize, &trailer[8], sizeof(uint64_t));
+    memcpy(&numberOfSections, &trailer[16], sizeof(uint64_t));
+
+    // snapshots of older versions have another layout and can not be restored
+    if(magic != SYNAPSE_SNAPSHOT_MAGIC
+            || sectionSize == 0
+            || numberOfSections > (dataSize - SYNAPSE_SNAPSHOT_TRAILER_SIZE) / sectionSize)
+    {
+        return false;
+    }
+
+    return true;
+}
+
+/**
+ * @brief get the size of the part of the snapshot of a segment, which comes before the sections
+ *
+ * @param data pointer to the snapshot of the segment
+ * @param dataSize size of the snapshot of the segment
+ *
+ * @return number of bytes, 0 if the snapshot is invalid
+ */
+uint64_t
+SectionArena::getStaticSnapshotSize(const void* data,
+                                    const uint64_t dataSize)
+{
+    uint64_t sectionSize = 0;
+    uint64_t numberOfSections = 0;
+    if(readSnapshotTrailer(data, dataSize, sectionSize, numberOfSections) == false) {
+        return 0;
+    }
+
+    return dataSize - numberOfSections * sectionSize - SYNAPSE_SNAPSHOT_TRAILER_SIZE;
+}
+
+/**
+ * @brief copy the sections from the snapshot of a segment into the arena
+ *
+ * @param data pointer to the snapshot of the segment
+ * @param dataSize size of the snapshot of the segment
+ *
+ * @return false, if the arena is not initialized, the snapshot has an invalid trailer or
+ *         doesn't fit into the arena, else true
+ */
+bool
+SectionArena::restoreSnapshot(const void* data,
+                              const uint64_t dataSize)
+{
+    uint64_t sectionSize = 0;
+    uint64_t snapshotSections = 0;
+    if(sections == nullptr
+            || readSnapshotTrailer(data, dataSize, sectionSize, snapshotSections) == false)
+    {
+        return false;
+    }
+
+    if(sectionSize != m_sectionSize
+            || snapshotSections > maxNumberOfSections)
+    {
+        return false;
+    }
+
+    const uint64_t staticSize = getStaticSnapshotSize(data, dataSize);
+    const uint8_t* u8Data = static_cast<const uint8_t*>(data);
+    memcpy(sections, &u8Data[staticSize], snapshotSections * m_sectionSize);
+    numberOfSections = snapshotSections;
+    numberOfBlocks = (numberOfSections + SYNAPSE_SECTIONS_PER_BLOCK - 1)
+                     / SYNAPSE_SECTIONS_PER_BLOCK;
+
+    // collect the deleted sections again
+    m_freeIds.clear();
+    for(uint64_t i = 0; i < numberOfSections; i++)
+    {
+        if(*getSectionData(i) == Kitsunemimi::ItemBuffer::DELETED_SECTION) {
+            m_freeIds.push_back(static_cast<uint32_t>(i));
+        }
+    }
+
+    return true;
+}
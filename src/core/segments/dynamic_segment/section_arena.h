@@ -0,0 +1,99 @@
+/**
+ * @file        section_arena.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+
+#ifndef KYOUKOMIND_DYNAMIC_SECTION_ARENA_H
+#define KYOUKOMIND_DYNAMIC_SECTION_ARENA_H
+
+#include <common.h>
+
+#include "objects.h"
+
+/**
+ * @brief Storage for the synapse-sections of a segment. The address-space for the maximum number
+ *        of sections is reserved once at the beginning, but the memory is only committed by the
+ *        kernel, when a section is written for the first time. New sections are handed out block
+ *        by block, so the segment starts small and grows on demand without any copy, and the
+ *        pointer to the sections stays valid over the whole lifetime. Each section is addressed
+ *        by its 32-bit id, which is also used for the links between the sections. With hugetlb
+ *        the whole address-space is committed at once from the huge pages of the host. The
+ *        size of a section depends on the layout, which was selected for the segment, so the
+ *        arena only knows the stride and the processing casts the sections to the actual type.
+ */
+class SectionArena
+{
+public:
+    SectionArena();
+    ~SectionArena();
+
+    bool initArena(const uint64_t maxSections,
+                   const uint32_t sectionSize,
+                   const HugePageType requestedHugePages = NO_HUGE_PAGES);
+
+    /**
+     * @brief add a new section to the arena
+     *
+     * @param section section to copy into the arena
+     *
+     * @return id of the new section, UNINIT_STATE_32 if the arena is full
+     */
+    template<typename SECTION>
+    uint32_t
+    addNewSection(const SECTION &section)
+    {
+        assert(sizeof(SECTION) == m_sectionSize);
+
+        const uint32_t sectionId = getFreeId();
+        if(sectionId != UNINIT_STATE_32) {
+            memcpy(getSectionData(sectionId), &section, sizeof(SECTION));
+        }
+        return sectionId;
+    }
+
+    bool deleteSection(const uint32_t sectionId);
+
+    uint32_t getSectionSize() const;
+    uint64_t getReservedSize() const;
+    uint64_t getSnapshotSize() const;
+    static uint64_t getStaticSnapshotSize(const void* data, const uint64_t dataSize);
+    bool restoreSnapshot(const void* data, const uint64_t dataSize);
+
+    void* sections = nullptr;
+    uint64_t maxNumberOfSections = 0;
+    uint64_t numberOfSections = 0;
+    uint64_t numberOfBlocks = 0;
+    HugePageType hugePageType = NO_HUGE_PAGES;
+
+private:
+    uint64_t m_reservedBytes = 0;
+    uint32_t m_sectionSize = 0;
+    std::vector<uint32_t> m_freeIds;
+
+    uint32_t getFreeId();
+    uint8_t* getSectionData(const uint32_t sectionId) const;
+    static bool readSnapshotTrailer(const void* data,
+                                    const uint64_t dataSize,
+                                    uint64_t &sectionSize,
+                                    uint64_t &numberOfSections);
+};
+
+#endif // KYOUKOMIND_DYNAMIC_SECTION_ARENA_H
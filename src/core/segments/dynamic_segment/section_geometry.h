@@ -0,0 +1,108 @@
+/**
+ * @file        section_geometry.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+
+#ifndef KYOUKOMIND_DYNAMIC_SECTION_GEOMETRY_H
+#define KYOUKOMIND_DYNAMIC_SECTION_GEOMETRY_H
+
+#include <common.h>
+
+#include "objects.h"
+
+// The synapse-format and the geometry of the sections are selected at the creation of a segment.
+// All processing-functions are templates over the type of the section, so the instantiation is
+// selected only once at the entry of each processing-step and not for each single section.
+
+/**
+ * @brief empty type to hand over the selected section-type to a generic lambda
+ */
+template<typename SECTION>
+struct SectionTag
+{
+    typedef SECTION type;
+};
+
+/**
+ * @brief call a function with the section-type, which belongs to the settings of a segment
+ *
+ * @param settings settings of the segment
+ * @param func generic function, which gets a SectionTag of the selected section-type
+ */
+template<typename FUNC>
+inline void
+dispatchSectionType(const DynamicSegmentSettings &settings, FUNC &&func)
+{
+    if(settings.synapseFormat == COMPACT_SYNAPSE_FORMAT)
+    {
+        switch(settings.sectionGeometry)
+        {
+            case SMALL_SECTION_GEOMETRY:
+                func(SectionTag<SmallCompactSynapseSection>());
+                break;
+            case LARGE_SECTION_GEOMETRY:
+                func(SectionTag<LargeCompactSynapseSection>());
+                break;
+            default:
+                func(SectionTag<CompactSynapseSection>());
+                break;
+        }
+    }
+    else
+    {
+        switch(settings.sectionGeometry)
+        {
+            case SMALL_SECTION_GEOMETRY:
+                func(SectionTag<SmallSynapseSection>());
+                break;
+            case LARGE_SECTION_GEOMETRY:
+                func(SectionTag<LargeSynapseSection>());
+                break;
+            default:
+                func(SectionTag<SynapseSection>());
+                break;
+        }
+    }
+}
+
+/**
+ * @brief get the size of a single section for a synapse-format and a geometry
+ *
+ * @param synapseFormat format of the synapses
+ * @param sectionGeometry geometry of the sections
+ *
+ * @return number of bytes of a section
+ */
+inline uint32_t
+getSectionSize(const uint8_t synapseFormat, const uint8_t sectionGeometry)
+{
+    DynamicSegmentSettings settings;
+    settings.synapseFormat = synapseFormat;
+    settings.sectionGeometry = sectionGeometry;
+
+    uint32_t sectionSize = 0;
+    dispatchSectionType(settings, [&](auto tag) {
+        sectionSize = sizeof(typename decltype(tag)::type);
+    });
+    return sectionSize;
+}
+
+#endif // KYOUKOMIND_DYNAMIC_SECTION_GEOMETRY_H
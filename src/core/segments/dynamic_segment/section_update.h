@@ -30,54 +30,64 @@
 
 #include "objects.h"
 #include "dynamic_segment.h"
+#include "section_geometry.h"
 
 /**
- * @brief getForwardLast
- * @param sourceId
- * @param sectionConnections
- * @return
+ * @brief get the last section of a chain by walking over the complete chain. This is only
+ *        necessary to rebuild the tails of the chains, because they are tracked for each neuron.
+ *
+ * @param sourceId id of the first section of the chain
+ * @param sectionConnections pointer to all synapse-sections of the segment
+ *
+ * @return id of the last section of the chain
  */
-inline SynapseSection*
+template<typename SECTION>
+inline uint32_t
 getForwardLast(const uint32_t sourceId,
-               SynapseSection* sectionConnections)
+               const SECTION* sectionConnections)
 {
-    SynapseSection* connection = &sectionConnections[sourceId];
-    if(connection->nextId == UNINIT_STATE_32) {
-        return connection;
+    uint32_t lastId = sourceId;
+    while(sectionConnections[lastId].nextId != UNINIT_STATE_32) {
+        lastId = sectionConnections[lastId].nextId;
     }
 
-    return getForwardLast(connection->nextId, sectionConnections);
+    return lastId;
 }
 
 /**
  * @brief add new basic synapse-section to segment
  *
+ * @param result new section, which has to be initialized
  * @param segment refernce to segment
- *
- * @return position in buffer, where the section was added
+ * @param currentBrick brick of the source-neuron
+ * @param streamKey key of the random-stream for the new section
  */
+template<typename SECTION>
 inline void
-createNewSection(SynapseSection &result,
+createNewSection(SECTION &result,
                  DynamicSegment &segment,
-                 const Brick &currentBrick)
+                 const Brick &currentBrick,
+                 const uint32_t streamKey)
 {
+    const uint32_t seed = segment.dynamicSegmentSettings->randomSeed;
+
     result.active = Kitsunemimi::ItemBuffer::ACTIVE_SECTION;
-    result.randomPos = rand() % NUMBER_OF_RAND_VALUES;
-    result.randomPos = (result.randomPos + 1) % NUMBER_OF_RAND_VALUES;
-    const uint32_t randVal = KyoukoRoot::m_randomValues[result.randomPos] % 1000;
+    result.randomPos = getRandomValue(seed, streamKey, 0);
+    const uint32_t randVal = getRandomValue(seed, streamKey, 1) % 1000;
     const uint32_t brickId = currentBrick.possibleTargetNeuronBrickIds[randVal];
-    result.randomPos = (result.randomPos + 1) % NUMBER_OF_RAND_VALUES;
     result.targetNeuronSectionId = segment.bricks[brickId].neuronSectionPos;
-    result.targetNeuronSectionId += KyoukoRoot::m_randomValues[result.randomPos]
+    result.targetNeuronSectionId += getRandomValue(seed, streamKey, 2)
                                      % segment.bricks[brickId].numberOfNeuronSections;
 }
 
 /**
- * @brief processUpdatePositon_Cpu
- * @param segment
- * @param sectionId
- * @param sourceUpdatePos
+ * @brief append a new synapse-section at the end of the chain of a neuron
+ *
+ * @param segment segment where the neuron belongs to
+ * @param sectionId id of the section of the neuron
+ * @param neuronId id of the neuron within its section
  */
+template<typename SECTION>
 inline void
 processUpdatePositon_Cpu(DynamicSegment &segment,
                          const uint32_t sectionId,
@@ -85,51 +95,89 @@ processUpdatePositon_Cpu(DynamicSegment &segment,
 {
     NeuronSection* sourceSection = &segment.neuronSections[sectionId];
     Brick* currentBrick = &segment.bricks[sourceSection->brickId];
+    uint32_t* targetSectionId = &sourceSection->targetSectionId[neuronId];
+    uint32_t* chainTailId = &sourceSection->chainTailId[neuronId];
 
-    SynapseSection newSection;
-    createNewSection(newSection, segment, *currentBrick);
-    const uint64_t newId = segment.segmentData.addNewItem(newSection);
-    if(newId == ITEM_BUFFER_UNDEFINE_POS) {
+    // the random-stream of the new section is defined by the source-neuron and the actual end
+    // of its chain, so every growth-step gets its own stream without any shared state
+    uint32_t lastId = UNINIT_STATE_32;
+    if(*targetSectionId != UNINIT_STATE_32) {
+        lastId = *chainTailId;
+    }
+    const uint32_t neuronKey = sectionId * NEURONS_PER_NEURONSECTION + neuronId;
+    const uint32_t streamKey = getRandomValue(segment.dynamicSegmentSettings->randomSeed,
+                                              neuronKey,
+                                              lastId);
+
+    SECTION newSection;
+    createNewSection(newSection, segment, *currentBrick, streamKey);
+    const uint32_t newId = segment.synapseArena.addNewSection(newSection);
+    if(newId == UNINIT_STATE_32)
+    {
+        // the segment can only grow again, after the reduction gave back some sections
+        if(segment.sectionLimitReached == false)
+        {
+            LOG_WARNING("all synapse-sections of the segment are in use. "
+                        "The segment stops growing until synapses are reduced.");
+            segment.sectionLimitReached = true;
+        }
         return;
     }
+    segment.sectionLimitReached = false;
+    segment.resetWeightDeltas(newId, SECTION::numberOfSynapses);
 
-    DynamicNeuron* neuron = &sourceSection->neurons[neuronId];
-    if(neuron->targetSectionId == UNINIT_STATE_32) {
-        neuron->targetSectionId = newId;
+    if(lastId == UNINIT_STATE_32) {
+        *targetSectionId = newId;
     } else {
-        getForwardLast(neuron->targetSectionId, segment.synapseSections)->nextId = newId;
+        reinterpret_cast<SECTION*>(segment.synapseSections)[lastId].nextId = newId;
     }
+    *chainTailId = newId;
 }
 
 /**
- * @brief updateSections
- * @param segment
+ * @brief add a new synapse-section to all neurons, which requested one in the last forward-pass
+ *
+ * @param segment segment to update
  */
+template<typename SECTION>
 inline void
 updateSections(DynamicSegment &segment)
 {
-    UpdatePosSection* sourceUpdatePosSection = nullptr;
-    UpdatePos* sourceUpdatePos = nullptr;
+    GrowthRequests &growthRequests = segment.growthRequests;
 
-    // iterate over all neurons and add new synapse-section, if required
-    for(uint32_t i = 0;
-        i < segment.segmentHeader->updatePosSections.count;
-        i++)
+    // the order of the requests depends on the number of workers, so sort them to get the same
+    // section-ids for the same network
+    std::sort(growthRequests.dirtySections.begin(), growthRequests.dirtySections.end());
+
+    // iterate only over the neurons, which requested a new section
+    for(const uint32_t neuronSectionId : growthRequests.dirtySections)
     {
-        sourceUpdatePosSection = &segment.updatePosSections[i];
-        for(uint32_t pos = 0;
-            pos < sourceUpdatePosSection->numberOfPositions;
-            pos++)
+        uint64_t pending = growthRequests.pendingNeurons[neuronSectionId];
+        growthRequests.pendingNeurons[neuronSectionId] = 0;
+
+        while(pending != 0)
         {
-            sourceUpdatePos = &sourceUpdatePosSection->positions[pos];
-            if(sourceUpdatePos->type == 1)
-            {
-                sourceUpdatePos->type = 0;
-                sourceUpdatePos->forwardNewId = UNINIT_STATE_32;
-                processUpdatePositon_Cpu(segment, i, pos);
-            }
+            const uint32_t neuronId = static_cast<uint32_t>(__builtin_ctzll(pending));
+            pending &= pending - 1;
+            processUpdatePositon_Cpu<SECTION>(segment, neuronSectionId, neuronId);
         }
     }
+
+    growthRequests.dirtySections.clear();
+}
+
+/**
+ * @brief add a new synapse-section to all neurons, which requested one, with the section-type,
+ *        which was selected at the creation of the segment
+ *
+ * @param segment segment to update
+ */
+inline void
+updateSections(DynamicSegment &segment)
+{
+    dispatchSectionType(*segment.dynamicSegmentSettings, [&](auto tag) {
+        updateSections<typename decltype(tag)::type>(segment);
+    });
 }
 
 #endif // KYOUKOMIND_SECTION_UPDATE_H
@@ -0,0 +1,291 @@
+/**
+ * @file        synapse_access.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_DYNAMIC_SYNAPSE_ACCESS_H
+#define KYOUKOMIND_DYNAMIC_SYNAPSE_ACCESS_H
+
+#include <common.h>
+
+#include "objects.h"
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif
+
+// The processing-functions are templates over the type of the synapse-section. The functions
+// in this file give all synapse-types the same interface for weight and border, so the
+// templates don't have to know, how the values are stored.
+
+/**
+ * @brief convert a float into a half-precision float with round-to-nearest-even
+ *
+ * @param value value to convert
+ *
+ * @return bits of the half-precision float
+ */
+inline uint16_t
+floatToHalf(const float value)
+{
+#if defined(__F16C__)
+    return static_cast<uint16_t>(_cvtss_sh(value, _MM_FROUND_TO_NEAREST_INT));
+#else
+    uint32_t bits = 0;
+    memcpy(&bits, &value, sizeof(float));
+
+    const uint16_t sign = static_cast<uint16_t>((bits >> 16) & 0x8000);
+    const uint32_t floatExponent = (bits >> 23) & 0xff;
+    const int32_t exponent = static_cast<int32_t>(floatExponent) - 127 + 15;
+    uint32_t mantissa = bits & 0x7fffff;
+
+    // infinity and nan
+    if(floatExponent == 0xff) {
+        return sign | 0x7c00 | (mantissa != 0 ? 0x200 : 0);
+    }
+
+    // overflow
+    if(exponent >= 31) {
+        return sign | 0x7c00;
+    }
+
+    // subnormal half or zero
+    if(exponent <= 0)
+    {
+        if(exponent < -10) {
+            return sign;
+        }
+
+        mantissa |= 0x800000;
+        const uint32_t shift = static_cast<uint32_t>(14 - exponent);
+        uint32_t half = mantissa >> shift;
+        const uint32_t rest = mantissa & ((1u << shift) - 1);
+        const uint32_t halfway = 1u << (shift - 1);
+        if(rest > halfway
+                || (rest == halfway && (half & 1) != 0))
+        {
+            half++;
+        }
+        return sign | static_cast<uint16_t>(half);
+    }
+
+    // normal half, where a carry of the rounding correctly goes into the exponent
+    uint32_t half = (static_cast<uint32_t>(exponent) << 10) | (mantissa >> 13);
+    const uint32_t rest = mantissa & 0x1fff;
+    if(rest > 0x1000
+            || (rest == 0x1000 && (half & 1) != 0))
+    {
+        half++;
+    }
+    return sign | static_cast<uint16_t>(half);
+#endif
+}
+
+/**
+ * @brief convert a half-precision float into a float
+ *
+ * @param value bits of the half-precision float
+ *
+ * @return converted value
+ */
+inline float
+halfToFloat(const uint16_t value)
+{
+#if defined(__F16C__)
+    return _cvtsh_ss(value);
+#else
+    const uint32_t sign = static_cast<uint32_t>(value & 0x8000) << 16;
+    uint32_t exponent = (value >> 10) & 0x1f;
+    uint32_t mantissa = value & 0x3ff;
+    uint32_t bits = 0;
+
+    if(exponent == 0x1f)
+    {
+        // infinity and nan, where nan is always returned as quiet nan
+        bits = sign | 0x7f800000 | (mantissa << 13) | (mantissa != 0 ? 0x400000 : 0);
+    }
+    else if(exponent == 0)
+    {
+        if(mantissa == 0)
+        {
+            bits = sign;
+        }
+        else
+        {
+            // normalize subnormal value
+            exponent = 127 - 15 + 1;
+            while((mantissa & 0x400) == 0)
+            {
+                mantissa <<= 1;
+                exponent--;
+            }
+            mantissa &= 0x3ff;
+            bits = sign | (exponent << 23) | (mantissa << 13);
+        }
+    }
+    else
+    {
+        bits = sign | ((exponent + 127 - 15) << 23) | (mantissa << 13);
+    }
+
+    float result = 0.0f;
+    memcpy(&result, &bits, sizeof(float));
+    return result;
+#endif
+}
+
+/**
+ * @brief convert a float into a half-precision float with stochastic rounding. The value is
+ *        rounded up with a probability, which is proportional to its distance to the next lower
+ *        half-value, so changes below the precision of the half are not lost on average.
+ *
+ * @param value value to convert
+ * @param randomValue random-value, from which the lowest 13 bits are used
+ *
+ * @return bits of the half-precision float
+ */
+inline uint16_t
+floatToHalfStochastic(const float value, const uint32_t randomValue)
+{
+    uint32_t bits = 0;
+    memcpy(&bits, &value, sizeof(float));
+
+    // only values within the range of the normal halfs are rounded stochastically
+    const uint32_t floatExponent = (bits >> 23) & 0xff;
+    if(floatExponent < 127 - 14
+            || floatExponent > 127 + 15)
+    {
+        return floatToHalf(value);
+    }
+
+    // add the random-value to the bits, which are cut off, and truncate the result, where a
+    // carry correctly goes into the exponent. The result is exactly representable as half.
+    bits += randomValue & 0x1fff;
+    bits &= ~static_cast<uint32_t>(0x1fff);
+
+    float rounded = 0.0f;
+    memcpy(&rounded, &bits, sizeof(float));
+    return floatToHalf(rounded);
+}
+
+//==================================================================================================
+
+/**
+ * @brief get weight of a synapse
+ */
+inline float
+getWeight(const Synapse* synapse)
+{
+    return synapse->weight;
+}
+
+/**
+ * @brief set weight of a synapse
+ */
+inline void
+setWeight(Synapse* synapse, const float weight)
+{
+    synapse->weight = weight;
+}
+
+/**
+ * @brief update weight of a synapse while learning
+ */
+inline void
+updateWeight(Synapse* synapse, const float weight, const uint32_t, const uint32_t)
+{
+    synapse->weight = weight;
+}
+
+/**
+ * @brief get border of a synapse
+ */
+inline float
+getBorder(const Synapse* synapse)
+{
+    return synapse->border;
+}
+
+/**
+ * @brief set border of a synapse
+ */
+inline void
+setBorder(Synapse* synapse, const float border)
+{
+    synapse->border = border;
+}
+
+/**
+ * @brief get weight of a synapse
+ */
+inline float
+getWeight(const CompactSynapse* synapse)
+{
+    return halfToFloat(synapse->weight);
+}
+
+/**
+ * @brief set weight of a synapse
+ */
+inline void
+setWeight(CompactSynapse* synapse, const float weight)
+{
+    synapse->weight = floatToHalf(weight);
+}
+
+/**
+ * @brief update weight of a synapse while learning. Most updates are smaller than the precision
+ *        of the half, so they are rounded stochastically, because with round-to-nearest they
+ *        would be lost completely. The random-value is derived from the learn-step and the
+ *        position of the synapse, so the result doesn't depend on the order of the processing.
+ *
+ * @param synapse synapse to update
+ * @param weight new weight
+ * @param roundingSeed seed of the current learn-step
+ * @param synapseKey unique key of the synapse within the segment
+ */
+inline void
+updateWeight(CompactSynapse* synapse,
+             const float weight,
+             const uint32_t roundingSeed,
+             const uint32_t synapseKey)
+{
+    synapse->weight = floatToHalfStochastic(weight, getRandomValue(roundingSeed, synapseKey, 0));
+}
+
+/**
+ * @brief get border of a synapse
+ */
+inline float
+getBorder(const CompactSynapse* synapse)
+{
+    return halfToFloat(synapse->border);
+}
+
+/**
+ * @brief set border of a synapse
+ */
+inline void
+setBorder(CompactSynapse* synapse, const float border)
+{
+    synapse->border = floatToHalf(border);
+}
+
+#endif // KYOUKOMIND_DYNAMIC_SYNAPSE_ACCESS_H
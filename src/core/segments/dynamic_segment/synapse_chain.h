@@ -0,0 +1,126 @@
+/**
+ * @file        synapse_chain.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_DYNAMIC_SYNAPSE_CHAIN_H
+#define KYOUKOMIND_DYNAMIC_SYNAPSE_CHAIN_H
+
+#include <common.h>
+
+#include "objects.h"
+
+/**
+ * @brief prefetch a complete synapse-section for writing
+ *
+ * @param section section to prefetch
+ */
+template<typename SECTION>
+inline void
+prefetchSynapseSection(const SECTION* section)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(section);
+    for(uint32_t i = 0; i < sizeof(SECTION); i += 64) {
+        __builtin_prefetch(data + i, 1, 3);
+    }
+}
+
+/**
+ * @brief prefetch a single array of a neuron-section
+ *
+ * @param array pointer to the start of the array within the neuron-section
+ */
+inline void
+prefetchNeuronArray(const float* array)
+{
+    const uint8_t* data = reinterpret_cast<const uint8_t*>(array);
+    for(uint32_t i = 0; i < NEURON_LANES_PER_NEURONSECTION * sizeof(float); i += 64) {
+        __builtin_prefetch(data + i, 1, 3);
+    }
+}
+
+/**
+ * @brief Walk iteratively over the chain of synapse-sections of a neuron, which is used by the
+ *        forward- and the backward-pass. Each hop in the chain is a dependent load of a random
+ *        section, so the loads are software-pipelined: while a section is processed, the
+ *        section after the next one and the target neuron-section of the next one are already
+ *        prefetched. The header of the next section was prefetched one step before, so reading
+ *        its links doesn't stall.
+ *
+ * @param section first section of the chain
+ * @param synapseSections pointer to all synapse-sections of the segment
+ * @param neuronSections pointer to all neuron-sections of the segment
+ * @param netH weight-value, which comes into the chain
+ * @param prefetchTarget function to prefetch the required parts of a target neuron-section
+ * @param processSection function to process a single section, which gets the section and the
+ *                       remaining weight and returns the new remaining weight
+ *
+ * @return last section of the chain, if the chain ended before the weight was consumed, else
+ *         nullptr
+ */
+template<typename SECTION, typename PREFETCH_FUNC, typename PROCESS_FUNC>
+inline SECTION*
+walkSynapseChain(SECTION* section,
+                 SECTION* synapseSections,
+                 NeuronSection* neuronSections,
+                 float netH,
+                 PREFETCH_FUNC prefetchTarget,
+                 PROCESS_FUNC processSection)
+{
+    SECTION* next = nullptr;
+    SECTION* afterNext = nullptr;
+
+    prefetchTarget(&neuronSections[section->targetNeuronSectionId]);
+    if(section->nextId != UNINIT_STATE_32)
+    {
+        next = &synapseSections[section->nextId];
+        prefetchSynapseSection(next);
+    }
+
+    while(true)
+    {
+        // look one step further ahead
+        afterNext = nullptr;
+        if(next != nullptr)
+        {
+            prefetchTarget(&neuronSections[next->targetNeuronSectionId]);
+            if(next->nextId != UNINIT_STATE_32)
+            {
+                afterNext = &synapseSections[next->nextId];
+                prefetchSynapseSection(afterNext);
+            }
+        }
+
+        netH = processSection(section, netH);
+
+        // check if the weight is consumed or the end of the chain is reached
+        if(netH <= 0.01f) {
+            return nullptr;
+        }
+        if(next == nullptr) {
+            return section;
+        }
+
+        section = next;
+        next = afterNext;
+    }
+}
+
+#endif // KYOUKOMIND_DYNAMIC_SYNAPSE_CHAIN_H
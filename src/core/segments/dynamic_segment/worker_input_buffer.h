@@ -0,0 +1,115 @@
+/**
+ * @file        worker_input_buffer.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_DYNAMIC_WORKER_INPUT_BUFFER_H
+#define KYOUKOMIND_DYNAMIC_WORKER_INPUT_BUFFER_H
+
+#include <common.h>
+
+#include "objects.h"
+#include "growth_requests.h"
+
+/**
+ * @brief Partial inputs of a worker for all lanes of a single neuron-section
+ */
+struct alignas(64) PartialInputs
+{
+    float input[NEURON_LANES_PER_NEURONSECTION];
+};
+
+/**
+ * @brief Per-worker buffer for the parallel processing of the neuron-sections. Each worker sums
+ *        up its synapse-outputs in a dense slot for each target-section, which it touches, and
+ *        the slots of all workers are added lane-wise to the neurons afterwards, so no atomic
+ *        operations are necessary. The slots are handed out in the order of the first touch, so
+ *        only the touched sections have to be cleared and reduced. The buffer is only
+ *        runtime-data and not part of the segment-data or a snapshot.
+ */
+struct WorkerInputBuffer
+{
+    PartialInputs* slots = nullptr;
+
+    // position of the slot of each neuron-section, UNINIT_STATE_32 if it was not touched
+    uint32_t* touchedFlags = nullptr;
+
+    // id of the neuron-section of each used slot
+    uint32_t* touchedSections = nullptr;
+    uint32_t numberOfTouchedSections = 0;
+    uint32_t numberOfNeuronSections = 0;
+
+    // private growth-requests to avoid concurrent writes into the list of the segment
+    GrowthRequests growthRequests;
+
+    WorkerInputBuffer(const uint32_t numberOfNeuronSections)
+    {
+        this->numberOfNeuronSections = numberOfNeuronSections;
+        slots = new PartialInputs[numberOfNeuronSections];
+        touchedFlags = new uint32_t[numberOfNeuronSections];
+        std::fill_n(touchedFlags, numberOfNeuronSections, UNINIT_STATE_32);
+        touchedSections = new uint32_t[numberOfNeuronSections];
+        growthRequests.init(numberOfNeuronSections);
+    }
+
+    ~WorkerInputBuffer()
+    {
+        delete[] slots;
+        delete[] touchedFlags;
+        delete[] touchedSections;
+    }
+
+    /**
+     * @brief get the partial inputs of a neuron-section and register the section as touched
+     *
+     * @param neuronSectionId id of the neuron-section
+     *
+     * @return pointer to the partial inputs of the section
+     */
+    inline float*
+    getSectionInputs(const uint32_t neuronSectionId)
+    {
+        uint32_t slotPos = touchedFlags[neuronSectionId];
+        if(slotPos == UNINIT_STATE_32)
+        {
+            slotPos = numberOfTouchedSections;
+            touchedFlags[neuronSectionId] = slotPos;
+            touchedSections[slotPos] = neuronSectionId;
+            numberOfTouchedSections++;
+            std::fill_n(slots[slotPos].input, NEURON_LANES_PER_NEURONSECTION, 0.0f);
+        }
+
+        return slots[slotPos].input;
+    }
+
+    /**
+     * @brief reset the list of the touched sections after the merge
+     */
+    inline void
+    resetTouchedSections()
+    {
+        for(uint32_t i = 0; i < numberOfTouchedSections; i++) {
+            touchedFlags[touchedSections[i]] = UNINIT_STATE_32;
+        }
+        numberOfTouchedSections = 0;
+    }
+};
+
+#endif // KYOUKOMIND_DYNAMIC_WORKER_INPUT_BUFFER_H
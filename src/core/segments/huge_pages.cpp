@@ -0,0 +1,295 @@
+/**
+ * @file        huge_pages.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "huge_pages.h"
+
+#include <sys/mman.h>
+#include <cstdio>
+
+#include <libKitsunemimiCommon/logger.h>
+
+#define HUGE_PAGE_2MB (2ul * 1024ul * 1024ul)
+#define HUGE_PAGE_1GB (1024ul * 1024ul * 1024ul)
+
+// flags to select the size of the huge pages, which are not defined by all libc-versions
+#ifndef MAP_HUGE_SHIFT
+#define MAP_HUGE_SHIFT 26
+#endif
+#define KYOUKO_MAP_HUGE_2MB (21 << MAP_HUGE_SHIFT)
+#define KYOUKO_MAP_HUGE_1GB (30 << MAP_HUGE_SHIFT)
+
+/**
+ * @brief convert the name of the config-file into a huge-page-type
+ *
+ * @param name name of the type ("none", "transparent" or "hugetlb")
+ *
+ * @return type, NO_HUGE_PAGES if the name is unknown
+ */
+HugePageType
+parseHugePageType(const std::string &name)
+{
+    if(name == "transparent") {
+        return TRANSPARENT_HUGE_PAGES;
+    }
+
+    // the size of the pages of hugetlbfs is chosen by the size of the memory
+    if(name == "hugetlb") {
+        return HUGETLB_1GB_PAGES;
+    }
+
+    return NO_HUGE_PAGES;
+}
+
+/**
+ * @brief convert a huge-page-type into a string for the output
+ *
+ * @param type type to convert
+ *
+ * @return name of the type
+ */
+const std::string
+hugePageTypeToString(const HugePageType type)
+{
+    switch(type)
+    {
+        case TRANSPARENT_HUGE_PAGES:
+            return "transparent";
+        case HUGETLB_2MB_PAGES:
+            return "hugetlb_2mb";
+        case HUGETLB_1GB_PAGES:
+            return "hugetlb_1gb";
+        default:
+            break;
+    }
+
+    return "none";
+}
+
+/**
+ * @brief check if the kernel creates transparent huge pages for memory with MADV_HUGEPAGE
+ *
+ * @return true, if enabled for "always" or "madvise", else false
+ */
+bool
+isTransparentHugePageEnabled()
+{
+    std::ifstream file("/sys/kernel/mm/transparent_hugepage/enabled");
+    std::string setting;
+    std::getline(file, setting);
+
+    return setting.find("[always]") != std::string::npos
+           || setting.find("[madvise]") != std::string::npos;
+}
+
+/**
+ * @brief reserve address-space for a buffer. With hugetlb the memory is taken from the reserved
+ *        huge pages of the host, where the whole size is reserved at once, so a lack of pages is
+ *        detected here and not by a crash at the first access. This also means, that with
+ *        hugetlb the whole size is committed, even if only a small part is used later. If this
+ *        fails, then transparent huge pages and at the end normal pages are used, which are
+ *        only committed at the first access.
+ *
+ * @param size reference to the requested size, which is rounded up to the used page-size
+ * @param type reference to the requested type, which is updated with the type in effect
+ *
+ * @return pointer to the memory, nullptr if even the reservation with normal pages failed
+ */
+void*
+reserveMemory(uint64_t &size,
+              HugePageType &type)
+{
+    void* data = MAP_FAILED;
+
+    // hugetlb with 1 GB pages is only used, if at least one page is filled
+    if(type == HUGETLB_1GB_PAGES
+            && size >= HUGE_PAGE_1GB)
+    {
+        const uint64_t pageSize = ((size + HUGE_PAGE_1GB - 1) / HUGE_PAGE_1GB) * HUGE_PAGE_1GB;
+        data = mmap(nullptr,
+                    pageSize,
+                    PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | KYOUKO_MAP_HUGE_1GB,
+                    -1,
+                    0);
+        if(data != MAP_FAILED)
+        {
+            size = pageSize;
+            return data;
+        }
+    }
+
+    if(type == HUGETLB_1GB_PAGES
+            || type == HUGETLB_2MB_PAGES)
+    {
+        const uint64_t pageSize = ((size + HUGE_PAGE_2MB - 1) / HUGE_PAGE_2MB) * HUGE_PAGE_2MB;
+        data = mmap(nullptr,
+                    pageSize,
+                    PROT_READ | PROT_WRITE,
+                    MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB | KYOUKO_MAP_HUGE_2MB,
+                    -1,
+                    0);
+        if(data != MAP_FAILED)
+        {
+            size = pageSize;
+            type = HUGETLB_2MB_PAGES;
+            return data;
+        }
+
+        LOG_WARNING("not enough huge pages available, fall back to transparent huge pages");
+        type = TRANSPARENT_HUGE_PAGES;
+    }
+
+    data = mmap(nullptr,
+                size,
+                PROT_READ | PROT_WRITE,
+                MAP_PRIVATE | MAP_ANONYMOUS | MAP_NORESERVE,
+                -1,
+                0);
+    if(data == MAP_FAILED)
+    {
+        type = NO_HUGE_PAGES;
+        return nullptr;
+    }
+
+    type = adviseHugePages(data, size, type);
+    return data;
+}
+
+/**
+ * @brief mark a memory-region for transparent huge pages. Only the part of the region, which is
+ *        aligned to the size of the huge pages, can be backed by them.
+ *
+ * @param data pointer to the memory-region
+ * @param size size of the memory-region in bytes
+ * @param requestedType requested type of the huge pages
+ *
+ * @return TRANSPARENT_HUGE_PAGES, if the region was marked successfully, else NO_HUGE_PAGES. The
+ *         kernel can still back the region with normal pages, which is checked by
+ *         getEffectiveHugePageType.
+ */
+HugePageType
+adviseHugePages(void* data,
+                const uint64_t size,
+                const HugePageType requestedType)
+{
+    if(requestedType == NO_HUGE_PAGES
+            || data == nullptr
+            || isTransparentHugePageEnabled() == false)
+    {
+        return NO_HUGE_PAGES;
+    }
+
+    const uint64_t start = (reinterpret_cast<uint64_t>(data) + HUGE_PAGE_2MB - 1)
+                           & ~(HUGE_PAGE_2MB - 1);
+    const uint64_t end = (reinterpret_cast<uint64_t>(data) + size) & ~(HUGE_PAGE_2MB - 1);
+    if(end <= start) {
+        return NO_HUGE_PAGES;
+    }
+
+    if(madvise(reinterpret_cast<void*>(start), end - start, MADV_HUGEPAGE) != 0) {
+        return NO_HUGE_PAGES;
+    }
+
+    return TRANSPARENT_HUGE_PAGES;
+}
+
+/**
+ * @brief read the memory-regions of the process together with the number of bytes, which are
+ *        backed by transparent huge pages
+ *
+ * @param regions reference for the resulting list of regions
+ *
+ * @return false, if /proc/self/smaps can not be read, else true
+ */
+bool
+readHugePageRegions(std::vector<HugePageRegion> &regions)
+{
+    std::ifstream file("/proc/self/smaps");
+    if(file.is_open() == false) {
+        return false;
+    }
+
+    std::string line;
+    while(std::getline(file, line))
+    {
+        // header-line of a new region, like "7f0a1c000000-7f0a1c400000 rw-p 00000000 ..."
+        unsigned long start = 0;
+        unsigned long end = 0;
+        if(sscanf(line.c_str(), "%lx-%lx ", &start, &end) == 2)
+        {
+            HugePageRegion region;
+            region.start = start;
+            region.end = end;
+            regions.push_back(region);
+            continue;
+        }
+
+        unsigned long hugePageKb = 0;
+        if(regions.size() > 0
+                && sscanf(line.c_str(), "AnonHugePages: %lu kB", &hugePageKb) == 1)
+        {
+            regions.back().hugePageBytes = hugePageKb * 1024ul;
+        }
+    }
+
+    return true;
+}
+
+/**
+ * @brief get the type of huge pages, which is actually in effect for a memory-region. Hugetlb
+ *        pages are already committed by the reservation, but for transparent huge pages it
+ *        depends on the kernel, if the region is backed by huge pages or not.
+ *
+ * @param regions memory-regions of the process, read by readHugePageRegions
+ * @param data pointer to the memory-region
+ * @param size size of the memory-region in bytes
+ * @param requestedType type, which was requested for the memory-region
+ *
+ * @return TRANSPARENT_HUGE_PAGES, if at least a part of the region is backed by transparent
+ *         huge pages, NO_HUGE_PAGES if not, else the requested hugetlb-type
+ */
+HugePageType
+getEffectiveHugePageType(const std::vector<HugePageRegion> &regions,
+                         const void* data,
+                         const uint64_t size,
+                         const HugePageType requestedType)
+{
+    if(requestedType != TRANSPARENT_HUGE_PAGES) {
+        return requestedType;
+    }
+
+    // madvise splits the regions at the marked range, so the regions of the buffer only
+    // contain the buffer itself and not the other memory of the heap
+    const uint64_t start = reinterpret_cast<uint64_t>(data);
+    const uint64_t end = start + size;
+    for(const HugePageRegion &region : regions)
+    {
+        if(region.start < end
+                && region.end > start
+                && region.hugePageBytes > 0)
+        {
+            return TRANSPARENT_HUGE_PAGES;
+        }
+    }
+
+    return NO_HUGE_PAGES;
+}
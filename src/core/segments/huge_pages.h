@@ -0,0 +1,57 @@
+/**
+ * @file        huge_pages.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_HUGE_PAGES_H
+#define KYOUKOMIND_HUGE_PAGES_H
+
+#include <common.h>
+
+// The segments are big flat buffers with random access, so with normal 4 KB pages most of the
+// accesses miss the dTLB. These functions back the memory with huge pages, if requested and
+// available, and fall back to smaller pages step by step otherwise.
+
+// memory-region of the process with the number of its bytes, which are actually backed by
+// transparent huge pages, as listed in /proc/self/smaps
+struct HugePageRegion
+{
+    uint64_t start = 0;
+    uint64_t end = 0;
+    uint64_t hugePageBytes = 0;
+};
+
+HugePageType parseHugePageType(const std::string &name);
+const std::string hugePageTypeToString(const HugePageType type);
+bool isTransparentHugePageEnabled();
+
+void* reserveMemory(uint64_t &size,
+                    HugePageType &type);
+HugePageType adviseHugePages(void* data,
+                             const uint64_t size,
+                             const HugePageType requestedType);
+
+bool readHugePageRegions(std::vector<HugePageRegion> &regions);
+HugePageType getEffectiveHugePageType(const std::vector<HugePageRegion> &regions,
+                                      const void* data,
+                                      const uint64_t size,
+                                      const HugePageType requestedType);
+
+#endif // KYOUKOMIND_HUGE_PAGES_H
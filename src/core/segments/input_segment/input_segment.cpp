@@ -64,7 +64,9 @@ InputSegment::initSegment(const std::string &name,
 
     SegmentHeader header = createNewHeader(numberOfInputs, totalBorderSize);
 
-    allocateSegment(header);
+    if(allocateSegment(header) == false) {
+        return false;
+    }
     initSegmentPointer(header);
     connectBorderBuffer();
 
@@ -76,6 +78,18 @@ InputSegment::initSegment(const std::string &name,
     return true;
 }
 
+/**
+ * @brief (re-)create the buffers for the batched processing
+ *
+ * @param batchSize number of samples, which are processed together
+ */
+void
+InputSegment::initBatch(const uint32_t batchSize)
+{
+    AbstractSegment::initBatch(batchSize);
+    batchInputs.assign(segmentHeader->inputs.count * batchSize, 0.0f);
+}
+
 /**
  * @brief InputSegment::reinitPointer
  * @return
@@ -202,13 +216,20 @@ InputSegment::initSegmentPointer(const SegmentHeader &header)
  * @brief allocate memory for the segment
  *
  * @param header header with the size-information
+ *
+ * @return true, if successful, else false
  */
-void
+bool
 InputSegment::allocateSegment(SegmentHeader &header)
 {
     const uint32_t numberOfBlocks = (header.staticDataSize / 4096) + 1;
     header.staticDataSize = numberOfBlocks * 4096;   
-    segmentData.initBuffer(header.staticDataSize);
+    if(segmentData.initBuffer(header.staticDataSize) == false) {
+        return false;
+    }
+    prepareSegmentData();
+
+    return true;
 }
 
 /**
@@ -39,16 +39,20 @@ public:
 
     InputNeuron* inputs = nullptr;
 
+    // inputs of all samples of a batch, which are not part of the segment-data
+    std::vector<float> batchInputs;
+
     bool initSegment(const std::string &name,
                      const Kitsunemimi::Hanami::SegmentMeta &segmentMeta);
     bool reinitPointer(const uint64_t numberOfBytes);
+    void initBatch(const uint32_t batchSize);
 
 private:
     SegmentHeader createNewHeader(const uint32_t numberOfInputs,
                                   const uint64_t borderbufferSize);
     void initSegmentPointer(const SegmentHeader &header);
     bool connectBorderBuffer();
-    void allocateSegment(SegmentHeader &header);
+    bool allocateSegment(SegmentHeader &header);
     bool initSlots(const uint32_t numberOfInputs);
 };
 
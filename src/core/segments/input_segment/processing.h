@@ -27,6 +27,7 @@
 
 #include <kyouko_root.h>
 #include <core/segments/brick.h>
+#include <core/cluster/cluster.h>
 
 #include "objects.h"
 #include "input_segment.h"
@@ -51,4 +52,24 @@ prcessInputSegment(const InputSegment &segment)
     }
 }
 
+/**
+ * @brief forward the inputs of all samples of a batch into the output-buffer
+ *
+ * @param segment input-segment to process
+ */
+inline void
+prcessInputSegmentBatch(InputSegment &segment)
+{
+    const uint32_t batchSize = segment.parentCluster->batchSize;
+    const uint64_t numberOfInputs = segment.segmentHeader->inputs.count;
+    const float* batchInputs = segment.batchInputs.data();
+    float* outputTransfers = segment.batchOutputTransfers.data();
+
+    for(uint64_t pos = 0; pos < numberOfInputs; pos++)
+    {
+        const uint64_t targetPos = segment.inputs[pos].targetBorderId * batchSize;
+        memcpy(&outputTransfers[targetPos], &batchInputs[pos * batchSize], batchSize * sizeof(float));
+    }
+}
+
 #endif // KYOUKOMIND_INPUT_PROCESSING_H
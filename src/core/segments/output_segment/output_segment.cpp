@@ -64,8 +64,11 @@ OutputSegment::initSegment(const std::string &name,
 
     SegmentHeader header = createNewHeader(numberOfOutputs, totalBorderSize);
 
-    allocateSegment(header);
+    if(allocateSegment(header) == false) {
+        return false;
+    }
     initSegmentPointer(header);
+    dynamicSegmentSettings[0] = DynamicSegmentSettings();
     connectBorderBuffer();
 
     initSlots(numberOfOutputs);
@@ -76,6 +79,18 @@ OutputSegment::initSegment(const std::string &name,
     return true;
 }
 
+/**
+ * @brief (re-)create the buffers for the batched processing
+ *
+ * @param batchSize number of samples, which are processed together
+ */
+void
+OutputSegment::initBatch(const uint32_t batchSize)
+{
+    AbstractSegment::initBatch(batchSize);
+    batchOutputs.assign(segmentHeader->outputs.count * batchSize, 0.0f);
+}
+
 /**
  * @brief OutputSegment::reinitPointer
  * @return
@@ -203,13 +218,20 @@ OutputSegment::initSegmentPointer(const SegmentHeader &header)
  * @brief allocate memory for the segment
  *
  * @param header header with the size-information
+ *
+ * @return true, if successful, else false
  */
-void
+bool
 OutputSegment::allocateSegment(SegmentHeader &header)
 {
     const uint32_t numberOfBlocks = (header.staticDataSize / 4096) + 1;
     header.staticDataSize = numberOfBlocks * 4096;
-    segmentData.initBuffer(header.staticDataSize);
+    if(segmentData.initBuffer(header.staticDataSize) == false) {
+        return false;
+    }
+    prepareSegmentData();
+
+    return true;
 }
 
 /**
@@ -42,16 +42,20 @@ public:
 
     OutputNeuron* outputs = nullptr;
 
+    // outputs of all samples of a batch, which are not part of the segment-data
+    std::vector<float> batchOutputs;
+
     bool initSegment(const std::string &name,
                      const Kitsunemimi::Hanami::SegmentMeta &segmentMeta);
     bool reinitPointer(const uint64_t numberOfBytes);
+    void initBatch(const uint32_t batchSize);
 
 private:
     SegmentHeader createNewHeader(const uint32_t numberOfOutputs,
                                   const uint64_t borderbufferSize);
     void initSegmentPointer(const SegmentHeader &header);
     bool connectBorderBuffer();
-    void allocateSegment(SegmentHeader &header);
+    bool allocateSegment(SegmentHeader &header);
     bool initSlots(const uint32_t numberOfInputs);
 };
 
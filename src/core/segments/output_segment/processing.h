@@ -28,6 +28,7 @@
 #include <kyouko_root.h>
 #include <core/segments/brick.h>
 #include <core/cluster/cluster.h>
+#include <core/fast_math.h>
 #include <io/protobuf_messages.h>
 #include "objects.h"
 #include "output_segment.h"
@@ -61,6 +62,37 @@ getHighestOutput(const OutputSegment &segment)
     return hightestPos;
 }
 
+/**
+ * @brief get position of the highest output-position of a single sample of a batch
+ *
+ * @param segment output-segment to check
+ * @param sample id of the sample within the batch
+ *
+ * @return position of the highest output.
+ */
+inline uint32_t
+getHighestOutput(const OutputSegment &segment,
+                 const uint32_t sample)
+{
+    const uint32_t batchSize = segment.parentCluster->batchSize;
+    float hightest = -0.1f;
+    uint32_t hightestPos = 0;
+
+    for(uint32_t outputNeuronId = 0;
+        outputNeuronId < segment.segmentHeader->outputs.count;
+        outputNeuronId++)
+    {
+        const float outputWeight = segment.batchOutputs[outputNeuronId * batchSize + sample];
+        if(outputWeight > hightest)
+        {
+            hightest = outputWeight;
+            hightestPos = outputNeuronId;
+        }
+    }
+
+    return hightestPos;
+}
+
 /**
  * @brief process all neurons within a specific brick and also all synapse-sections,
  *        which are connected to an active neuron
@@ -71,6 +103,7 @@ inline void
 prcessOutputSegment(const OutputSegment &segment)
 {
     OutputNeuron* neuron = nullptr;
+    const bool useFastMath = segment.dynamicSegmentSettings->fastMath != 0;
 
     for(uint64_t outputNeuronId = 0;
         outputNeuronId < segment.segmentHeader->outputs.count;
@@ -78,7 +111,11 @@ prcessOutputSegment(const OutputSegment &segment)
     {
         neuron = &segment.outputs[outputNeuronId];
         neuron->outputWeight = segment.inputTransfers[neuron->targetBorderId];
-        neuron->outputWeight = 1.0f / (1.0f + exp(-1.0f * neuron->outputWeight));
+        if(useFastMath) {
+            neuron->outputWeight = fastSigmoid(neuron->outputWeight);
+        } else {
+            neuron->outputWeight = 1.0f / (1.0f + exp(-1.0f * neuron->outputWeight));
+        }
     }
 
     // send output back if a client-connection is set
@@ -89,5 +126,46 @@ prcessOutputSegment(const OutputSegment &segment)
     }
 }
 
+/**
+ * @brief calculate the outputs of all samples of a batch
+ *
+ * @param segment segment to process
+ */
+inline void
+prcessOutputSegmentBatch(OutputSegment &segment)
+{
+    const uint32_t batchSize = segment.parentCluster->batchSize;
+    const float* inputTransfers = segment.batchInputTransfers.data();
+    float* batchOutputs = segment.batchOutputs.data();
+    const bool useFastMath = segment.dynamicSegmentSettings->fastMath != 0;
+
+    for(uint64_t outputNeuronId = 0;
+        outputNeuronId < segment.segmentHeader->outputs.count;
+        outputNeuronId++)
+    {
+        const OutputNeuron* neuron = &segment.outputs[outputNeuronId];
+        const float* input = &inputTransfers[neuron->targetBorderId * batchSize];
+        float* output = &batchOutputs[outputNeuronId * batchSize];
+        if(useFastMath)
+        {
+            for(uint32_t sample = 0; sample < batchSize; sample++) {
+                output[sample] = fastSigmoid(input[sample]);
+            }
+        }
+        else
+        {
+            for(uint32_t sample = 0; sample < batchSize; sample++) {
+                output[sample] = 1.0f / (1.0f + exp(-1.0f * input[sample]));
+            }
+        }
+    }
+
+    // send output back if a client-connection is set
+    if(segment.parentCluster->msgClient != nullptr
+            && segment.parentCluster->mode == Cluster::NORMAL_MODE)
+    {
+        sendClusterOutputMessage(segment);
+    }
+}
 
 #endif // KYOUKOMIND_OUTPUT_PROCESSING_H
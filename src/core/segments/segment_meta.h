@@ -46,7 +46,7 @@ struct SegmentHeaderEntry
 struct SegmentHeader
 {
     uint8_t objectType = SEGMENT_OBJECT;
-    uint8_t version = 1;
+    uint8_t version = SEGMENT_LAYOUT_VERSION;
     uint8_t segmentType = UNDEFINED_SEGMENT;
     uint8_t padding;
     uint32_t segmentID = UNINIT_STATE_32;
@@ -67,6 +67,7 @@ struct SegmentHeader
     SegmentHeaderEntry neuronSections;
     SegmentHeaderEntry inputs;
     SegmentHeaderEntry outputs;
+    // unused, only kept for the layout of the header
     SegmentHeaderEntry updatePosSections;
 
     SegmentHeaderEntry synapseSections;
@@ -34,11 +34,15 @@
 void
 validateStructSizes()
 {
+    assert(sizeof(SmallSynapseSection) == 256);
     assert(sizeof(SynapseSection) == 512);
+    assert(sizeof(LargeSynapseSection) == 1024);
+    assert(sizeof(SmallCompactSynapseSection) == 256);
+    assert(sizeof(CompactSynapseSection) == 512);
+    assert(sizeof(LargeCompactSynapseSection) == 1024);
     assert(sizeof(SegmentHeader) == 512);
     assert(sizeof(SegmentName) == 256);
     assert(sizeof(Brick) == 4096);
-    assert(sizeof(DynamicNeuron) == 32);
     assert(sizeof(NeuronSection) == 2048);
     assert(sizeof(SegmentSlot) == 64);
     assert(sizeof(SegmentSlotList) == 1024);
@@ -48,6 +52,6 @@ validateStructSizes()
     assert(sizeof(DynamicSegmentSettings) == 256);
     assert(sizeof(Kitsunemimi::Hanami::kuuid) == 40);
     assert(sizeof(Synapse) == 16);
-    assert(sizeof(UpdatePosSection) == 1024);
+    assert(sizeof(CompactSynapse) == 8);
     return;
 }
@@ -46,13 +46,26 @@ sendClusterOutputMessage(const OutputSegment &segment)
     msg.set_islast(false);
     msg.set_processtype(ClusterProcessType::REQUEST_TYPE);
     msg.set_datatype(ClusterDataType::OUTPUT_TYPE);
-    msg.set_numberofvalues(segment.segmentHeader->outputs.count);
+    const uint64_t numberOfOutputs = segment.segmentHeader->outputs.count;
+    const uint32_t batchSize = segment.parentCluster->batchSize;
 
-    for(uint64_t outputNeuronId = 0;
-        outputNeuronId < segment.segmentHeader->outputs.count;
-        outputNeuronId++)
+    if(batchSize > 1)
     {
-        msg.add_values(segment.outputs[outputNeuronId].outputWeight);
+        // the outputs of a batch are send sample by sample
+        msg.set_numberofvalues(numberOfOutputs * batchSize);
+        for(uint32_t sample = 0; sample < batchSize; sample++)
+        {
+            for(uint64_t outputNeuronId = 0; outputNeuronId < numberOfOutputs; outputNeuronId++) {
+                msg.add_values(segment.batchOutputs[outputNeuronId * batchSize + sample]);
+            }
+        }
+    }
+    else
+    {
+        msg.set_numberofvalues(numberOfOutputs);
+        for(uint64_t outputNeuronId = 0; outputNeuronId < numberOfOutputs; outputNeuronId++) {
+            msg.add_values(segment.outputs[outputNeuronId].outputWeight);
+        }
     }
 
     // serialize message
@@ -202,9 +215,45 @@ recvClusterInputMessage(Cluster* cluster,
         it = cluster->inputSegments.find(msg.segmentname());
         if(it != cluster->inputSegments.end())
         {
-            InputNeuron* inputNeurons = it->second->inputs;
-            for(uint64_t i = 0; i < msg.numberofvalues(); i++) {
-                inputNeurons[i].weight = msg.values(i);
+            InputSegment* inputSegment = it->second;
+            const uint64_t numberOfInputs = inputSegment->segmentHeader->inputs.count;
+            if(numberOfInputs == 0)
+            {
+                LOG_WARNING("input-segment '" + msg.segmentname() + "' has no inputs");
+                return false;
+            }
+
+            // the header of the message must not point behind the values, which were really sent
+            const uint64_t numberOfValues = std::min(static_cast<uint64_t>(msg.numberofvalues()),
+                                                     static_cast<uint64_t>(msg.values_size()));
+            const uint64_t batchSize = numberOfValues / numberOfInputs;
+
+            // multiple samples within one message are processed as batch by a frozen cluster
+            if(cluster->isFrozen
+                    && batchSize > 1
+                    && batchSize <= MAX_BATCH_SIZE
+                    && numberOfValues % numberOfInputs == 0)
+            {
+                if(cluster->batchSize != batchSize) {
+                    cluster->initBatch(batchSize);
+                }
+
+                float* batchInputs = inputSegment->batchInputs.data();
+                for(uint64_t sample = 0; sample < batchSize; sample++)
+                {
+                    const uint64_t samplePos = sample * numberOfInputs;
+                    for(uint64_t i = 0; i < numberOfInputs; i++) {
+                        batchInputs[i * batchSize + sample] = msg.values(samplePos + i);
+                    }
+                }
+            }
+            else
+            {
+                cluster->initBatch(1);
+                InputNeuron* inputNeurons = inputSegment->inputs;
+                for(uint64_t i = 0; i < numberOfValues && i < numberOfInputs; i++) {
+                    inputNeurons[i].weight = msg.values(i);
+                }
             }
         }
     }
@@ -215,7 +264,10 @@ recvClusterInputMessage(Cluster* cluster,
         if(it != cluster->outputSegments.end())
         {
             OutputNeuron* outputNeurons = it->second->outputs;
-            for(uint64_t i = 0; i < msg.numberofvalues(); i++) {
+            const uint64_t numberOfValues = std::min(static_cast<uint64_t>(msg.numberofvalues()),
+                                                     static_cast<uint64_t>(msg.values_size()));
+            const uint64_t numberOfOutputs = it->second->segmentHeader->outputs.count;
+            for(uint64_t i = 0; i < numberOfValues && i < numberOfOutputs; i++) {
                 outputNeurons[i].shouldValue = msg.values(i);
             }
         }
@@ -233,6 +285,16 @@ recvClusterInputMessage(Cluster* cluster,
         // start learn
         if(msg.processtype() == ClusterProcessType::LEARN_TYPE)
         {
+            // a frozen cluster can not learn, so the input is only processed as request
+            if(cluster->isFrozen)
+            {
+                LOG_WARNING("cluster is frozen and can not learn. Input is processed as request.");
+                cluster->mode = Cluster::NORMAL_MODE;
+                cluster->startForwardCycle();
+                return true;
+            }
+
+
             cluster->mode = Cluster::LEARN_FORWARD_MODE;
             cluster->startForwardCycle();
         }
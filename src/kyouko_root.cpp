@@ -28,6 +28,9 @@
 #include <core/processing/cpu_processing_unit.h>
 #include <core/processing/segment_queue.h>
 #include <core/processing/processing_unit_handler.h>
+#include <core/processing/worker_pool.h>
+#include <core/processing/numa_topology.h>
+#include <core/segments/huge_pages.h>
 
 #include <core/cluster/cluster_handler.h>
 #include <core/cluster/cluster.h>
@@ -51,9 +54,11 @@ using Kitsunemimi::Hanami::HanamiMessagingClient;
 
 // init static variables
 ClusterHandler* KyoukoRoot::m_clusterHandler = nullptr;
-uint32_t* KyoukoRoot::m_randomValues = nullptr;
 SegmentQueue* KyoukoRoot::m_segmentQueue = nullptr;
 ProcessingUnitHandler* KyoukoRoot::m_processingUnitHandler = nullptr;
+std::vector<WorkerPool*> KyoukoRoot::m_workerPools;
+NumaTopology* KyoukoRoot::m_numaTopology = nullptr;
+HugePageType KyoukoRoot::m_hugePageType = TRANSPARENT_HUGE_PAGES;
 Kitsunemimi::Sakura::SqlDatabase* KyoukoRoot::database = nullptr;
 ClusterTable* KyoukoRoot::clustersTable = nullptr;
 TemplateTable* KyoukoRoot::templateTable = nullptr;
@@ -87,11 +92,16 @@ KyoukoRoot::init(Kitsunemimi::ErrorContainer &error)
 
     validateStructSizes();
 
-    // init predefinde random-values
-    m_randomValues = new uint32_t[NUMBER_OF_RAND_VALUES];
-    srand(time(NULL));
-    for(uint32_t i = 0; i < NUMBER_OF_RAND_VALUES; i++) {
-        m_randomValues[i] = static_cast<uint32_t>(rand());
+    // huge pages for the memory of new segments
+    bool success = false;
+    const std::string hugePages = GET_STRING_CONFIG("CPU", "huge_pages", success);
+    if(success) {
+        m_hugePageType = parseHugePageType(hugePages);
+    }
+    if(m_hugePageType == HUGETLB_1GB_PAGES)
+    {
+        LOG_WARNING("hugetlb commits the whole synapse-arena of a segment at its creation, "
+                    "so the synapse-sections don't grow lazily anymore");
     }
 
     // init db
@@ -100,7 +110,6 @@ KyoukoRoot::init(Kitsunemimi::ErrorContainer &error)
     }
 
     m_clusterHandler = new ClusterHandler();
-    m_segmentQueue = new SegmentQueue();
 
     return true;
 }
@@ -113,14 +122,130 @@ KyoukoRoot::init(Kitsunemimi::ErrorContainer &error)
 bool
 KyoukoRoot::initThreads()
 {
+    bool success = false;
+
+    // without numa-awareness the topology stays a single node with all cpus
+    m_numaTopology = new NumaTopology();
+    const bool numaAware = GET_BOOL_CONFIG("CPU", "numa_aware", success);
+    if(success
+            && numaAware
+            && m_numaTopology->readTopology())
+    {
+        LOG_INFO("use " + std::to_string(m_numaTopology->getNumberOfNodes()) + " numa-nodes");
+    }
+    const uint32_t numberOfNodes = m_numaTopology->getNumberOfNodes();
+
+    // the weight of the clusters can be changed later for each cluster
+    uint32_t clusterWeight = DEFAULT_CLUSTER_WEIGHT;
+    const long configWeight = GET_INT_CONFIG("CPU", "default_cluster_weight", success);
+    if(success
+            && configWeight > 0
+            && configWeight <= MAX_CLUSTER_WEIGHT)
+    {
+        clusterWeight = static_cast<uint32_t>(configWeight);
+    }
+    m_segmentQueue = new SegmentQueue(numberOfNodes, clusterWeight);
+
+    // optional list of cpus to pin the processing-units, else they are pinned to their node
+    std::vector<uint32_t> cpuIds;
+    const std::string cpuList = GET_STRING_CONFIG("CPU", "processing_thread_cpus", success);
+    if(success
+            && NumaTopology::parseCpuList(cpuList, cpuIds) == false)
+    {
+        LOG_WARNING("invalid cpu-list for the processing-threads: '" + cpuList + "'");
+        cpuIds.clear();
+    }
+
+    // The processing-units and the threads to split a single segment share the cpus of their
+    // numa-node. Each node has one worker-pool, whose worker 0 is the unit, which calls
+    // runParallel, so a node needs its units plus one thread less than the pool has workers.
+    // By default half of the cpus of the smallest node are used for splitting a segment and the
+    // rest for the units.
+    std::vector<uint32_t> nodeCpus(numberOfNodes, 0);
+    uint32_t smallestNode = UINT32_MAX;
+    uint32_t numberOfCpus = 0;
+    for(uint32_t node = 0; node < numberOfNodes; node++)
+    {
+        nodeCpus[node] = static_cast<uint32_t>(m_numaTopology->getNode(node).cpuIds.size());
+        smallestNode = std::min(smallestNode, nodeCpus[node]);
+        numberOfCpus += nodeCpus[node];
+    }
+    smallestNode = std::max(smallestNode, 1u);
+
+    uint32_t threadsPerSegment = std::max(smallestNode / 2, 1u);
+    const long configThreadsPerSegment = GET_INT_CONFIG("CPU",
+                                                        "number_of_threads_per_segment",
+                                                        success);
+    if(success
+            && configThreadsPerSegment > 0)
+    {
+        threadsPerSegment = static_cast<uint32_t>(configThreadsPerSegment);
+    }
+
+    uint32_t numberOfUnits = numberOfNodes * (smallestNode - std::min(threadsPerSegment,
+                                                                      smallestNode) + 1);
+    const long configUnits = GET_INT_CONFIG("CPU", "number_of_processing_threads", success);
+    if(success
+            && configUnits > 0)
+    {
+        numberOfUnits = static_cast<uint32_t>(configUnits);
+    }
+    if(numberOfUnits > numberOfCpus)
+    {
+        LOG_WARNING("more processing-threads than available cpus: "
+                    + std::to_string(numberOfUnits) + " > " + std::to_string(numberOfCpus));
+    }
+
+    // the pool of a node only gets the cpus, which are not used by the units of the node
+    std::vector<uint32_t> unitsPerNode(numberOfNodes, 0);
+    for(uint32_t unitPos = 0; unitPos < numberOfUnits; unitPos++)
+    {
+        int coreId = -1;
+        unitsPerNode[ProcessingUnitHandler::getNodeOfUnit(unitPos, cpuIds, coreId)]++;
+    }
+
+    for(uint32_t node = 0; node < numberOfNodes; node++)
+    {
+        uint32_t numberOfWorker = 1;
+        if(nodeCpus[node] > unitsPerNode[node]) {
+            numberOfWorker = std::min(threadsPerSegment, nodeCpus[node] - unitsPerNode[node] + 1);
+        }
+        if(numberOfWorker < threadsPerSegment)
+        {
+            LOG_WARNING("reduce the threads per segment on numa-node " + std::to_string(node)
+                        + " to " + std::to_string(numberOfWorker)
+                        + ", to stay within its cpus");
+        }
+        m_workerPools.push_back(new WorkerPool(numberOfWorker, m_numaTopology, node));
+    }
+
     m_processingUnitHandler = new ProcessingUnitHandler();
-    if(m_processingUnitHandler->initProcessingUnits(1) == false) {
+    if(m_processingUnitHandler->initProcessingUnits(numberOfUnits, cpuIds) == false) {
         return false;
     }
+    LOG_INFO("use " + std::to_string(numberOfUnits) + " processing-threads with up to "
+             + std::to_string(threadsPerSegment) + " threads per segment");
 
     return true;
 }
 
+/**
+ * @brief get the worker-pool of a numa-node
+ *
+ * @param numaNode position of the numa-node of the segment
+ *
+ * @return pointer to the pool, nullptr if no pool exist
+ */
+WorkerPool*
+KyoukoRoot::getWorkerPool(const uint32_t numaNode)
+{
+    if(m_workerPools.size() == 0) {
+        return nullptr;
+    }
+
+    return m_workerPools.at(numaNode % m_workerPools.size());
+}
+
 /**
  * @brief init database
  *
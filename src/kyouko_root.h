@@ -30,6 +30,8 @@
 class ClusterHandler;
 class SegmentQueue;
 class ProcessingUnitHandler;
+class WorkerPool;
+class NumaTopology;
 
 namespace Kitsunemimi {
 class GpuInterface;
@@ -45,10 +47,14 @@ public:
     bool init(Kitsunemimi::ErrorContainer &error);
     bool initThreads();
 
+    static WorkerPool* getWorkerPool(const uint32_t numaNode);
+
     static ClusterHandler* m_clusterHandler;
-    static uint32_t* m_randomValues;
     static SegmentQueue* m_segmentQueue;
     static ProcessingUnitHandler* m_processingUnitHandler;
+    static std::vector<WorkerPool*> m_workerPools;
+    static NumaTopology* m_numaTopology;
+    static HugePageType m_hugePageType;
     static Kitsunemimi::Sakura::SqlDatabase* database;
     static ClusterTable* clustersTable;
     static TemplateTable* templateTable;
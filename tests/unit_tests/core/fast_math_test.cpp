@@ -0,0 +1,105 @@
+/**
+ * @file        fast_math_test.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "fast_math_test.h"
+
+#include <common.h>
+
+#include <core/fast_math.h>
+
+/**
+ * @brief constructor
+ */
+FastMath_Test::FastMath_Test()
+    : Kitsunemimi::CompareTestHelper("FastMath_Test")
+{
+    log2_test();
+    exp2_sigmoid_test();
+    checkFastMath_test();
+}
+
+/**
+ * @brief check the maximum error of fastLog2 against the libm-function over all positive floats,
+ *        including the denormal values, which are sampled with a fixed step through their bits
+ */
+void
+FastMath_Test::log2_test()
+{
+    double log2Error = 0.0;
+    for(uint32_t bits = 1; bits < 0x7f800000; bits += 4099)
+    {
+        float value = 0.0f;
+        memcpy(&value, &bits, sizeof(float));
+        const double expected = std::log2(static_cast<double>(value));
+        double error = std::fabs(static_cast<double>(fastLog2(value)) - expected);
+        if(std::fabs(expected) >= 1.0) {
+            error /= std::fabs(expected);
+        }
+        log2Error = std::max(log2Error, error);
+    }
+
+    TEST_EQUAL(log2Error <= FAST_LOG2_MAX_ERROR, true);
+
+    // special values have to behave like log2
+    TEST_EQUAL(fastLog2(0.0f), -INFINITY);
+    TEST_EQUAL(fastLog2(INFINITY), INFINITY);
+    TEST_EQUAL(std::isnan(fastLog2(-1.0f)), true);
+}
+
+/**
+ * @brief check the maximum errors of fastExp2 and fastSigmoid against the libm-functions over
+ *        their usable input-range
+ */
+void
+FastMath_Test::exp2_sigmoid_test()
+{
+    double exp2Error = 0.0;
+    double sigmoidError = 0.0;
+    for(uint32_t i = 0; i <= 1000000; i++)
+    {
+        const float exp2Input = -126.0f + 254.0f * (static_cast<float>(i) / 1000001.0f);
+        const double expectedExp2 = std::exp2(static_cast<double>(exp2Input));
+        const double exp2Diff = static_cast<double>(fastExp2(exp2Input)) - expectedExp2;
+        exp2Error = std::max(exp2Error, std::fabs(exp2Diff) / expectedExp2);
+
+        const float sigmoidInput = -100.0f + 200.0f * (static_cast<float>(i) / 1000000.0f);
+        const double expectedSigmoid = 1.0 / (1.0 + std::exp(-static_cast<double>(sigmoidInput)));
+        const double sigmoidDiff = static_cast<double>(fastSigmoid(sigmoidInput)) - expectedSigmoid;
+        sigmoidError = std::max(sigmoidError, std::fabs(sigmoidDiff));
+    }
+
+    TEST_EQUAL(exp2Error <= FAST_EXP2_MAX_ERROR, true);
+    TEST_EQUAL(sigmoidError <= FAST_SIGMOID_MAX_ERROR, true);
+
+    // values outside of the range
+    TEST_EQUAL(fastExp2(-127.0f), 0.0f);
+    TEST_EQUAL(fastExp2(128.0f), INFINITY);
+}
+
+/**
+ * @brief the spot-check at runtime has to accept the approximations, which passed the full check
+ */
+void
+FastMath_Test::checkFastMath_test()
+{
+    TEST_EQUAL(checkFastMath(), true);
+}
@@ -0,0 +1,40 @@
+/**
+ * @file        fast_math_test.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_FASTMATH_TEST_H
+#define KYOUKOMIND_FASTMATH_TEST_H
+
+#include <libKitsunemimiCommon/test_helper/compare_test_helper.h>
+
+class FastMath_Test
+        : public Kitsunemimi::CompareTestHelper
+{
+public:
+    FastMath_Test();
+
+private:
+    void log2_test();
+    void exp2_sigmoid_test();
+    void checkFastMath_test();
+};
+
+#endif // KYOUKOMIND_FASTMATH_TEST_H
@@ -0,0 +1,201 @@
+/**
+ * @file        segment_queue_test.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "segment_queue_test.h"
+
+#include <common.h>
+
+#include <core/processing/segment_queue.h>
+#include <core/segments/abstract_segment.h>
+#include <core/cluster/cluster.h>
+
+#define NUMBER_OF_TEST_UNITS 8
+#define NUMBER_OF_LOCAL_TEST_SEGMENTS 32
+#define NUMBER_OF_LOCAL_TEST_CYCLES 200000
+#define NUMBER_OF_WAITING_TEST_SEGMENTS 100000
+#define SEGMENT_QUEUE_TEST_TIMEOUT 60
+
+/**
+ * @brief segment without content, which is only moved through the queue
+ */
+class QueueTestSegment
+        : public AbstractSegment
+{
+public:
+    bool initSegment(const std::string &, const Kitsunemimi::Hanami::SegmentMeta &) {
+        return true;
+    }
+    bool reinitPointer(const uint64_t) {
+        return true;
+    }
+
+private:
+    void initSegmentPointer(const SegmentHeader &) {}
+    bool connectBorderBuffer() {
+        return true;
+    }
+    bool allocateSegment(SegmentHeader &) {
+        return true;
+    }
+};
+
+/**
+ * @brief state, which is shared by the processing-units of the test
+ */
+struct QueueTestState
+{
+    SegmentQueue queue;
+    Cluster localCluster;
+    Cluster waitingCluster;
+
+    std::atomic<uint64_t> localTakes = {0};
+    std::atomic<uint64_t> waitingTakes = {0};
+    std::atomic<uint32_t> finishedUnits = {0};
+    std::atomic<bool> abort = {false};
+};
+
+/**
+ * @brief processing-unit of the test. The segments of the local cluster become ready again in the
+ *        own deque of the unit, but their cluster runs far ahead of the waiting cluster, so each
+ *        of them is given back, as long as the waiting cluster has queued segments, while the
+ *        other units go to sleep and are woken up again.
+ *
+ * @param state shared state of the test
+ */
+static void
+runQueueTestUnit(QueueTestState* state)
+{
+    state->queue.registerWorker();
+
+    while(state->abort.load(std::memory_order_relaxed) == false)
+    {
+        AbstractSegment* segment = state->queue.waitForSegment(0, 1);
+        if(segment == nullptr) {
+            continue;
+        }
+
+        if(segment->parentCluster == &state->localCluster)
+        {
+            state->queue.addProcessingTime(segment, 10 * SCHEDULING_GRANULARITY);
+            const uint64_t take = state->localTakes.fetch_add(1, std::memory_order_relaxed);
+            if(take < NUMBER_OF_LOCAL_TEST_CYCLES) {
+                state->queue.addSegmentListToLocalQueue({segment});
+            }
+        }
+        else
+        {
+            state->queue.addProcessingTime(segment, 1);
+            state->waitingTakes.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    state->queue.unregisterWorker();
+    state->finishedUnits.fetch_add(1, std::memory_order_relaxed);
+}
+
+/**
+ * @brief constructor
+ */
+SegmentQueue_Test::SegmentQueue_Test()
+    : Kitsunemimi::CompareTestHelper("SegmentQueue_Test")
+{
+    giveBack_test();
+}
+
+/**
+ * @brief stress-test of the give-back of local segments to a waiting cluster, while the other
+ *        processing-units are sleeping and waking up
+ */
+void
+SegmentQueue_Test::giveBack_test()
+{
+    // the state is not deleted, if a unit hangs, because it would still use its locks
+    QueueTestState* state = new QueueTestState();
+    state->localCluster.schedulingQueueId = state->queue.registerCluster();
+    state->waitingCluster.schedulingQueueId = state->queue.registerCluster();
+
+    std::vector<QueueTestSegment> localSegments(NUMBER_OF_LOCAL_TEST_SEGMENTS);
+    std::vector<QueueTestSegment> waitingSegments(NUMBER_OF_LOCAL_TEST_SEGMENTS);
+    std::vector<AbstractSegment*> localSegmentList;
+    for(uint32_t i = 0; i < NUMBER_OF_LOCAL_TEST_SEGMENTS; i++)
+    {
+        localSegments[i].parentCluster = &state->localCluster;
+        waitingSegments[i].parentCluster = &state->waitingCluster;
+        localSegmentList.push_back(&localSegments[i]);
+    }
+
+    std::vector<std::thread*> units;
+    for(uint32_t i = 0; i < NUMBER_OF_TEST_UNITS; i++) {
+        units.push_back(new std::thread(&runQueueTestUnit, state));
+    }
+
+    // feed the waiting cluster in small bursts, so it is empty from time to time and the units
+    // have to sleep in between
+    state->queue.addSegmentListToQueue(localSegmentList);
+    for(uint32_t i = 0; i < NUMBER_OF_WAITING_TEST_SEGMENTS; i++)
+    {
+        state->queue.addSegmentToQueue(&waitingSegments[i % NUMBER_OF_LOCAL_TEST_SEGMENTS]);
+        if(i % NUMBER_OF_LOCAL_TEST_SEGMENTS == 0) {
+            std::this_thread::sleep_for(chronoMicroSec(10));
+        }
+    }
+
+    // wait until all segments are processed
+    const uint64_t expectedLocalTakes = NUMBER_OF_LOCAL_TEST_CYCLES
+                                        + NUMBER_OF_LOCAL_TEST_SEGMENTS;
+    const chronoTimePoint deadline = chronoClock::now() + chronoSec(SEGMENT_QUEUE_TEST_TIMEOUT);
+    while(chronoClock::now() < deadline
+          && (state->localTakes.load() < expectedLocalTakes
+              || state->waitingTakes.load() < NUMBER_OF_WAITING_TEST_SEGMENTS))
+    {
+        std::this_thread::sleep_for(chronoMilliSec(1));
+    }
+
+    state->abort = true;
+    const chronoTimePoint stopDeadline = chronoClock::now() + chronoSec(1);
+    while(chronoClock::now() < stopDeadline
+          && state->finishedUnits.load() < NUMBER_OF_TEST_UNITS)
+    {
+        std::this_thread::sleep_for(chronoMilliSec(1));
+    }
+
+    // a unit, which is still running, is locked up within the queue
+    TEST_EQUAL(state->finishedUnits.load(), NUMBER_OF_TEST_UNITS);
+    if(state->finishedUnits.load() < NUMBER_OF_TEST_UNITS)
+    {
+        for(std::thread* unit : units) {
+            unit->detach();
+        }
+        return;
+    }
+
+    for(std::thread* unit : units)
+    {
+        unit->join();
+        delete unit;
+    }
+
+    TEST_EQUAL(state->localTakes.load(), expectedLocalTakes);
+    TEST_EQUAL(state->waitingTakes.load(), NUMBER_OF_WAITING_TEST_SEGMENTS);
+
+    delete state;
+}
@@ -0,0 +1,158 @@
+/**
+ * @file        compact_synapse_test.cpp
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#include "compact_synapse_test.h"
+
+#include <common.h>
+
+#include <core/segments/dynamic_segment/backpropagation.h>
+
+#define NUMBER_OF_TEST_SYNAPSES 8
+#define NUMBER_OF_TEST_EPOCHS 5000
+#define TEST_LEARNING_RATE 0.01f
+#define MAX_TEST_ERROR 0.01f
+
+/**
+ * @brief train the weights of a single synapse-section with a small training-set, where the
+ *        synapse i has to learn the factor between the input and the target of neuron i. The
+ *        deltas of the target-neurons are set like for a linear output-neuron with squared
+ *        error, so the weights are only changed by the backpropagation of the section.
+ *
+ * @param section section to train
+ * @param targetWeights weights, which should be learned
+ *
+ * @return average absolute difference between the learned and the target weights
+ */
+template<typename SECTION>
+static float
+trainTestSection(SECTION* section, const float* targetWeights)
+{
+    const float trainingInputs[4] = {0.25f, 0.5f, 0.75f, 1.0f};
+    NeuronSection neuronSection;
+    uint32_t learnStep = 0;
+    neuronSection.numberOfNeurons = NUMBER_OF_TEST_SYNAPSES;
+
+    for(uint32_t i = 0; i < NUMBER_OF_TEST_SYNAPSES; i++)
+    {
+        section->synapses[i].targetNeuronId = static_cast<uint16_t>(i);
+        setWeight(&section->synapses[i], 0.5f);
+        setBorder(&section->synapses[i], 0.0f);
+    }
+
+    for(uint32_t epoch = 0; epoch < NUMBER_OF_TEST_EPOCHS; epoch++)
+    {
+        for(const float input : trainingInputs)
+        {
+            for(uint32_t i = 0; i < NUMBER_OF_TEST_SYNAPSES; i++)
+            {
+                const float error = (getWeight(&section->synapses[i]) - targetWeights[i]) * input;
+                neuronSection.delta[i] = error * input * TEST_LEARNING_RATE;
+            }
+
+            float sourceDelta = 0.0f;
+            backpropagateSection(section,
+                                 &sourceDelta,
+                                 1000.0f,
+                                 &neuronSection,
+                                 0,
+                                 learnStep,
+                                 nullptr);
+            learnStep++;
+        }
+    }
+
+    float totalError = 0.0f;
+    for(uint32_t i = 0; i < NUMBER_OF_TEST_SYNAPSES; i++) {
+        totalError += std::fabs(getWeight(&section->synapses[i]) - targetWeights[i]);
+    }
+
+    return totalError / static_cast<float>(NUMBER_OF_TEST_SYNAPSES);
+}
+
+/**
+ * @brief constructor
+ */
+CompactSynapse_Test::CompactSynapse_Test()
+    : Kitsunemimi::CompareTestHelper("CompactSynapse_Test")
+{
+    stochasticRounding_test();
+    convergence_test();
+}
+
+/**
+ * @brief the stochastic rounding has to stay between the neighbouring halfs and has to be
+ *        correct on average
+ */
+void
+CompactSynapse_Test::stochasticRounding_test()
+{
+    // 1.0 + a quarter of the distance to the next half
+    const float value = 1.0f + 0.25f / 1024.0f;
+    const float lower = 1.0f;
+    const float upper = 1.0f + 1.0f / 1024.0f;
+
+    uint32_t numberOfInvalid = 0;
+    double sum = 0.0;
+    for(uint32_t i = 0; i < 100000; i++)
+    {
+        const float rounded = halfToFloat(floatToHalfStochastic(value, getRandomValue(0, 0, i)));
+        if(rounded != lower
+                && rounded != upper)
+        {
+            numberOfInvalid++;
+        }
+        sum += static_cast<double>(rounded);
+    }
+
+    TEST_EQUAL(numberOfInvalid, 0);
+    TEST_EQUAL(std::fabs(sum / 100000.0 - static_cast<double>(value)) < 0.00005, true);
+
+    // exact values must not be changed
+    TEST_EQUAL(halfToFloat(floatToHalfStochastic(upper, 0x1fff)), upper);
+    TEST_EQUAL(halfToFloat(floatToHalfStochastic(-upper, 0x1fff)), -upper);
+}
+
+/**
+ * @brief the updates of the training are smaller than the precision of the half-values, when the
+ *        weights come close to the targets, so a compact section would stop learning with
+ *        round-to-nearest. With the stochastic rounding it has to converge like the section with
+ *        full precision.
+ */
+void
+CompactSynapse_Test::convergence_test()
+{
+    float targetWeights[NUMBER_OF_TEST_SYNAPSES];
+    for(uint32_t i = 0; i < NUMBER_OF_TEST_SYNAPSES; i++) {
+        targetWeights[i] = 0.6f + 0.05f * static_cast<float>(i);
+    }
+
+    SynapseSection* section = new SynapseSection();
+    const float error = trainTestSection(section, targetWeights);
+    delete section;
+
+    CompactSynapseSection* compactSection = new CompactSynapseSection();
+    const float compactError = trainTestSection(compactSection, targetWeights);
+    delete compactSection;
+
+    TEST_EQUAL(error < MAX_TEST_ERROR, true);
+    TEST_EQUAL(compactError < MAX_TEST_ERROR, true);
+}
@@ -0,0 +1,39 @@
+/**
+ * @file        compact_synapse_test.h
+ *
+ * @author      Tobias Anker <tobias.anker@kitsunemimi.moe>
+ *
+ * @copyright   Apache License Version 2.0
+ *
+ *      Copyright 2019 Tobias Anker
+ *
+ *      Licensed under the Apache License, Version 2.0 (the "License");
+ *      you may not use this file except in compliance with the License.
+ *      You may obtain a copy of the License at
+ *
+ *          http://www.apache.org/licenses/LICENSE-2.0
+ *
+ *      Unless required by applicable law or agreed to in writing, software
+ *      distributed under the License is distributed on an "AS IS" BASIS,
+ *      WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ *      See the License for the specific language governing permissions and
+ *      limitations under the License.
+ */
+
+#ifndef KYOUKOMIND_COMPACTSYNAPSE_TEST_H
+#define KYOUKOMIND_COMPACTSYNAPSE_TEST_H
+
+#include <libKitsunemimiCommon/test_helper/compare_test_helper.h>
+
+class CompactSynapse_Test
+        : public Kitsunemimi::CompareTestHelper
+{
+public:
+    CompactSynapse_Test();
+
+private:
+    void stochasticRounding_test();
+    void convergence_test();
+};
+
+#endif // KYOUKOMIND_COMPACTSYNAPSE_TEST_H